@@ -261,6 +261,28 @@ def ns_run_instances(config_path, parallel):
       if os.system(cmd) != 0:
         exit()
 
+@timeit
+def ns_run_native(config_path, jobs, dry_run):
+  cwd = os.getcwd()
+  if not os.path.isabs(config_path):
+    config_path = (cwd + "/ns/configs/" + config_path)
+  print("config_path: {}".format(config_path))
+  if not os.path.exists(config_path):
+    print("ERR: not exist!")
+    exit()
+
+  # Single waf launch; batch_runner forks the instances from the built binaries and schedules them longest job first
+  cmd = "./waf --cwd=\""+cwd+"/ns/"+"\" --run \"batch_runner --config_path="+config_path
+  if jobs > 0:
+    cmd += " --jobs="+str(jobs)
+  if dry_run:
+    cmd += " --dry_run=1"
+  cmd += "\""
+
+  os.chdir(cwd+"/ns")
+  waf_cmd_wrapper(cmd)
+  os.chdir(cwd)
+
 @timeit
 def ns_clear():
   cwd = os.getcwd()
@@ -2187,6 +2209,11 @@ if __name__ == '__main__':
   ns_run_instances_prsr.add_argument("-c", "--config_dir", type=str, required=True, help="Absolute or relative path (w.r.t. ns/configs) of the directory containing Json config files")
   ns_run_instances_prsr.add_argument("--parallel", action="store_true", help="Whether to execute with multiprocessing")  
 
+  ns_run_native_prsr = ns_subsubprsr.add_parser("run_native") # Run a config or all configs under a dir with the native batch_runner
+  ns_run_native_prsr.add_argument("-c", "--config", type=str, required=True, help="Absolute or relative path (w.r.t. ns/configs) of Json config file or directory")
+  ns_run_native_prsr.add_argument("-j", "--jobs", type=int, required=False, default=0, help="Number of concurrent instances (default: number of cores)")
+  ns_run_native_prsr.add_argument("--dry_run", action="store_true", help="Only print the longest-job-first schedule")
+
   ns_run_clear_prsr = ns_subsubprsr.add_parser("clear")
 
   ns_run_prerequisite_prsr = ns_subsubprsr.add_parser("prerequisite")
@@ -2219,6 +2246,8 @@ if __name__ == '__main__':
       ns_run_batches(args.config_dir, args.parallel)
     elif args.ns_cmd == "run_instances":
       ns_run_instances(args.config_dir, args.parallel)            
+    elif args.ns_cmd == "run_native":
+      ns_run_native(args.config, args.jobs, args.dry_run)
     elif args.ns_cmd == "clear":
       ns_clear()
     elif args.ns_cmd == "kill":
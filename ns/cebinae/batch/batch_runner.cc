@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <limits.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+// Runs the experiment instances of batch configs (same format as consumed by cebinae.py) from the built binaries
+// directly, without one waf startup/rebuild check per instance. Instances are list-scheduled on a pool of worker
+// processes, longest job first, using the completion times recorded in earlier digests.
+NS_LOG_COMPONENT_DEFINE ("BatchRunner");
+
+// Minimal parser for the flat experiment configs: an object of strings, numbers, booleans and arrays thereof.
+// Scalars are kept as their raw text, which is what gets passed to the instance CommandLine.
+class ConfigParser {
+public:
+  explicit ConfigParser(const std::string& text) : m_text(text) {}
+
+  bool Parse(std::map<std::string, std::vector<std::string>>& config, std::map<std::string, bool>& is_array) {
+    SkipSpace();
+    if (!Consume('{')) {
+      return false;
+    }
+    SkipSpace();
+    if (Consume('}')) {
+      return true;
+    }
+    while (true) {
+      std::string key;
+      SkipSpace();
+      if (!ParseString(key)) {
+        return false;
+      }
+      SkipSpace();
+      if (!Consume(':')) {
+        return false;
+      }
+      SkipSpace();
+      std::vector<std::string> values;
+      if (Consume('[')) {
+        is_array[key] = true;
+        SkipSpace();
+        if (!Consume(']')) {
+          while (true) {
+            std::string value;
+            SkipSpace();
+            if (!ParseScalar(value)) {
+              return false;
+            }
+            values.push_back(value);
+            SkipSpace();
+            if (Consume(']')) {
+              break;
+            }
+            if (!Consume(',')) {
+              return false;
+            }
+          }
+        }
+      } else {
+        is_array[key] = false;
+        std::string value;
+        if (!ParseScalar(value)) {
+          return false;
+        }
+        values.push_back(value);
+      }
+      config[key] = values;
+      SkipSpace();
+      if (Consume('}')) {
+        return true;
+      }
+      if (!Consume(',')) {
+        return false;
+      }
+    }
+  }
+
+private:
+  void SkipSpace() {
+    while (m_pos < m_text.size() && isspace(m_text[m_pos])) {
+      m_pos++;
+    }
+  }
+
+  bool Consume(char c) {
+    if (m_pos < m_text.size() && m_text[m_pos] == c) {
+      m_pos++;
+      return true;
+    }
+    return false;
+  }
+
+  bool ParseString(std::string& out) {
+    if (!Consume('"')) {
+      return false;
+    }
+    while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+      if (m_text[m_pos] == '\\' && m_pos+1 < m_text.size()) {
+        m_pos++;
+      }
+      out += m_text[m_pos++];
+    }
+    return Consume('"');
+  }
+
+  bool ParseScalar(std::string& out) {
+    if (m_pos < m_text.size() && m_text[m_pos] == '"') {
+      return ParseString(out);
+    }
+    while (m_pos < m_text.size() && !isspace(m_text[m_pos]) &&
+           m_text[m_pos] != ',' && m_text[m_pos] != ']' && m_text[m_pos] != '}') {
+      out += m_text[m_pos++];
+    }
+    return !out.empty();
+  }
+
+  const std::string& m_text;
+  size_t m_pos {0};
+};
+
+struct Instance {
+  std::string config_path;
+  std::string instance_type;
+  std::string result_dir;
+  std::vector<std::string> args;
+  double expected_seconds;  // Negative if unknown
+  int status;
+  double elapsed_seconds;
+};
+
+static double
+ReadCompletionTime (std::string digest_path)
+{
+  std::ifstream digest_file (digest_path);
+  std::string line;
+  const std::string key = "Completion time [s]: ";
+  while (getline(digest_file, line)) {
+    size_t pos = line.find(key);
+    if (pos != std::string::npos) {
+      return atof(line.c_str() + pos + key.size());
+    }
+  }
+  return -1;
+}
+
+static bool
+ExpandConfig (std::string config_path, std::string index_dir, std::vector<Instance>& instances)
+{
+  std::ifstream in_file {config_path};
+  if (!in_file) {
+    std::cout << "ERR: can't open " << config_path << std::endl;
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << in_file.rdbuf();
+  std::string text = buffer.str();
+
+  std::map<std::string, std::vector<std::string>> config;
+  std::map<std::string, bool> is_array;
+  if (!ConfigParser(text).Parse(config, is_array) || config.count("instance_type") == 0) {
+    std::cout << "ERR: malformed config " << config_path << std::endl;
+    return false;
+  }
+
+  uint32_t batch_size = config.count("batch_size") ? std::stoul(config["batch_size"][0]) : 1;
+  std::vector<std::string> batch_params;
+  if (config.count("batch_params")) {
+    batch_params = config["batch_params"];
+  }
+  for (auto& param : batch_params) {
+    if (config[param].size() != batch_size) {
+      std::cout << "ERR: " << param << " has " << config[param].size() << " != " << batch_size << " values" << std::endl;
+      return false;
+    }
+  }
+
+  for (uint32_t instance_id = 0; instance_id < batch_size; instance_id++) {
+    Instance instance;
+    instance.config_path = config_path;
+    instance.instance_type = config["instance_type"][0];
+    instance.args.push_back("--config_path="+config_path);
+    for (auto iter = config.begin(); iter != config.end(); iter++) {
+      if (iter->first == "instance_type" || iter->first == "batch_size" || iter->first == "batch_params") {
+        continue;
+      }
+      std::string value = (is_array[iter->first] && std::find(batch_params.begin(), batch_params.end(), iter->first) != batch_params.end()) ?
+                          iter->second[instance_id] : iter->second[0];
+      instance.args.push_back("--"+iter->first+"="+value);
+      if (iter->first == "result_dir") {
+        instance.result_dir = value;
+      }
+    }
+    // Prefer the last local run, fall back to the reference outputs
+    instance.expected_seconds = ReadCompletionTime(instance.result_dir+"/digest");
+    if (instance.expected_seconds < 0 && instance.result_dir.compare(0, 10, "tmp_index/") == 0) {
+      instance.expected_seconds = ReadCompletionTime(index_dir+"/"+instance.result_dir.substr(10)+"/digest");
+    }
+    instance.status = -1;
+    instance.elapsed_seconds = 0;
+    instances.push_back(instance);
+  }
+  return true;
+}
+
+// Built programs sit under build/cebinae/<dir>/ named like this runner, e.g., ns3.35-batch_runner-optimized
+static std::string
+LocateBinary (std::string instance_type)
+{
+  char exe[PATH_MAX];
+  ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe)-1);
+  if (len <= 0) {
+    return "";
+  }
+  std::string self (exe, len);
+  std::string self_dir = self.substr(0, self.rfind('/'));
+  std::string self_name = self.substr(self.rfind('/')+1);
+  std::string target_name = self_name;
+  target_name.replace(target_name.find("batch_runner"), std::string("batch_runner").size(), instance_type);
+
+  std::string programs_dir = self_dir.substr(0, self_dir.rfind('/'));
+  DIR* d = opendir(programs_dir.c_str());
+  if (d == NULL) {
+    return "";
+  }
+  std::string found = "";
+  struct dirent* entry;
+  while ((entry = readdir(d)) != NULL && found.empty()) {
+    std::string candidate = programs_dir+"/"+entry->d_name+"/"+target_name;
+    if (access(candidate.c_str(), X_OK) == 0) {
+      found = candidate;
+    }
+  }
+  closedir(d);
+  return found;
+}
+
+int
+main (int argc, char *argv[])
+{
+  CommandLine cmd (__FILE__);
+
+  std::string config_path = "";
+  std::string index_dir = "index";
+  uint32_t jobs = std::thread::hardware_concurrency();
+  bool dry_run = 0;
+
+  cmd.AddValue ("config_path", "Batch json config file, or directory of them", config_path);
+  cmd.AddValue ("index_dir", "Reference outputs for completion time estimates of tmp_index/* result dirs", index_dir);
+  cmd.AddValue ("jobs", "Number of instances running concurrently", jobs);
+  cmd.AddValue ("dry_run", "Only print the schedule", dry_run);
+  cmd.Parse (argc, argv);
+
+  if (jobs == 0) {
+    jobs = 1;
+  }
+
+  std::vector<std::string> config_paths;
+  struct stat stat_buffer;
+  if (stat(config_path.c_str(), &stat_buffer) == 0 && S_ISDIR(stat_buffer.st_mode)) {
+    DIR* d = opendir(config_path.c_str());
+    struct dirent* entry;
+    while ((entry = readdir(d)) != NULL) {
+      std::string fn = entry->d_name;
+      if (fn.size() > 5 && fn.compare(fn.size()-5, 5, ".json") == 0) {
+        config_paths.push_back(config_path+"/"+fn);
+      }
+    }
+    closedir(d);
+    std::sort(config_paths.begin(), config_paths.end());
+  } else {
+    config_paths.push_back(config_path);
+  }
+
+  std::vector<Instance> instances;
+  for (auto& path : config_paths) {
+    if (!ExpandConfig(path, index_dir, instances)) {
+      return 1;
+    }
+  }
+
+  std::map<std::string, std::string> binaries;
+  for (auto& instance : instances) {
+    if (binaries.count(instance.instance_type) == 0) {
+      binaries[instance.instance_type] = LocateBinary(instance.instance_type);
+      if (binaries[instance.instance_type].empty()) {
+        std::cout << "ERR: no built binary for " << instance.instance_type << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  // Longest job first; unknown completion times first as they may well be the longest
+  std::vector<uint32_t> order;
+  for (uint32_t i = 0; i < instances.size(); i++) {
+    order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&instances] (uint32_t a, uint32_t b) {
+    double ta = instances[a].expected_seconds < 0 ? std::numeric_limits<double>::max() : instances[a].expected_seconds;
+    double tb = instances[b].expected_seconds < 0 ? std::numeric_limits<double>::max() : instances[b].expected_seconds;
+    return ta > tb;
+  });
+
+  std::cout << "=== " << instances.size() << " instances, " << jobs << " jobs ===" << std::endl;
+  for (auto i : order) {
+    std::cout << std::fixed << std::setprecision (1) << std::setw(10) << instances[i].expected_seconds << "s "
+              << instances[i].instance_type << " " << instances[i].result_dir << std::endl;
+  }
+  if (dry_run) {
+    return 0;
+  }
+
+  auto batch_start = std::chrono::high_resolution_clock::now();
+  std::map<pid_t, std::pair<uint32_t, std::chrono::high_resolution_clock::time_point>> running;
+  uint32_t next = 0;
+  while (next < order.size() || !running.empty()) {
+    while (next < order.size() && running.size() < jobs) {
+      Instance& instance = instances[order[next]];
+      std::vector<char*> exec_argv;
+      exec_argv.push_back(const_cast<char*>(binaries[instance.instance_type].c_str()));
+      for (auto& arg : instance.args) {
+        exec_argv.push_back(const_cast<char*>(arg.c_str()));
+      }
+      exec_argv.push_back(NULL);
+
+      std::cout.flush();
+      pid_t pid = fork();
+      if (pid == 0) {
+        execv(exec_argv[0], exec_argv.data());
+        std::cout << "ERR: execv " << exec_argv[0] << " failed" << std::endl;
+        _exit(127);
+      }
+      if (pid < 0) {
+        std::cout << "ERR: fork failed for " << instance.result_dir << std::endl;
+        instance.status = -1;
+      } else {
+        std::cout << "[PID:" << pid << "] Start " << instance.instance_type << " " << instance.result_dir << std::endl;
+        running[pid] = std::make_pair(order[next], std::chrono::high_resolution_clock::now());
+      }
+      next++;
+    }
+
+    int status = 0;
+    pid_t pid = wait(&status);
+    if (pid < 0) {
+      break;
+    }
+    auto got = running.find(pid);
+    if (got == running.end()) {
+      continue;
+    }
+    Instance& instance = instances[got->second.first];
+    std::chrono::duration<double> elapsed_seconds = std::chrono::high_resolution_clock::now() - got->second.second;
+    instance.elapsed_seconds = elapsed_seconds.count();
+    instance.status = WIFEXITED(status) ? WEXITSTATUS(status) : 128+WTERMSIG(status);
+    std::cout << "[PID:" << pid << "] Done " << instance.result_dir << " status " << instance.status
+              << " in " << std::fixed << std::setprecision (1) << instance.elapsed_seconds << "s" << std::endl;
+    running.erase(got);
+  }
+  std::chrono::duration<double> batch_seconds = std::chrono::high_resolution_clock::now() - batch_start;
+
+  uint32_t num_failed = 0;
+  std::cout << "=== Summary ===" << std::endl;
+  for (auto& instance : instances) {
+    if (instance.status != 0) {
+      num_failed++;
+    }
+    std::cout << (instance.status == 0 ? "OK   " : "FAIL ") << std::fixed << std::setprecision (1) << std::setw(10)
+              << instance.elapsed_seconds << "s " << instance.result_dir << std::endl;
+  }
+  std::cout << "=== " << num_failed << " failed, batch time [s]: " << batch_seconds.count() << " ===" << std::endl;
+
+  return num_failed == 0 ? 0 : 1;
+}
@@ -17,6 +17,9 @@
 #include "ns3/traffic-control-module.h"
 
 #include "my-source.h"
+#include "sim-snapshot.h"
+#include "sim-sweep.h"
+#include "sim-fluid.h"
 
 using namespace ns3;
 
@@ -77,6 +80,24 @@ double app_seconds_end = 10;
 std::unordered_map<std::uint32_t, std::uint64_t> mysourceidtag2pktcount;
 std::unordered_map<std::uint32_t, std::uint64_t> mysourceidtag2cummbytecount;
 std::vector<std::uint64_t> mysourceidtag2bytecount;
+// Also fed by the packets the fluid model sends over the bottleneck
+static void
+CountBottleneckBytes (uint32_t sourceid, uint32_t size)
+{
+  std::unordered_map<std::uint32_t, std::uint64_t>::const_iterator got = mysourceidtag2pktcount.find(sourceid);
+  if (got != mysourceidtag2pktcount.end()) {
+    mysourceidtag2pktcount[sourceid] += 1;
+  } else {
+    mysourceidtag2pktcount[sourceid] = 1;
+  }    
+  if (got != mysourceidtag2cummbytecount.end()) {
+    mysourceidtag2cummbytecount[sourceid] += size;
+  } else {
+    mysourceidtag2cummbytecount[sourceid] = size;
+  }
+  mysourceidtag2bytecount[sourceid] += size;
+}
+
 static void
 PhyTxEndCb (Ptr<const Packet> p)
 {
@@ -85,18 +106,7 @@ PhyTxEndCb (Ptr<const Packet> p)
   // p->PrintPacketTags(std::cout);
   // p->PrintByteTags(std::cout);
   if (p->FindFirstMatchingByteTag(tag)) {
-    std::unordered_map<std::uint32_t, std::uint64_t>::const_iterator got = mysourceidtag2pktcount.find(tag.Get());
-    if (got != mysourceidtag2pktcount.end()) {
-      mysourceidtag2pktcount[tag.Get()] += 1;
-    } else {
-      mysourceidtag2pktcount[tag.Get()] = 1;
-    }    
-    if (got != mysourceidtag2cummbytecount.end()) {
-      mysourceidtag2cummbytecount[tag.Get()] += p->GetSize();
-    } else {
-      mysourceidtag2cummbytecount[tag.Get()] = p->GetSize();
-    }
-    mysourceidtag2bytecount[tag.Get()] += p->GetSize();
+    CountBottleneckBytes (tag.Get(), p->GetSize());
     // Destination IP print
     // NS_LOG_DEBUG ("[" << Simulator::Now ().GetNanoSeconds() << "] Bottleneck link: " << tag.Get() << ", size: " << p->GetSize());
   }
@@ -213,6 +223,17 @@ main (int argc, char *argv[])
   uint32_t progress_interval_ms = 1000;
   bool enable_debug = 0;  
   bool skip_run = 0;    
+  double checkpoint_seconds = 0;  // 0: no snapshot
+  uint32_t checkpoint_retries = 1;
+  uint32_t routing_threads = 1;  // 0: GlobalRouteManager
+  bool packet_metadata = false;  // Packet headers in the debug logs, at a cost per packet
+  double sweep_seconds = 0;  // 0: no sweep
+  uint32_t sweep_jobs = 0;  // 0: all variants concurrently
+  std::string sweep_tau = "";
+  std::string sweep_delta_port = "";
+  std::string sweep_delta_flow = "";
+  double fluid_seconds = 0;  // One-way fluid warm-up before the packet-level apps; 0: packet level only
+  uint32_t fluid_step_us = 0;  // 0: derived from the shortest RTT
   bool logtcp = 0;
   bool enable_stdout = 1; 
   uint32_t seed = 1;  // Fixed
@@ -292,6 +313,17 @@ main (int argc, char *argv[])
   cmd.AddValue ("enable_stdout", "Enable verbose rmterminal print", enable_stdout);  
   cmd.AddValue ("printprogress", "Enable verbose rmterminal print", printprogress);
   cmd.AddValue ("skip_run", "Skip running if result_dir/digest exists", skip_run);      
+  cmd.AddValue ("checkpoint_seconds", "Simulated time [s] of the in-memory snapshot to resume failed runs from (0 to disable)", checkpoint_seconds);
+  cmd.AddValue ("checkpoint_retries", "Number of resumptions from the snapshot upon failure", checkpoint_retries);
+  cmd.AddValue ("routing_threads", "Number of threads building the global routes (0 for the GlobalRouteManager)", routing_threads);
+  cmd.AddValue ("packet_metadata", "Enable the packet metadata, to print the packet headers (slower)", packet_metadata);
+  cmd.AddValue ("sweep_seconds", "Simulated time [s] to fork the CebinaeQueueDisc sweep variants at (0 to disable)", sweep_seconds);
+  cmd.AddValue ("sweep_jobs", "Max number of sweep variants running concurrently (0 for all)", sweep_jobs);
+  cmd.AddValue ("sweep_tau", "Comma-separated tau per sweep variant", sweep_tau);
+  cmd.AddValue ("sweep_delta_port", "Comma-separated delta_port per sweep variant", sweep_delta_port);
+  cmd.AddValue ("sweep_delta_flow", "Comma-separated delta_flow per sweep variant", sweep_delta_flow);
+  cmd.AddValue ("fluid_seconds", "Fluid warm-up [s]: the flows run in the fluid model until then and the packet-level apps take over for the rest of the run, with no switch back (0 to disable)", fluid_seconds);
+  cmd.AddValue ("fluid_step_us", "Time step [us] of the fluid model (0 for 1% of the shortest RTT)", fluid_step_us);
   cmd.AddValue ("sim_seconds", "Simulation time [s]", sim_seconds);
   cmd.AddValue ("app_seconds_start", "Application start time [s]", app_seconds_start);  
   cmd.AddValue ("app_seconds_end", "Application stop time [s]", app_seconds_end);
@@ -332,7 +364,7 @@ main (int argc, char *argv[])
   cmd.AddValue ("leaf_delay6", "", leaf_delay6);  
   cmd.AddValue ("leaf_delay7", "", leaf_delay7);              
   cmd.AddValue ("leaf_delay8", "", leaf_delay8);    
-  cmd.AddValue ("app_bw0", "BW of each application", app_bw0);
+  cmd.AddValue ("app_bw0", "BW of each application (0 for infinite demand)", app_bw0);
   cmd.AddValue ("app_bw1", "", app_bw1);  
   cmd.AddValue ("app_bw2", "", app_bw2);  
   cmd.AddValue ("app_bw3", "", app_bw3);  
@@ -364,6 +396,11 @@ main (int argc, char *argv[])
 
   cmd.Parse (argc, argv);
 
+  // The packet metadata is decided once, before the first packet is created
+  if (packet_metadata) {
+    Packet::EnablePrinting ();
+  }
+
   if (enable_debug) {
     LogComponentEnable ("CebinaeQueueDisc", LOG_LEVEL_DEBUG);
     LogComponentEnable ("DumbbellLong", LOG_LEVEL_DEBUG);
@@ -455,6 +492,17 @@ main (int argc, char *argv[])
             << "enable_stdout: " << std::boolalpha << enable_stdout << "\n"      
             << "printprogress: " << std::boolalpha << printprogress << "\n"
             << "skip_run: " << std::boolalpha << skip_run << "\n"            
+            << "checkpoint_seconds: " << checkpoint_seconds << "\n"
+            << "checkpoint_retries: " << checkpoint_retries << "\n"
+            << "routing_threads: " << routing_threads << "\n"
+            << "packet_metadata: " << std::boolalpha << packet_metadata << "\n"
+            << "sweep_seconds: " << sweep_seconds << "\n"
+            << "sweep_jobs: " << sweep_jobs << "\n"
+            << "sweep_tau: " << sweep_tau << "\n"
+            << "sweep_delta_port: " << sweep_delta_port << "\n"
+            << "sweep_delta_flow: " << sweep_delta_flow << "\n"
+            << "fluid_seconds: " << fluid_seconds << "\n"
+            << "fluid_step_us: " << fluid_step_us << "\n"
             << "config_path: " << config_path << "\n"
             << "result_dir: " << result_dir << "\n"
             << "sack: " << sack << "\n"
@@ -664,8 +712,9 @@ main (int argc, char *argv[])
 
   NS_LOG_DEBUG("================== Install TCP transport ==================");
   // 2 MB (large enough) TCP buffers to prevent the applications from bottlenecking the exp
-  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 21));
-  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 21));
+  uint32_t tcp_buf_size = 1 << 21;
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (tcp_buf_size));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (tcp_buf_size));
   // Reset the default MSS ~500
   // IP MTU = IP header (20B-60B) + TCP header (20B-60B) + TCP MSS
   // Ethernet frame = Ethernet header (14B) + IP MTU + FCS (4B)
@@ -871,6 +920,7 @@ main (int argc, char *argv[])
   // 3. Pass the socket into the constructor of our simple application which we then install in the source node
   Ptr<MySource>* sources;
   sources = new Ptr<MySource>[num_leaf];
+  std::vector<Ptr<Socket>> source_sockets;
   for (uint32_t i = 0; i < num_leaf; ++i) {
     uint16_t sinkPort = 8080;
     Address sinkAddress (InetSocketAddress (rightleaf_ifc.GetAddress(i), sinkPort));
@@ -889,8 +939,6 @@ main (int argc, char *argv[])
     if (logtcp) {
       ns3TcpSocket->TraceConnectWithoutContext ("CongestionWindow", MakeBoundCallback (&CwndChange, i));
     }
-    // Always log RTT though (not necessarily write to file)
-    Config::ConnectWithoutContext ("/NodeList/"+std::to_string(2+i)+"/$ns3::TcpL4Protocol/SocketList/0/RTT", MakeBoundCallback (&TraceRtt, i));
 
     Ptr<MySource> app = CreateObject<MySource> ();
     if (i < num_cca0) {
@@ -912,9 +960,13 @@ main (int argc, char *argv[])
     } else if (i < (num_cca0+num_cca1+num_cca2+num_cca3+num_cca4+num_cca5+num_cca6+num_cca7+num_cca8)) {
       app->Setup (ns3TcpSocket, sinkAddress, app_packet_size, DataRate (app_bw8), i, false);      
     }                                    
-    leftleaf.Get (i)->AddApplication (app);
-    app->SetStartTime (Seconds (app_seconds_start));
+    // The apps take over from the fluid warm-up, if any, and keep the flows until the end
+    if (fluid_seconds < app_seconds_end) {
+      leftleaf.Get (i)->AddApplication (app);
+    }
+    app->SetStartTime (Seconds (std::max (app_seconds_start, fluid_seconds)));
     app->SetStopTime (Seconds (app_seconds_end));
+    source_sockets.push_back (ns3TcpSocket);
     // if (i == 0) {
     //   rightleaf_devices.Get(i)->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&RxDrop));
     // }
@@ -922,6 +974,14 @@ main (int argc, char *argv[])
   }
 
   NS_LOG_DEBUG("================== Tracing ==================");
+  // Always log RTT though (not necessarily write to file): the socket of left leaf i (node 2+i), in a single path lookup
+  if (num_leaf > 0) {
+    std::vector<CallbackBase> rtt_cbs;
+    for (uint32_t i = 0; i < num_leaf; ++i) {
+      rtt_cbs.push_back (MakeBoundCallback (&TraceRtt, i));
+    }
+    Config::LookupMatches ("/NodeList/[2-"+std::to_string(1+num_leaf)+"]/$ns3::TcpL4Protocol/SocketList/0").ConnectWithoutContext ("RTT", rtt_cbs);
+  }
   // Tracing PointToPointNetDevice
   router_devices.Get(0)->TraceConnectWithoutContext("PhyTxEnd", MakeCallback (&PhyTxEndCb));
   // The other NetDevice only transmits ACK packets
@@ -943,7 +1003,70 @@ main (int argc, char *argv[])
                       "app_tpt_"+std::to_string(tracing_period_us)+".dat",
                       "jfi_"+std::to_string(tracing_period_us)+".dat");
 
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  SimFluid* fluid = nullptr;
+  if (fluid_seconds > 0) {
+    if (queuedisc_type.compare("FifoQueueDisc") != 0 && queuedisc_type.compare("CebinaeQueueDisc") != 0) {
+      std::cout << "ERR: the fluid model supports FifoQueueDisc and CebinaeQueueDisc only" << std::endl;
+      return 1;
+    }
+    // Outside the configurations validated against the packet-level runs, the warm-up hands off a different state
+    if (queuedisc_type.compare("FifoQueueDisc") == 0) {
+      std::cout << "WARN: the fluid model does not reproduce the FifoQueueDisc throughput gaps between flows, JFI after the warm-up may differ" << std::endl;
+    }
+    std::vector<uint32_t> grp_num_cca {num_cca0, num_cca1, num_cca2, num_cca3, num_cca4, num_cca5, num_cca6, num_cca7, num_cca8};
+    std::vector<std::string> grp_transport_prot {transport_prot0, transport_prot1, transport_prot2, transport_prot3, transport_prot4,
+                                                 transport_prot5, transport_prot6, transport_prot7, transport_prot8};
+    std::vector<std::string> grp_leaf_bw {leaf_bw0, leaf_bw1, leaf_bw2, leaf_bw3, leaf_bw4, leaf_bw5, leaf_bw6, leaf_bw7, leaf_bw8};
+    std::vector<std::string> grp_leaf_delay {leaf_delay0, leaf_delay1, leaf_delay2, leaf_delay3, leaf_delay4,
+                                             leaf_delay5, leaf_delay6, leaf_delay7, leaf_delay8};
+    std::vector<SimFluid::FlowConfig> flows;
+    Time min_rtt = Time::Max ();
+    bool vegas_warned = false;
+    uint32_t grp = 0;
+    uint32_t grp_end = grp_num_cca[0];
+    for (uint32_t i = 0; i < num_leaf; ++i) {
+      while (i >= grp_end) {
+        grp_end += grp_num_cca[++grp];
+      }
+      SimFluid::FlowConfig cfg;
+      if (!SimFluid::ParseCca (grp_transport_prot[grp], cfg.cca)) {
+        std::cout << "ERR: no fluid model for " << grp_transport_prot[grp] << std::endl;
+        return 1;
+      }
+      if (cfg.cca == SimFluid::VEGAS && queuedisc_type.compare("CebinaeQueueDisc") == 0 && !vegas_warned) {
+        vegas_warned = true;
+        std::cout << "WARN: the fluid model underestimates the bottleneck utilization of TcpVegas with CebinaeQueueDisc by 5-15%" << std::endl;
+      }
+      Time leaf_delay (grp_leaf_delay[grp]);
+      // Sender leaf, bottleneck, receiver leaf and back
+      cfg.base_rtt = 2 * (Time (bottleneck_delay) + 2 * leaf_delay);
+      cfg.access_bw = DataRate (grp_leaf_bw[grp]);
+      if (cfg.access_bw.GetBitRate () == 0) {
+        cfg.access_bw = DataRate (bottleneck_bw);
+      }
+      // MySource connects from the first ephemeral port
+      SimFluid::HashFlow (leftleaf_ifc.GetAddress(i), rightleaf_ifc.GetAddress(i), 49153, 8080, cfg.h_5tuple, cfg.h_5tuple2);
+      min_rtt = std::min (min_rtt, cfg.base_rtt);
+      flows.push_back (cfg);
+    }
+    Time step = (fluid_step_us > 0) ? MicroSeconds (fluid_step_us) : std::max (MicroSeconds (10), min_rtt / 100);
+    fluid = new SimFluid (flows, DataRate (bottleneck_bw), qdiscs.Get (0), app_packet_size, tcp_buf_size, step,
+                          [] (uint32_t sourceid, uint32_t wire_bytes, uint32_t payload_bytes) {
+      CountBottleneckBytes (sourceid, wire_bytes);
+      packetsink_mysourceidtag2bytecount[sourceid] += payload_bytes;
+    });
+    fluid->Schedule (Seconds (app_seconds_start), Seconds (std::min (fluid_seconds, std::min (app_seconds_end, sim_seconds))));
+    if (fluid_seconds < std::min (app_seconds_end, sim_seconds)) {
+      // Scheduled ahead of the app start events at the same time
+      Simulator::Schedule (Seconds (std::max (app_seconds_start, fluid_seconds)), &SimFluid::Handoff, fluid, source_sockets);
+    }
+  }
+
+  if (routing_threads > 0) {
+    Ipv4GlobalRoutingHelper::BuildRoutingTables (routing_threads);
+  } else {
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  }
 
   if (printprogress) {
     Simulator::Schedule (MilliSeconds(progress_interval_ms), &PrintProgress, MilliSeconds(progress_interval_ms));
@@ -951,6 +1074,52 @@ main (int argc, char *argv[])
 
   NS_LOG_DEBUG("================== Run ==================");
 
+  if (checkpoint_seconds > 0) {
+    SimSnapshot::Schedule (Seconds (checkpoint_seconds), result_dir, checkpoint_retries);
+  }
+
+  if (sweep_seconds > 0) {
+    // Variants share the whole prefix up to sweep_seconds, hence only the attributes read by CebinaeQueueDisc every round
+    // can be swept; dT and the queue disc type shape the prefix itself and require separate runs
+    std::vector<double> taus = SimSweep::ParseList (sweep_tau);
+    std::vector<double> delta_ports = SimSweep::ParseList (sweep_delta_port);
+    std::vector<double> delta_flows = SimSweep::ParseList (sweep_delta_flow);
+    uint32_t num_variants = std::max (taus.size (), std::max (delta_ports.size (), delta_flows.size ()));
+    if (queuedisc_type.compare("CebinaeQueueDisc") != 0 || num_variants == 0 ||
+        (!taus.empty () && taus.size () != num_variants) ||
+        (!delta_ports.empty () && delta_ports.size () != num_variants) ||
+        (!delta_flows.empty () && delta_flows.size () != num_variants)) {
+      std::cout << "ERR: sweep requires CebinaeQueueDisc and equal-length sweep lists" << std::endl;
+      return 1;
+    }
+    SimSweep::Schedule (Seconds (sweep_seconds), num_variants, sweep_jobs, [&] (uint32_t variant) {
+      result_dir = result_dir + "/sweep-" + std::to_string(variant) + "/";
+      std::string create_sweep_dir_cmd = "mkdir -p " + result_dir;
+      if (system (create_sweep_dir_cmd.c_str ()) == -1) {
+        std::cout << "ERR: " << create_sweep_dir_cmd << " failed, proceed anyway." << std::endl;
+      }
+      Ptr<QueueDisc> q = qdiscs.Get (0);
+      oss << "--- Sweep variant " << variant << " from " << Simulator::Now ().GetSeconds () << "s ---\n";
+      if (!taus.empty ()) {
+        q->SetAttribute ("tau", DoubleValue (taus[variant]));
+        oss << "tau: " << taus[variant] << "\n";
+      }
+      if (!delta_ports.empty ()) {
+        q->SetAttribute ("delta_port", DoubleValue (delta_ports[variant]));
+        oss << "delta_port: " << delta_ports[variant] << "\n";
+      }
+      if (!delta_flows.empty ()) {
+        q->SetAttribute ("delta_flow", DoubleValue (delta_flows[variant]));
+        oss << "delta_flow: " << delta_flows[variant] << "\n";
+      }
+      oss << "------\n";
+      // Averages only cover the diverged part of the run
+      std::fill (avg_tpt_bottleneck.begin (), avg_tpt_bottleneck.end (), 0);
+      std::fill (avg_tpt_app.begin (), avg_tpt_app.end (), 0);
+      app_seconds_start = Simulator::Now ().GetSeconds ();
+    });
+  }
+
   Simulator::Stop (Seconds (sim_seconds));
   auto start = std::chrono::high_resolution_clock::now();
   Simulator::Run ();
@@ -1042,6 +1211,12 @@ main (int argc, char *argv[])
     oss << "Source " << iter->first << ": " << iter->second << "\n";
   }
   
+  if (fluid) {
+    oss << "====== Fluid model ======\n";
+    oss << fluid->DumpDigest();
+    delete fluid;
+  }
+
   if (queuedisc_type.compare("CebinaeQueueDisc") == 0) {
     oss << "====== CebinaeQueueDisc digest ======\n";
     Ptr<QueueDisc> q = qdiscs.Get(0);
@@ -1055,8 +1230,15 @@ main (int argc, char *argv[])
   }
 
   oss << "\n=== Completion time [s]: " << elapsed_seconds.count() << "===\n";
-  std::ofstream summary_ofs (result_dir + "/digest", std::ios::out | std::ios::app);  
+  // Write-then-rename: a digest is either complete or absent, which skip_run and batch_runner rely on
+  std::string digest_tmp = result_dir + "/digest.tmp." + std::to_string(getpid());
+  std::ofstream summary_ofs (digest_tmp, std::ios::out | std::ios::trunc);
   summary_ofs << oss.str();
+  summary_ofs.close();
+  if (!summary_ofs || rename (digest_tmp.c_str (), (result_dir + "/digest").c_str ()) != 0) {
+    std::cout << "ERR: writing " << result_dir << "/digest failed" << std::endl;
+    return 1;
+  }
 
   if (enable_stdout) {
     std::cout << oss.str() << std::endl;
@@ -20,6 +20,7 @@ public:
   virtual ~MySource();
 
   // Default OnOffApp creates socket until app start time, can't access and configure the tracing externally
+  // A positive dataRate paces the sends; a zero one fills the socket whenever it has room (infinite demand)
   void Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, DataRate dataRate, uint32_t appid, bool poisson);
 
   uint32_t GetPacketsSent();
@@ -28,8 +29,10 @@ private:
   virtual void StartApplication (void);
   virtual void StopApplication (void);
 
-  void ScheduleTx (void);
   void SendPacket (void);
+  void ScheduleTx (void);
+  // Socket SendCallback, invoked whenever the tx buffer frees up space
+  void DataSend (Ptr<Socket> socket, uint32_t available);
 
   Ptr<Socket>     m_socket;
   Address         m_peer;
@@ -40,6 +43,8 @@ private:
   uint32_t        m_packetsSent;
 
   uint32_t        m_sourceid;
+  // Zero-filled payload carrying the source id byte tag, shared (COW) by every packet sent
+  Ptr<Packet>     m_payload;
 
   Ptr<ExponentialRandomVariable> m_var;
 };
@@ -51,13 +56,16 @@ MySource::MySource ()
     m_dataRate (0), 
     m_sendEvent (), 
     m_running (false), 
-    m_packetsSent (0)
+    m_packetsSent (0),
+    m_sourceid (0),
+    m_payload (0)
 {
 }
 
 MySource::~MySource()
 {
   m_socket = 0;
+  m_payload = 0;
 }
 
 void
@@ -69,6 +77,14 @@ MySource::Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, DataR
   m_dataRate = dataRate;
   m_sourceid = sourceid;
 
+  // The payload content is never read, so build it (and its tag) once and hand out copies
+  m_payload = Create<Packet> (m_packetSize);
+  MySourceIDTag tag;
+  tag.Set (m_sourceid);
+  // PacketTag can be pulled out at intermediate NetDevice but not the destination sink app
+  // m_payload->AddPacketTag (tag);
+  m_payload->AddByteTag (tag);  // For persistence
+
   m_var = CreateObject<ExponentialRandomVariable> ();
   // No need for poisson as the demand is infinite anyway and the packet gap pattern is determined by the underlying transport
 }
@@ -80,6 +96,8 @@ MySource::StartApplication (void)
   m_packetsSent = 0;
   m_socket->Bind ();
   m_socket->Connect (m_peer);
+  // Backpressure: refill the tx buffer only when the socket reports free space
+  m_socket->SetSendCallback (MakeCallback (&MySource::DataSend, this));
   SendPacket ();
 }
 
@@ -102,20 +120,26 @@ MySource::StopApplication (void)
 void 
 MySource::SendPacket (void)
 {
-  Ptr<Packet> packet = Create<Packet> (m_packetSize);
-
-  MySourceIDTag tag;
-  tag.Set (m_sourceid);
-  // PacketTag can be pulled out at intermediate NetDevice but not the destination sink app
-  // packet->AddPacketTag (tag);
-  packet->AddByteTag (tag);  // For persistence
-
-  m_socket->Send (packet);
+  if (m_dataRate.GetBitRate () > 0)
+    {
+      // Paced: one packet per packet time at m_dataRate, dropped if the tx buffer is full
+      if (m_socket->Send (m_payload->Copy ()) >= 0)
+        {
+          ++m_packetsSent;
+        }
+      ScheduleTx ();
+      return;
+    }
 
-  // Infinite demand
-  // if (++m_packetsSent < m_nPackets)
-  ++m_packetsSent;
-  ScheduleTx ();
+  // Infinite demand: keep the tx buffer full, as BulkSendApplication does
+  while (m_running && m_socket->GetTxAvailable () >= m_packetSize)
+    {
+      if (m_socket->Send (m_payload->Copy ()) < 0)
+        {
+          break;
+        }
+      ++m_packetsSent;
+    }
 }
 
 void 
@@ -128,6 +152,15 @@ MySource::ScheduleTx (void)
     }
 }
 
+void 
+MySource::DataSend (Ptr<Socket> socket, uint32_t available)
+{
+  if (m_dataRate.GetBitRate () == 0)
+    {
+      SendPacket ();
+    }
+}
+
 uint32_t MySource::GetPacketsSent (void) {
   return m_packetsSent;
 }
@@ -0,0 +1,830 @@
+#ifndef SIM_FLUID_H
+#define SIM_FLUID_H
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/traffic-control-module.h"
+
+using namespace ns3;
+
+// Flow-level model of the long-lived flows, to explore the CebinaeQueueDisc parameters without simulating every
+// segment through the TCP stacks and links. Every step, each sender processes the ACKs and losses fed back to it with
+// the window rules of its CCA in ns-3 (NewReno/LinuxReno, Cubic, Vegas; BBR as a btlbw/RTprop pacing model) and
+// releases what its window allows. Only the bottleneck keeps packet granularity: the drop-tail FIFO is modelled here,
+// whereas for CebinaeQueueDisc the arrivals and departures drive its own LBFs, flow bottleneck detector and
+// ReactionFSM (Fluid* interface). A departure clocks out its sender one RTT later, and a drop is detected after the
+// queue ahead of it drains, one RTT later.
+// Handoff() ends the model and seeds the sockets of the packet-level apps with the modelled windows. The switch is
+// one-way: the model is a warm-up and there is no handoff back from the packet level.
+class SimFluid
+{
+public:
+  enum Cca
+  {
+    NEWRENO,
+    CUBIC,
+    VEGAS,
+    BBR
+  };
+
+  struct FlowConfig
+  {
+    Cca cca;
+    Time base_rtt;       // Propagation RTT
+    DataRate access_bw;  // Sender leaf link
+    uint32_t h_5tuple;   // Hash() and Hash(2022) of the flow's packets at the bottleneck queue disc
+    uint32_t h_5tuple2;
+  };
+
+  // Invoked for every packet leaving the bottleneck: sourceid, bytes on the wire, payload bytes
+  typedef std::function<void (uint32_t, uint32_t, uint32_t)> DepartCallback;
+
+  SimFluid (std::vector<FlowConfig> flows, DataRate bottleneck_bw, Ptr<QueueDisc> qdisc,
+            uint32_t segment_size, uint32_t rcvbuf_size, Time step, DepartCallback depart);
+
+  // "ns3::TcpCubic" -> CUBIC; false for the CCAs without a model
+  static bool ParseCca (std::string tid, Cca &cca);
+  // Hash() and Hash(2022) of the TCP packets from src:sport to dst:dport as seen by the queue disc
+  static void HashFlow (Ipv4Address src, Ipv4Address dst, uint16_t sport, uint16_t dport,
+                        uint32_t &h_5tuple, uint32_t &h_5tuple2);
+
+  // Steps the model over [start, stop)
+  void Schedule (Time start, Time stop);
+  // Stops the model and seeds socket i with the window of flow i, before the apps connect
+  void Handoff (std::vector<Ptr<Socket>> sockets);
+
+  std::string DumpDigest ();
+
+private:
+  // IPv4 and TCP (with timestamps) headers as counted by the queue disc, and the PPP header on the wire
+  static const uint32_t c_header_size = 20 + 32;
+  static const uint32_t c_ppp_size = 2;
+
+  enum FeedbackType
+  {
+    ACK,
+    LOSS,     // Detected by duplicate ACKs
+    TIMEOUT   // Too few segments in flight for duplicate ACKs, for all the segments lost under the timer
+  };
+
+  struct Feedback
+  {
+    Time at;
+    uint64_t order;  // FIFO among equal times
+    uint32_t sourceid;
+    Time rtt;
+    FeedbackType type;
+    bool operator> (const Feedback &other) const {
+      return at > other.at || (at == other.at && order > other.order);
+    }
+  };
+
+  struct QueuedPacket
+  {
+    uint32_t sourceid;
+    Time enqueued;
+    Time left;  // End of its transmission, once at the device
+  };
+
+  enum BbrState
+  {
+    STARTUP,
+    DRAIN,
+    PROBE_BW,
+    PROBE_RTT
+  };
+
+  struct Flow
+  {
+    FlowConfig cfg;
+    Time loop;  // From the end of a transmission at the bottleneck to the segment it clocks out reaching the queue disc
+    Time open;  // First segment at the queue disc, after the handshake
+    Time gap;  // Between back-to-back segments from the sender
+    // Segments
+    double cwnd {10};
+    double ssthresh {1e9};
+    uint32_t inflight {0};
+    uint64_t sent {0};
+    uint64_t acked {0};  // ACKed or found lost
+    uint64_t recover {0};  // Losses up to this sequence belong to the current congestion event
+    bool in_recovery {false};
+    uint32_t retx {0};  // Lost segments still to retransmit
+    bool fast_retx {false};  // The first one goes out upon entering the recovery, regardless of the window
+    // Retransmission timer, one at a time as in TcpSocketBase
+    bool rto_pending {false};
+    uint64_t rto_seq {0};  // Sequence of the first segment lost under the timer
+    uint32_t rto_lost {0};  // Segments lost under the timer
+    uint32_t rto_backoff {0};  // Consecutive timeouts
+    double access_credit {0};
+    uint32_t burst {0};
+    // Cubic
+    uint32_t last_max_cwnd {0};
+    double bic_k {0};
+    uint32_t bic_origin {0};
+    Time epoch_start {Time::Min ()};
+    Time delay_min {Time::Min ()};
+    uint32_t cwnd_cnt {0};
+    bool hystart_found {false};
+    uint64_t end_seq {0};
+    Time round_start {0};
+    Time last_ack {0};
+    Time curr_rtt {Time::Min ()};
+    uint32_t sample_cnt {0};
+    // Vegas
+    Time base_rtt {Time::Max ()};
+    Time min_rtt {Time::Max ()};
+    uint32_t cnt_rtt {0};
+    uint64_t beg_snd_nxt {0};
+    // BBR
+    BbrState state {STARTUP};
+    double btlbw {0};  // Segments per second
+    std::deque<double> bw_samples {};
+    Time rtprop {Time::Max ()};
+    Time rtprop_stamp {0};
+    uint64_t next_round {0};
+    Time bbr_round_start {0};
+    uint32_t round_delivered {0};
+    double full_bw {0};
+    uint32_t full_bw_cnt {0};
+    bool full_bw_reached {false};
+    uint32_t cycle_idx {0};
+    Time cycle_stamp {0};
+    Time probe_rtt_done {0};
+    double pace_credit {0};
+    // Digest
+    uint64_t departed {0};
+    uint64_t dropped {0};
+    uint64_t timeouts {0};
+    double rtt_sum_ns {0};
+    uint64_t rtt_cnt {0};
+  };
+
+  void Step ();
+  void Arrive (uint32_t sourceid, Time at);
+  void Drop (uint32_t sourceid, Time at, bool retx);
+  void Serve (Time until);
+  uint32_t Allowance (Flow &f);
+  void Feed (const Feedback &fb);
+  void OnAck (Flow &f, Time now, Time rtt);
+  void OnLoss (Flow &f, bool timeout);
+  void NewRenoIncrease (Flow &f);
+  uint32_t CubicUpdate (Flow &f, Time now);
+  void CubicHystart (Flow &f, Time now, Time rtt);
+  void BbrUpdate (Flow &f, Time now, Time rtt);
+  double BbrPacingGain (const Flow &f) const;
+  uint32_t Window (const Flow &f) const;
+  bool Full (uint32_t queue) const;
+
+  std::vector<Flow> m_flows;
+  DataRate m_bps;
+  Ptr<QueueDisc> m_qdisc;
+  Ptr<CebinaeQueueDisc> m_cebinae;
+  uint32_t m_segment_size;
+  uint32_t m_size;  // Per segment, as counted by the queue disc
+  uint32_t m_rwnd;  // Segments
+  Time m_step;
+  DepartCallback m_depart;
+  Time m_start;
+  Time m_stop;
+  EventId m_event;
+
+  // Buffer limits, resolved once the queue disc is initialized
+  bool m_limits_set {false};
+  bool m_shared {true};
+  QueueSizeUnit m_unit {QueueSizeUnit::PACKETS};
+  uint32_t m_limit[3] {0, 0, 0};  // Internal queue 0, 1, total
+
+  std::deque<QueuedPacket> m_queues[2];
+  // The bottleneck device takes a packet from the queue disc as soon as it holds less than one in transmission and
+  // one queued (switch_netdev_size=1p), i.e., when the transmission of the packet two ahead ends
+  static const uint32_t c_device_size = 2;
+  std::deque<QueuedPacket> m_device;
+  Time m_device_room {0};  // Since when the device has room
+  Time m_tx_end {0};  // End of the last transmission on the bottleneck
+  std::priority_queue<Feedback, std::vector<Feedback>, std::greater<Feedback>> m_feedback;
+  uint64_t m_order {0};
+};
+
+SimFluid::SimFluid (std::vector<FlowConfig> flows, DataRate bottleneck_bw, Ptr<QueueDisc> qdisc,
+                    uint32_t segment_size, uint32_t rcvbuf_size, Time step, DepartCallback depart)
+  : m_bps (bottleneck_bw),
+    m_qdisc (qdisc),
+    m_cebinae (DynamicCast<CebinaeQueueDisc> (qdisc)),
+    m_segment_size (segment_size),
+    m_size (segment_size + c_header_size),
+    m_rwnd (rcvbuf_size / segment_size),
+    m_step (step),
+    m_depart (depart)
+{
+  // A segment and an ACK with the IPv4, TCP and PPP headers
+  uint32_t data_size = m_size + c_ppp_size;
+  uint32_t ack_size = c_header_size + c_ppp_size;
+  for (const FlowConfig &cfg : flows) {
+    Flow f;
+    f.cfg = cfg;
+    // Data over the receiver leaf link, its ACK back over both leaf links and the bottleneck, the next segment over
+    // the sender leaf link
+    f.loop = cfg.base_rtt + 2 * cfg.access_bw.CalculateBytesTxTime (data_size) +
+             2 * cfg.access_bw.CalculateBytesTxTime (ack_size) + m_bps.CalculateBytesTxTime (ack_size);
+    f.gap = cfg.access_bw.CalculateBytesTxTime (data_size);
+    m_flows.push_back (f);
+  }
+}
+
+bool
+SimFluid::ParseCca (std::string tid, Cca &cca)
+{
+  if (tid == "ns3::TcpNewReno" || tid == "ns3::TcpLinuxReno") {
+    cca = NEWRENO;
+  } else if (tid == "ns3::TcpCubic") {
+    cca = CUBIC;
+  } else if (tid == "ns3::TcpVegas") {
+    cca = VEGAS;
+  } else if (tid == "ns3::TcpBbr") {
+    cca = BBR;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void
+SimFluid::HashFlow (Ipv4Address src, Ipv4Address dst, uint16_t sport, uint16_t dport,
+                    uint32_t &h_5tuple, uint32_t &h_5tuple2)
+{
+  TcpHeader tcp_header;
+  tcp_header.SetSourcePort (sport);
+  tcp_header.SetDestinationPort (dport);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (tcp_header);
+  Ipv4Header ipv4_header;
+  ipv4_header.SetSource (src);
+  ipv4_header.SetDestination (dst);
+  ipv4_header.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+  Ptr<QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, Address (), Ipv4L3Protocol::PROT_NUMBER, ipv4_header);
+  h_5tuple = item->Hash ();
+  h_5tuple2 = item->Hash (2022);
+}
+
+void
+SimFluid::Schedule (Time start, Time stop)
+{
+  m_start = start;
+  m_stop = stop;
+  for (Flow &f : m_flows) {
+    f.open = start + f.loop;
+  }
+  if (start < stop) {
+    m_event = Simulator::Schedule (start, &SimFluid::Step, this);
+  }
+}
+
+void
+SimFluid::Handoff (std::vector<Ptr<Socket>> sockets)
+{
+  m_event.Cancel ();
+  m_stop = Simulator::Now ();
+  for (uint32_t i = 0; i < m_flows.size (); i++) {
+    const Flow &f = m_flows[i];
+    sockets[i]->SetAttribute ("InitialCwnd", UintegerValue (std::max (Window (f), 1U)));
+    if (f.cfg.cca != BBR && f.ssthresh < m_rwnd) {
+      sockets[i]->SetAttribute ("InitialSlowStartThreshold",
+                                UintegerValue (std::max (static_cast<uint32_t> (f.ssthresh), 2U) * m_segment_size));
+    }
+  }
+  std::cout << "[PID:" << getpid() << "] Fluid: handoff to the packet level at "
+            << Simulator::Now ().GetSeconds () << "[s]" << std::endl;
+}
+
+std::string
+SimFluid::DumpDigest ()
+{
+  const char *ccas[] = {"NewReno", "Cubic", "Vegas", "Bbr"};
+  std::ostringstream oss;
+  oss << "step: " << m_step << "\n"
+      << "start: " << m_start << "\n"
+      << "stop: " << m_stop << "\n"
+      << "--- sourceid: cca sent departed dropped timeouts cwnd ssthresh avg_rtt ---\n";
+  for (uint32_t i = 0; i < m_flows.size (); i++) {
+    const Flow &f = m_flows[i];
+    oss << i << ": " << ccas[f.cfg.cca] << " " << f.sent << " " << f.departed << " " << f.dropped << " "
+        << f.timeouts << " " << Window (f) << " " << std::min (f.ssthresh, static_cast<double> (m_rwnd)) << " "
+        << (f.rtt_cnt > 0 ? f.rtt_sum_ns / f.rtt_cnt : 0) << "ns\n";
+  }
+  oss << "------\n";
+  return oss.str ();
+}
+
+void
+SimFluid::Step ()
+{
+  Time now = Simulator::Now ();
+
+  if (!m_limits_set) {
+    // Internal queues only exist once the queue disc is initialized
+    m_unit = m_qdisc->GetMaxSize ().GetUnit ();
+    m_limit[2] = m_qdisc->GetMaxSize ().GetValue ();
+    if (m_cebinae) {
+      BooleanValue pool;
+      m_cebinae->GetAttribute ("pool", pool);
+      m_shared = pool.Get ();
+      m_limit[0] = m_cebinae->GetInternalQueue (0)->GetMaxSize ().GetValue ();
+      m_limit[1] = m_cebinae->GetInternalQueue (1)->GetMaxSize ().GetValue ();
+    }
+    m_limits_set = true;
+  }
+
+  // Senders release what their leaf link and (BBR) pacing allow over the step, interleaved across the senders
+  uint32_t max_burst = 0;
+  for (Flow &f : m_flows) {
+    double access = f.cfg.access_bw.GetBitRate () * m_step.GetSeconds () / (8.0 * (m_size + c_ppp_size));
+    f.access_credit = std::min (f.access_credit + access, access + 1);
+    if (f.cfg.cca == BBR) {
+      double pace = BbrPacingGain (f) * f.btlbw * m_step.GetSeconds ();
+      f.pace_credit = std::min (f.pace_credit + pace, pace + 1);
+    }
+    f.burst = (f.open < now + m_step) ? Allowance (f) : 0;
+    max_burst = std::max (max_burst, f.burst);
+  }
+  for (uint32_t r = 0; r < max_burst; r++) {
+    for (uint32_t i = 0; i < m_flows.size (); i++) {
+      if (m_flows[i].burst > r) {
+        Arrive (i, std::max (now, m_flows[i].open) + r * m_flows[i].gap);
+      }
+    }
+  }
+
+  // Within the step, the ACKs and losses are replayed in time order with the bottleneck, since each clocks out the
+  // next segments of its sender: the drop-tail phase effects rely on this ordering
+  Time end = now + m_step;
+  while (!m_feedback.empty () && m_feedback.top ().at < end) {
+    Feedback fb = m_feedback.top ();
+    m_feedback.pop ();
+    Serve (fb.at);
+    Feed (fb);
+    uint32_t burst = Allowance (m_flows[fb.sourceid]);
+    for (uint32_t n = 0; n < burst; n++) {
+      Arrive (fb.sourceid, fb.at + n * m_flows[fb.sourceid].gap);
+    }
+  }
+  Serve (end);
+
+  if (end < m_stop) {
+    m_event = Simulator::Schedule (m_step, &SimFluid::Step, this);
+  }
+}
+
+uint32_t
+SimFluid::Allowance (Flow &f)
+{
+  uint32_t window = Window (f);
+  double credit = (f.cfg.cca == BBR) ? std::min (f.access_credit, f.pace_credit) : f.access_credit;
+  uint32_t n = std::min (window > f.inflight ? window - f.inflight : 0, static_cast<uint32_t> (std::max (credit, 0.0)));
+  if (f.fast_retx) {
+    n = std::max (n, 1U);
+    f.fast_retx = false;
+  }
+  f.access_credit -= n;
+  if (f.cfg.cca == BBR) {
+    f.pace_credit -= n;
+  }
+  return n;
+}
+
+bool
+SimFluid::Full (uint32_t queue) const
+{
+  uint64_t unit_size = (m_unit == QueueSizeUnit::PACKETS) ? 1 : m_size;
+  if (m_shared) {
+    return (m_queues[0].size () + m_queues[1].size () + 1) * unit_size > m_limit[2];
+  }
+  return (m_queues[queue].size () + 1) * unit_size > m_limit[queue];
+}
+
+void
+SimFluid::Arrive (uint32_t sourceid, Time at)
+{
+  Flow &f = m_flows[sourceid];
+  f.sent += 1;
+  f.inflight += 1;
+  // Retransmissions go first
+  bool retx = f.retx > 0;
+  if (retx) {
+    f.retx -= 1;
+  }
+
+  int32_t queue = 0;
+  if (m_cebinae) {
+    queue = m_cebinae->FluidEnqueue (sourceid, m_size, at);
+    if (queue < 0) {
+      Drop (sourceid, at, retx);
+      return;
+    }
+  }
+  if (Full (queue)) {
+    if (m_cebinae) {
+      m_cebinae->FluidDrop (queue);
+    }
+    Drop (sourceid, at, retx);
+    return;
+  }
+  m_queues[queue].push_back ({sourceid, at, Time (0)});
+}
+
+void
+SimFluid::Drop (uint32_t sourceid, Time at, bool retx)
+{
+  Flow &f = m_flows[sourceid];
+  f.dropped += 1;
+
+  Feedback fb;
+  fb.order = m_order++;
+  fb.sourceid = sourceid;
+  if (f.cfg.cca != BBR && (retx || Window (f) < 4)) {
+    // Lost retransmissions, or too few segments for duplicate ACKs, wait for the retransmission timeout
+    // (TcpSocketBase::MinRto, doubled on each consecutive timeout up to MaxRto)
+    f.rto_lost += 1;
+    if (f.rto_pending) {
+      return;
+    }
+    f.rto_pending = true;
+    f.rto_seq = f.sent;
+    fb.at = at + Seconds (std::min (1U << f.rto_backoff, 60U));
+    fb.type = TIMEOUT;
+  } else {
+    // Duplicate ACKs of the segments queued behind
+    double queued_bits = 8.0 * (m_queues[0].size () + m_queues[1].size ()) * (m_size + c_ppp_size);
+    fb.at = std::max (at, m_tx_end) + Seconds (queued_bits / m_bps.GetBitRate ()) + f.loop;
+    fb.type = LOSS;
+  }
+  m_feedback.push (fb);
+}
+
+void
+SimFluid::Serve (Time until)
+{
+  Time tx_time = m_bps.CalculateBytesTxTime (m_size + c_ppp_size);
+  while (true) {
+    if (m_device.size () < c_device_size) {
+      uint32_t queue = m_cebinae ? m_cebinae->GetHighPrioQueue () : 0;
+      if (m_queues[queue].empty ()) {
+        queue = 1 - queue;
+      }
+      if (!m_queues[queue].empty ()) {
+        // Queue disc -> device
+        QueuedPacket packet = m_queues[queue].front ();
+        m_queues[queue].pop_front ();
+        Time dequeued = std::max (m_device_room, packet.enqueued);
+        packet.left = std::max (m_tx_end, dequeued) + tx_time;
+        m_tx_end = packet.left;
+        m_device.push_back (packet);
+        if (m_cebinae) {
+          const Flow &f = m_flows[packet.sourceid];
+          m_cebinae->FluidDequeue (packet.sourceid, f.cfg.h_5tuple, f.cfg.h_5tuple2, m_size);
+        }
+        continue;
+      }
+    }
+    if (m_device.empty () || m_device.front ().left > until) {
+      break;
+    }
+    QueuedPacket packet = m_device.front ();
+    m_device.pop_front ();
+    m_device_room = packet.left;
+
+    Flow &f = m_flows[packet.sourceid];
+    f.departed += 1;
+    m_depart (packet.sourceid, m_size + c_ppp_size, m_segment_size);
+
+    // The ACK clocks out the next segments of the sender
+    Feedback fb;
+    fb.at = packet.left + f.loop;
+    fb.order = m_order++;
+    fb.sourceid = packet.sourceid;
+    fb.rtt = f.loop + (packet.left - packet.enqueued);
+    fb.type = ACK;
+    m_feedback.push (fb);
+  }
+}
+
+void
+SimFluid::Feed (const Feedback &fb)
+{
+  Flow &f = m_flows[fb.sourceid];
+  uint32_t segments = 1;
+  if (fb.type == TIMEOUT) {
+    segments = f.rto_lost;
+    f.rto_lost = 0;
+    f.rto_pending = false;
+  }
+  f.inflight -= segments;
+  f.acked += segments;
+
+  if (fb.type == ACK) {
+    f.rto_backoff = 0;
+    f.rtt_sum_ns += fb.rtt.GetNanoSeconds ();
+    f.rtt_cnt += 1;
+    if (f.cfg.cca == BBR) {
+      // Losses don't drive the BBR model
+      BbrUpdate (f, fb.at, fb.rtt);
+      return;
+    }
+    if (f.in_recovery) {
+      if (f.acked <= f.recover) {
+        // TcpClassicRecovery holds cwnd at ssthresh until the recovery point
+        return;
+      }
+      f.in_recovery = false;
+      if (f.cfg.cca == VEGAS) {
+        // TcpVegas::EnableVegas
+        f.beg_snd_nxt = f.sent;
+        f.cnt_rtt = 0;
+        f.min_rtt = Time::Max ();
+      }
+    }
+    OnAck (f, fb.at, fb.rtt);
+  } else if (f.cfg.cca != BBR) {
+    if (fb.type == LOSS) {
+      f.retx += 1;
+    }
+    // Losses of the segments sent before the current congestion event belong to it
+    uint64_t seq = (fb.type == TIMEOUT) ? f.rto_seq : f.acked;
+    if (f.in_recovery && seq <= f.recover) {
+      return;
+    }
+    if (fb.type == TIMEOUT) {
+      f.timeouts += 1;
+      f.rto_backoff = std::min (f.rto_backoff + 1, 6U);
+    }
+    OnLoss (f, fb.type == TIMEOUT);
+    f.fast_retx = (fb.type == LOSS);
+    f.in_recovery = true;
+    f.recover = f.sent;
+  }
+}
+
+void
+SimFluid::NewRenoIncrease (Flow &f)
+{
+  if (f.cwnd < f.ssthresh) {
+    f.cwnd += 1;
+  } else {
+    f.cwnd += 1 / f.cwnd;
+  }
+}
+
+void
+SimFluid::OnAck (Flow &f, Time now, Time rtt)
+{
+  if (f.cfg.cca == NEWRENO) {
+    NewRenoIncrease (f);
+  } else if (f.cfg.cca == CUBIC) {
+    // TcpCubic::PktsAcked, then TcpCubic::IncreaseWindow
+    if (!(f.epoch_start != Time::Min () && now - f.epoch_start < MilliSeconds (10))) {
+      if (f.delay_min == Time::Min () || f.delay_min > rtt) {
+        f.delay_min = rtt;
+      }
+      if (f.cwnd <= f.ssthresh && f.cwnd >= 16) {
+        CubicHystart (f, now, rtt);
+      }
+    }
+    if (f.cwnd < f.ssthresh) {
+      if (f.acked > f.end_seq) {
+        // TcpCubic::HystartReset
+        f.round_start = now;
+        f.last_ack = now;
+        f.end_seq = f.sent;
+        f.curr_rtt = Time::Min ();
+        f.sample_cnt = 0;
+      }
+      f.cwnd += 1;
+    } else {
+      f.cwnd_cnt += 1;
+      uint32_t cnt = CubicUpdate (f, now);
+      if (f.cwnd_cnt >= cnt) {
+        f.cwnd += 1;
+        f.cwnd_cnt -= cnt;
+      }
+    }
+  } else if (f.cfg.cca == VEGAS) {
+    // TcpVegas::PktsAcked, then TcpVegas::IncreaseWindow with the default alpha 2, beta 4, gamma 1
+    f.base_rtt = std::min (f.base_rtt, rtt);
+    f.min_rtt = std::min (f.min_rtt, rtt);
+    f.cnt_rtt += 1;
+    if (f.acked >= f.beg_snd_nxt) {
+      f.beg_snd_nxt = f.sent;
+      if (f.cnt_rtt <= 2) {
+        NewRenoIncrease (f);
+      } else {
+        uint32_t seg_cwnd = static_cast<uint32_t> (f.cwnd);
+        uint32_t target_cwnd = static_cast<uint32_t> (seg_cwnd * (f.base_rtt.GetSeconds () / f.min_rtt.GetSeconds ()));
+        uint32_t diff = seg_cwnd - target_cwnd;
+        if (diff > 1 && f.cwnd < f.ssthresh) {
+          f.cwnd = std::min (seg_cwnd, target_cwnd + 1);
+          f.ssthresh = std::max (std::min (f.ssthresh, f.cwnd - 1), 2.0);
+        } else if (f.cwnd < f.ssthresh) {
+          f.cwnd += 1;
+        } else if (diff > 4) {
+          f.cwnd = seg_cwnd - 1;
+          f.ssthresh = std::max (std::min (f.ssthresh, f.cwnd - 1), 2.0);
+        } else if (diff < 2) {
+          f.cwnd = seg_cwnd + 1;
+        }
+        f.ssthresh = std::max (f.ssthresh, std::floor (3 * f.cwnd / 4));
+      }
+      f.cnt_rtt = 0;
+      f.min_rtt = Time::Max ();
+    } else if (f.cwnd < f.ssthresh) {
+      f.cwnd += 1;
+    }
+  }
+}
+
+void
+SimFluid::OnLoss (Flow &f, bool timeout)
+{
+  if (f.cfg.cca == NEWRENO) {
+    // TcpNewReno::GetSsThresh halves the bytes in flight
+    f.ssthresh = std::max (2.0, std::floor ((f.inflight + 1) / 2.0));
+  } else if (f.cfg.cca == CUBIC) {
+    // TcpCubic::GetSsThresh with fast convergence and beta 0.7
+    uint32_t seg_cwnd = static_cast<uint32_t> (f.cwnd);
+    if (seg_cwnd < f.last_max_cwnd) {
+      f.last_max_cwnd = seg_cwnd * (1 + 0.7) / 2;
+    } else {
+      f.last_max_cwnd = seg_cwnd;
+    }
+    f.epoch_start = Time::Min ();
+    f.ssthresh = std::max (static_cast<uint32_t> (seg_cwnd * 0.7), 2U);
+    if (timeout) {
+      f.hystart_found = false;
+    }
+  } else if (f.cfg.cca == VEGAS) {
+    f.ssthresh = std::max (std::min (f.ssthresh, std::floor (f.cwnd) - 1), 2.0);
+  }
+  f.cwnd = timeout ? 1 : f.ssthresh;
+}
+
+uint32_t
+SimFluid::CubicUpdate (Flow &f, Time now)
+{
+  // TcpCubic::Update with C 0.4 and CntClamp 20
+  uint32_t seg_cwnd = static_cast<uint32_t> (f.cwnd);
+  if (f.epoch_start == Time::Min ()) {
+    f.epoch_start = now;
+    if (f.last_max_cwnd <= seg_cwnd) {
+      f.bic_k = 0.0;
+      f.bic_origin = seg_cwnd;
+    } else {
+      f.bic_k = std::pow ((f.last_max_cwnd - seg_cwnd) / 0.4, 1 / 3.);
+      f.bic_origin = f.last_max_cwnd;
+    }
+  }
+  double t = (now + f.delay_min - f.epoch_start).GetSeconds ();
+  double offs = (t < f.bic_k) ? f.bic_k - t : t - f.bic_k;
+  uint32_t delta = 0.4 * std::pow (offs, 3);
+  uint32_t bic_target = 0;
+  if (t < f.bic_k) {
+    bic_target = (f.bic_origin > delta) ? f.bic_origin - delta : 0;
+  } else {
+    bic_target = f.bic_origin + delta;
+  }
+  uint32_t cnt = (bic_target > seg_cwnd) ? seg_cwnd / (bic_target - seg_cwnd) : 100 * seg_cwnd;
+  if (f.last_max_cwnd == 0 && cnt > 20) {
+    cnt = 20;
+  }
+  return std::max (cnt, 2U);
+}
+
+void
+SimFluid::CubicHystart (Flow &f, Time now, Time rtt)
+{
+  // TcpCubic::HystartUpdate with both the ACK train and the delay detection
+  if (f.hystart_found) {
+    return;
+  }
+  if (now - f.last_ack <= MilliSeconds (2)) {
+    f.last_ack = now;
+    if (now - f.round_start > f.delay_min) {
+      f.hystart_found = true;
+    }
+  }
+  if (f.sample_cnt < 8) {
+    if (f.curr_rtt == Time::Min () || f.curr_rtt > rtt) {
+      f.curr_rtt = rtt;
+    }
+    f.sample_cnt += 1;
+  } else if (f.curr_rtt > f.delay_min + std::min (std::max (f.delay_min, MilliSeconds (4)), MilliSeconds (1000))) {
+    f.hystart_found = true;
+  }
+  if (f.hystart_found) {
+    f.ssthresh = f.cwnd;
+  }
+}
+
+void
+SimFluid::BbrUpdate (Flow &f, Time now, Time rtt)
+{
+  // BBRv1 as in TcpBbr: windowed max of the per-round delivery rate over 10 rounds, RTprop over 10s,
+  // high gain 2.89, 8-phase gain cycle, ProbeRTT for 200ms
+  if (f.btlbw == 0) {
+    f.btlbw = 10 / f.loop.GetSeconds ();
+    f.bbr_round_start = now;
+    f.rtprop_stamp = now;
+  }
+  bool rtprop_expired = now - f.rtprop_stamp > Seconds (10);
+  if (rtt <= f.rtprop || rtprop_expired) {
+    f.rtprop = rtt;
+    f.rtprop_stamp = now;
+  }
+
+  f.round_delivered += 1;
+  if (f.acked >= f.next_round) {
+    Time duration = now - f.bbr_round_start;
+    if (duration.IsStrictlyPositive () && f.next_round > 0) {
+      f.bw_samples.push_back (f.round_delivered / duration.GetSeconds ());
+      if (f.bw_samples.size () > 10) {
+        f.bw_samples.pop_front ();
+      }
+      f.btlbw = *std::max_element (f.bw_samples.begin (), f.bw_samples.end ());
+      if (!f.full_bw_reached) {
+        if (f.btlbw >= f.full_bw * 1.25) {
+          f.full_bw = f.btlbw;
+          f.full_bw_cnt = 0;
+        } else if (++f.full_bw_cnt >= 3) {
+          f.full_bw_reached = true;
+        }
+      }
+    }
+    f.next_round = f.sent;
+    f.bbr_round_start = now;
+    f.round_delivered = 0;
+  }
+
+  double bdp = f.btlbw * f.rtprop.GetSeconds ();
+  if (f.state == STARTUP && f.full_bw_reached) {
+    f.state = DRAIN;
+  }
+  if (f.state == DRAIN && f.inflight <= bdp) {
+    f.state = PROBE_BW;
+    f.cycle_idx = 2 + f.cfg.h_5tuple % 6;
+    f.cycle_stamp = now;
+  }
+  if (f.state == PROBE_BW && now - f.cycle_stamp > f.rtprop) {
+    f.cycle_idx = (f.cycle_idx + 1) % 8;
+    f.cycle_stamp = now;
+  }
+  if (f.state != PROBE_RTT && rtprop_expired) {
+    f.state = PROBE_RTT;
+    f.probe_rtt_done = now + MilliSeconds (200) + f.rtprop;
+  }
+  if (f.state == PROBE_RTT && now > f.probe_rtt_done) {
+    f.rtprop_stamp = now;
+    f.state = f.full_bw_reached ? PROBE_BW : STARTUP;
+    f.cycle_stamp = now;
+  }
+}
+
+double
+SimFluid::BbrPacingGain (const Flow &f) const
+{
+  const double cycle[] = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+  switch (f.state) {
+    case STARTUP:
+      return 2.89;
+    case DRAIN:
+      return 1 / 2.89;
+    case PROBE_BW:
+      return cycle[f.cycle_idx];
+    default:
+      return 1;
+  }
+}
+
+uint32_t
+SimFluid::Window (const Flow &f) const
+{
+  double cwnd = f.cwnd;
+  if (f.cfg.cca == BBR) {
+    if (f.state == PROBE_RTT) {
+      cwnd = 4;
+    } else if (f.btlbw == 0) {
+      cwnd = 10;
+    } else {
+      double gain = (f.state == PROBE_BW) ? 2 : 2.89;
+      cwnd = std::max (gain * f.btlbw * f.rtprop.GetSeconds () + 3, 4.0);
+    }
+  }
+  return std::min (static_cast<uint32_t> (cwnd), m_rwnd);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef SIM_SNAPSHOT_H
+#define SIM_SNAPSHOT_H
+
+#include <dirent.h>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+// In-memory checkpoint of a running experiment at a chosen simulated time.
+//
+// ns-3 state (event queue with bound closures, TCP sockets, queue discs incl. CebinaeQueueDisc FSM/detector,
+// app counters and the program's own globals) is a graph of raw pointers and cannot be serialized faithfully.
+// Instead, at the snapshot time the process forks: the parent becomes the frozen snapshot (copy-on-write, so
+// cheap) and the child carries on with the run. If the child fails (non-zero exit, crash, killed), the parent
+// rolls result_dir back to its content at the snapshot time and resumes from there instead of from t=0.
+// The snapshot lives as long as the run, i.e., it does not survive the machine/process tree going away.
+class SimSnapshot
+{
+public:
+  // Snapshot at simulated time 'at'; retry the remaining run from the snapshot up to 'retries' times
+  static void Schedule (Time at, std::string dir, uint32_t retries);
+
+private:
+  static void Take (std::string dir, uint32_t retries);
+  // Regular files under dir and their sizes
+  static std::map<std::string, off_t> ListFiles (std::string dir);
+  static void Rollback (std::string dir, const std::map<std::string, off_t>& files);
+};
+
+void
+SimSnapshot::Schedule (Time at, std::string dir, uint32_t retries)
+{
+  Simulator::Schedule (at, &SimSnapshot::Take, dir, retries);
+}
+
+void
+SimSnapshot::Take (std::string dir, uint32_t retries)
+{
+  std::map<std::string, off_t> files = ListFiles (dir);
+  for (uint32_t attempt = 0; attempt < retries; attempt++) {
+    // Otherwise the buffered output is emitted twice
+    std::cout.flush ();
+    std::cerr.flush ();
+    pid_t pid = fork ();
+    if (pid < 0) {
+      std::cout << "ERR: snapshot fork failed, proceed without snapshot." << std::endl;
+      return;
+    }
+    if (pid == 0) {
+      // Child: run on as usual
+      return;
+    }
+    int status = 0;
+    if (waitpid (pid, &status, 0) == pid && WIFEXITED (status) && WEXITSTATUS (status) == 0) {
+      // The run completed from this snapshot, nothing left for the snapshot holder
+      _exit (0);
+    }
+    std::cout << "[PID:" << getpid() << "] Run from snapshot at " << Simulator::Now ().GetSeconds ()
+              << "[s] failed (status " << status << "), resuming from snapshot" << std::endl;
+    Rollback (dir, files);
+  }
+  // Out of retries (or none configured): the snapshot holder runs the last attempt itself
+}
+
+std::map<std::string, off_t>
+SimSnapshot::ListFiles (std::string dir)
+{
+  std::map<std::string, off_t> files;
+  DIR* d = opendir (dir.c_str ());
+  if (d == NULL) {
+    return files;
+  }
+  struct dirent* entry;
+  while ((entry = readdir (d)) != NULL) {
+    std::string path = dir + "/" + entry->d_name;
+    struct stat st;
+    if (stat (path.c_str (), &st) == 0 && S_ISREG (st.st_mode)) {
+      files[path] = st.st_size;
+    }
+  }
+  closedir (d);
+  return files;
+}
+
+void
+SimSnapshot::Rollback (std::string dir, const std::map<std::string, off_t>& files)
+{
+  std::map<std::string, off_t> current = ListFiles (dir);
+  for (auto iter = current.begin (); iter != current.end (); iter++) {
+    auto got = files.find (iter->first);
+    if (got == files.end ()) {
+      unlink (iter->first.c_str ());
+    } else if (truncate (iter->first.c_str (), got->second) != 0) {
+      std::cout << "ERR: rollback of " << iter->first << " failed, proceed anyway." << std::endl;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SIM_SWEEP_H
+#define SIM_SWEEP_H
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+// Warm-start parameter sweep: simulate the prefix shared by all variants once, then fork one copy-on-write
+// child per variant at the divergence point. Each child applies its own parameters and runs to completion;
+// the parent only waits for them (at most 'jobs' concurrently) and exits with the aggregated status.
+class SimSweep
+{
+public:
+  // 'apply' is invoked in the child of variant i (0-based) right after the fork
+  static void Schedule (Time at, uint32_t num_variants, uint32_t jobs, std::function<void (uint32_t)> apply);
+
+  // "0.05,0.1" -> {0.05, 0.1}; empty string -> {}
+  static std::vector<double> ParseList (std::string list);
+
+private:
+  static void Fork (uint32_t num_variants, uint32_t jobs, std::function<void (uint32_t)> apply);
+  static bool WaitOne ();
+};
+
+void
+SimSweep::Schedule (Time at, uint32_t num_variants, uint32_t jobs, std::function<void (uint32_t)> apply)
+{
+  Simulator::Schedule (at, &SimSweep::Fork, num_variants, jobs, apply);
+}
+
+std::vector<double>
+SimSweep::ParseList (std::string list)
+{
+  std::vector<double> values;
+  std::istringstream iss (list);
+  std::string value;
+  while (std::getline (iss, value, ',')) {
+    if (!value.empty ()) {
+      values.push_back (std::stod (value));
+    }
+  }
+  return values;
+}
+
+void
+SimSweep::Fork (uint32_t num_variants, uint32_t jobs, std::function<void (uint32_t)> apply)
+{
+  if (jobs == 0) {
+    jobs = num_variants;
+  }
+  std::cout << "[PID:" << getpid() << "] Sweep: forking " << num_variants << " variants at "
+            << Simulator::Now ().GetSeconds () << "[s]" << std::endl;
+
+  bool ok = true;
+  uint32_t running = 0;
+  for (uint32_t i = 0; i < num_variants; i++) {
+    if (running == jobs) {
+      ok = WaitOne () && ok;
+      running -= 1;
+    }
+    // Otherwise the buffered output is emitted once per child
+    std::cout.flush ();
+    std::cerr.flush ();
+    pid_t pid = fork ();
+    if (pid < 0) {
+      std::cout << "ERR: sweep fork of variant " << i << " failed." << std::endl;
+      ok = false;
+      continue;
+    }
+    if (pid == 0) {
+      apply (i);
+      return;
+    }
+    running += 1;
+  }
+  while (running > 0) {
+    ok = WaitOne () && ok;
+    running -= 1;
+  }
+  // All variants ran in the children, the shared prefix has nothing left to simulate
+  _exit (ok ? 0 : 1);
+}
+
+bool
+SimSweep::WaitOne ()
+{
+  int status = 0;
+  if (wait (&status) < 0) {
+    return false;
+  }
+  return WIFEXITED (status) && WEXITSTATUS (status) == 0;
+}
+
+#endif
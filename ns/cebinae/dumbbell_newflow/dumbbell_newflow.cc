@@ -17,6 +17,7 @@
 #include "ns3/traffic-control-module.h"
 
 #include "../dumbbell_long/my-source.h"
+#include "../dumbbell_long/sim-snapshot.h"
 
 using namespace ns3;
 
@@ -221,6 +222,10 @@ main (int argc, char *argv[])
   uint32_t progress_interval_ms = 1000;
   bool enable_debug = 0;  
   bool skip_run = 0;    
+  double checkpoint_seconds = 0;  // 0: no snapshot
+  uint32_t checkpoint_retries = 1;
+  uint32_t routing_threads = 1;  // 0: GlobalRouteManager
+  bool packet_metadata = false;  // Packet headers in the debug logs, at a cost per packet
   bool logtcp = 0;
   bool enable_stdout = 1; 
   uint32_t seed = 1;  // Fixed
@@ -300,6 +305,10 @@ main (int argc, char *argv[])
   cmd.AddValue ("enable_stdout", "Enable verbose rmterminal print", enable_stdout);  
   cmd.AddValue ("printprogress", "Enable verbose rmterminal print", printprogress);
   cmd.AddValue ("skip_run", "Skip running if result_dir/digest exists", skip_run);      
+  cmd.AddValue ("checkpoint_seconds", "Simulated time [s] of the in-memory snapshot to resume failed runs from (0 to disable)", checkpoint_seconds);
+  cmd.AddValue ("checkpoint_retries", "Number of resumptions from the snapshot upon failure", checkpoint_retries);
+  cmd.AddValue ("routing_threads", "Number of threads building the global routes (0 for the GlobalRouteManager)", routing_threads);
+  cmd.AddValue ("packet_metadata", "Enable the packet metadata, to print the packet headers (slower)", packet_metadata);
   cmd.AddValue ("sim_seconds", "Simulation time [s]", sim_seconds);
   cmd.AddValue ("app_seconds_start0", "Application start time [s]", app_seconds_start0); 
   cmd.AddValue ("app_seconds_start1", "Application start time [s]", app_seconds_start1); 
@@ -348,7 +357,7 @@ main (int argc, char *argv[])
   cmd.AddValue ("leaf_delay6", "", leaf_delay6);  
   cmd.AddValue ("leaf_delay7", "", leaf_delay7);              
   cmd.AddValue ("leaf_delay8", "", leaf_delay8);    
-  cmd.AddValue ("app_bw0", "BW of each application", app_bw0);
+  cmd.AddValue ("app_bw0", "BW of each application (0 for infinite demand)", app_bw0);
   cmd.AddValue ("app_bw1", "", app_bw1);  
   cmd.AddValue ("app_bw2", "", app_bw2);  
   cmd.AddValue ("app_bw3", "", app_bw3);  
@@ -380,6 +389,11 @@ main (int argc, char *argv[])
 
   cmd.Parse (argc, argv);
 
+  // The packet metadata is decided once, before the first packet is created
+  if (packet_metadata) {
+    Packet::EnablePrinting ();
+  }
+
   if (enable_debug) {
     LogComponentEnable ("CebinaeQueueDisc", LOG_LEVEL_DEBUG);
     LogComponentEnable ("DumbbellNewFlow", LOG_LEVEL_DEBUG);
@@ -471,6 +485,10 @@ main (int argc, char *argv[])
             << "enable_stdout: " << std::boolalpha << enable_stdout << "\n"      
             << "printprogress: " << std::boolalpha << printprogress << "\n"
             << "skip_run: " << std::boolalpha << skip_run << "\n"            
+            << "checkpoint_seconds: " << checkpoint_seconds << "\n"
+            << "checkpoint_retries: " << checkpoint_retries << "\n"
+            << "routing_threads: " << routing_threads << "\n"
+            << "packet_metadata: " << std::boolalpha << packet_metadata << "\n"
             << "config_path: " << config_path << "\n"
             << "result_dir: " << result_dir << "\n"
             << "sack: " << sack << "\n"
@@ -913,8 +931,6 @@ main (int argc, char *argv[])
     if (logtcp) {
       ns3TcpSocket->TraceConnectWithoutContext ("CongestionWindow", MakeBoundCallback (&CwndChange, i));
     }
-    // Always log RTT though (not necessarily write to file)
-    Config::ConnectWithoutContext ("/NodeList/"+std::to_string(2+i)+"/$ns3::TcpL4Protocol/SocketList/0/RTT", MakeBoundCallback (&TraceRtt, i));
 
     Ptr<MySource> app = CreateObject<MySource> ();
     if (i < num_cca0) {
@@ -954,6 +970,14 @@ main (int argc, char *argv[])
   }
 
   NS_LOG_DEBUG("================== Tracing ==================");
+  // Always log RTT though (not necessarily write to file): the socket of left leaf i (node 2+i), in a single path lookup
+  if (num_leaf > 0) {
+    std::vector<CallbackBase> rtt_cbs;
+    for (uint32_t i = 0; i < num_leaf; ++i) {
+      rtt_cbs.push_back (MakeBoundCallback (&TraceRtt, i));
+    }
+    Config::LookupMatches ("/NodeList/[2-"+std::to_string(1+num_leaf)+"]/$ns3::TcpL4Protocol/SocketList/0").ConnectWithoutContext ("RTT", rtt_cbs);
+  }
   // Tracing PointToPointNetDevice
   router_devices.Get(0)->TraceConnectWithoutContext("PhyTxEnd", MakeCallback (&PhyTxEndCb));
   // The other NetDevice only transmits ACK packets
@@ -975,7 +999,11 @@ main (int argc, char *argv[])
                       "app_tpt_"+std::to_string(tracing_period_us)+".dat",
                       "jfi_"+std::to_string(tracing_period_us)+".dat");
 
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  if (routing_threads > 0) {
+    Ipv4GlobalRoutingHelper::BuildRoutingTables (routing_threads);
+  } else {
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  }
 
   if (printprogress) {
     Simulator::Schedule (MilliSeconds(progress_interval_ms), &PrintProgress, MilliSeconds(progress_interval_ms));
@@ -983,6 +1011,10 @@ main (int argc, char *argv[])
 
   NS_LOG_DEBUG("================== Run ==================");
 
+  if (checkpoint_seconds > 0) {
+    SimSnapshot::Schedule (Seconds (checkpoint_seconds), result_dir, checkpoint_retries);
+  }
+
   Simulator::Stop (Seconds (sim_seconds));
   auto start = std::chrono::high_resolution_clock::now();
   Simulator::Run ();
@@ -1087,8 +1119,15 @@ main (int argc, char *argv[])
   }
 
   oss << "\n=== Completion time [s]: " << elapsed_seconds.count() << "===\n";
-  std::ofstream summary_ofs (result_dir + "/digest", std::ios::out | std::ios::app);  
+  // Write-then-rename: a digest is either complete or absent, which skip_run and batch_runner rely on
+  std::string digest_tmp = result_dir + "/digest.tmp." + std::to_string(getpid());
+  std::ofstream summary_ofs (digest_tmp, std::ios::out | std::ios::trunc);
   summary_ofs << oss.str();
+  summary_ofs.close();
+  if (!summary_ofs || rename (digest_tmp.c_str (), (result_dir + "/digest").c_str ()) != 0) {
+    std::cout << "ERR: writing " << result_dir << "/digest failed" << std::endl;
+    return 1;
+  }
 
   if (enable_stdout) {
     std::cout << oss.str() << std::endl;
@@ -17,6 +17,7 @@
 #include "ns3/traffic-control-module.h"
 
 #include "../dumbbell_long/my-source.h"
+#include "../dumbbell_long/sim-snapshot.h"
 
 using namespace ns3;
 
@@ -121,6 +122,11 @@ main (int argc, char *argv[])
   uint32_t progress_interval_ms = 1000;
   bool enable_debug = 0;  
   bool skip_run = 0;    
+  double checkpoint_seconds = 0;  // 0: no snapshot
+  uint32_t checkpoint_retries = 1;
+  uint32_t routing_threads = 1;  // 0: GlobalRouteManager
+  bool packet_metadata = false;  // Packet headers in the debug logs, at a cost per packet
+  uint32_t num_threads = 1;  // 1: sequential simulator
   bool logtcp = 0;
   bool enable_stdout = 1; 
   uint32_t seed = 1;  // Fixed
@@ -200,6 +206,11 @@ main (int argc, char *argv[])
   cmd.AddValue ("enable_stdout", "Enable verbose rmterminal print", enable_stdout);  
   cmd.AddValue ("printprogress", "Enable verbose rmterminal print", printprogress);
   cmd.AddValue ("skip_run", "Skip running if result_dir/digest exists", skip_run);      
+  cmd.AddValue ("checkpoint_seconds", "Simulated time [s] of the in-memory snapshot to resume failed runs from (0 to disable)", checkpoint_seconds);
+  cmd.AddValue ("checkpoint_retries", "Number of resumptions from the snapshot upon failure", checkpoint_retries);
+  cmd.AddValue ("routing_threads", "Number of threads building the global routes (0 for the GlobalRouteManager)", routing_threads);
+  cmd.AddValue ("packet_metadata", "Enable the packet metadata, to print the packet headers (slower)", packet_metadata);
+  cmd.AddValue ("num_threads", "Number of threads to partition the topology over (1 for the sequential simulator, required by CebinaeQueueDisc)", num_threads);
   cmd.AddValue ("sim_seconds", "Simulation time [s]", sim_seconds);
   cmd.AddValue ("app_seconds_start", "Application start time [s]", app_seconds_start);  
   cmd.AddValue ("app_seconds_end", "Application stop time [s]", app_seconds_end);
@@ -240,7 +251,7 @@ main (int argc, char *argv[])
   cmd.AddValue ("leaf_delay6", "", leaf_delay6);  
   cmd.AddValue ("leaf_delay7", "", leaf_delay7);              
   cmd.AddValue ("leaf_delay8", "", leaf_delay8);    
-  cmd.AddValue ("app_bw0", "BW of each application", app_bw0);
+  cmd.AddValue ("app_bw0", "BW of each application (0 for infinite demand)", app_bw0);
   cmd.AddValue ("app_bw1", "", app_bw1);  
   cmd.AddValue ("app_bw2", "", app_bw2);  
   cmd.AddValue ("app_bw3", "", app_bw3);  
@@ -272,6 +283,11 @@ main (int argc, char *argv[])
 
   cmd.Parse (argc, argv);
 
+  // The packet metadata is decided once, before the first packet is created
+  if (packet_metadata) {
+    Packet::EnablePrinting ();
+  }
+
   if (enable_debug) {
     LogComponentEnable ("CebinaeQueueDisc", LOG_LEVEL_DEBUG);
     LogComponentEnable ("Parkinglot", LOG_LEVEL_DEBUG);
@@ -320,6 +336,12 @@ main (int argc, char *argv[])
     std::cout << "ERR: " << num_cca << " > " << MAX_CCA << std::endl;
     return 1;
   }
+  // Simultaneous arrivals from different partitions may not run in the sequential order, which
+  // changes the per-round LBF decisions of Cebinae
+  if (num_threads > 1 && queuedisc_type == "CebinaeQueueDisc") {
+    std::cout << "ERR: num_threads > 1 is not supported with CebinaeQueueDisc" << std::endl;
+    return 1;
+  }
 
   num_leaf = 0;
   switch(num_cca) {
@@ -358,6 +380,11 @@ main (int argc, char *argv[])
             << "enable_stdout: " << std::boolalpha << enable_stdout << "\n"      
             << "printprogress: " << std::boolalpha << printprogress << "\n"
             << "skip_run: " << std::boolalpha << skip_run << "\n"            
+            << "checkpoint_seconds: " << checkpoint_seconds << "\n"
+            << "checkpoint_retries: " << checkpoint_retries << "\n"
+            << "routing_threads: " << routing_threads << "\n"
+            << "packet_metadata: " << std::boolalpha << packet_metadata << "\n"
+            << "num_threads: " << num_threads << "\n"
             << "config_path: " << config_path << "\n"
             << "result_dir: " << result_dir << "\n"
             << "sack: " << sack << "\n"
@@ -428,6 +455,15 @@ main (int argc, char *argv[])
 
   if (enable_debug) std::cout << oss.str() << std::endl;
 
+  if (num_threads > 1) {
+    // The snapshot forks, which leaves the child without the partition threads
+    if (checkpoint_seconds > 0) {
+      std::cout << "WARN: checkpoint_seconds ignored with num_threads > 1" << std::endl;
+      checkpoint_seconds = 0;
+    }
+    MultithreadedSimulatorHelper::Enable ();
+  }
+
   RngSeedManager::SetSeed (seed);
   RngSeedManager::SetRun (run);
 
@@ -855,7 +891,17 @@ main (int argc, char *argv[])
                       "app_tpt_"+std::to_string(tracing_period_us)+".dat",
                       "jfi_"+std::to_string(tracing_period_us)+".dat");
 
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  if (routing_threads > 0) {
+    Ipv4GlobalRoutingHelper::BuildRoutingTables (routing_threads);
+  } else {
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  }
+
+  if (num_threads > 1) {
+    Time lookahead = MultithreadedSimulatorHelper::AutoPartition (num_threads);
+    oss << "Partitions: " << DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ())->GetNPartitions ()
+        << ", lookahead [us]: " << lookahead.GetMicroSeconds () << "\n";
+  }
 
   if (printprogress) {
     Simulator::Schedule (MilliSeconds(progress_interval_ms), &PrintProgress, MilliSeconds(progress_interval_ms));
@@ -863,6 +909,10 @@ main (int argc, char *argv[])
 
   if (enable_debug) std::cout << "================== Run ==================" << std::endl;
 
+  if (checkpoint_seconds > 0) {
+    SimSnapshot::Schedule (Seconds (checkpoint_seconds), result_dir, checkpoint_retries);
+  }
+
   Simulator::Stop (Seconds (sim_seconds));
   auto start = std::chrono::high_resolution_clock::now();
   Simulator::Run ();
@@ -921,8 +971,15 @@ main (int argc, char *argv[])
   }
 
   oss << "\n=== Completion time [s]: " << elapsed_seconds.count() << "===\n";
-  std::ofstream summary_ofs (result_dir + "/digest", std::ios::out | std::ios::app);  
+  // Write-then-rename: a digest is either complete or absent, which skip_run and batch_runner rely on
+  std::string digest_tmp = result_dir + "/digest.tmp." + std::to_string(getpid());
+  std::ofstream summary_ofs (digest_tmp, std::ios::out | std::ios::trunc);
   summary_ofs << oss.str();
+  summary_ofs.close();
+  if (!summary_ofs || rename (digest_tmp.c_str (), (result_dir + "/digest").c_str ()) != 0) {
+    std::cout << "ERR: writing " << result_dir << "/digest failed" << std::endl;
+    return 1;
+  }
 
   if (enable_stdout) {
     std::cout << oss.str() << std::endl;
@@ -0,0 +1,624 @@
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <math.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <unordered_map>
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/my-source-id-tag.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include "../dumbbell_long/my-source.h"
+#include "../dumbbell_long/sim-snapshot.h"
+
+using namespace ns3;
+
+// Parametric N-hop parking lot: routers r0 ... rN chained by N identical bottleneck links.
+// - Long group: num_long_flows flows r0 -> rN crossing every hop.
+// - Cross group h (0 <= h < N): num_cross_flows flows r(h) -> r(h+1) crossing hop h only.
+// Each group shares one sender and one receiver host (multiple sockets and a single PacketSink), which keeps the
+// node count, and hence global routing setup, at O(N) rather than O(N*num_cross_flows).
+NS_LOG_COMPONENT_DEFINE ("ParkinglotN");
+
+uint32_t num_hops = 2;
+double sim_seconds = 1;
+double app_seconds_start = 0.1;
+double app_seconds_end = 10;
+
+// Flow id (MySourceIDTag value) to the [first, last] hop it crosses
+std::vector<uint32_t> flow2firsthop;
+std::vector<uint32_t> flow2lasthop;
+
+std::vector<std::uint64_t> packetsink_mysourceidtag2bytecount;
+std::vector<double> avg_tpt_app;  // This is actually goodput
+static void
+RxWithAddressesPacketSink (Ptr<const Packet> p, const Address& from, const Address& local) {
+  MySourceIDTag tag;
+  if (p->FindFirstMatchingByteTag(tag)) {
+    packetsink_mysourceidtag2bytecount[tag.Get()] += p->GetSize();
+  }
+}
+
+// Bytes transmitted on each hop (egress of r(h) towards r(h+1)): the flows all run forward, so data only
+std::vector<std::uint64_t> hop2bytecount;
+std::vector<double> avg_tpt_hop;
+static void
+PhyTxEndCb (uint32_t hop, Ptr<const Packet> p)
+{
+  hop2bytecount[hop] += p->GetSize();
+}
+
+Time prevTime = Seconds (0);
+std::string result_dir;
+uint32_t tracing_period_us = 0;
+static void
+TraceThroughput (std::string hop_fn, std::string app_fn)
+{
+  Time curTime = Now ();
+  double period = curTime.GetSeconds () - prevTime.GetSeconds ();
+
+  std::ofstream hop_ofs (result_dir + "/" + hop_fn, std::ios::out | std::ios::app);
+  for (uint32_t i = 0; i < hop2bytecount.size(); i++) {
+    hop_ofs << std::fixed << std::setprecision (3) << 8.0*hop2bytecount[i]/period << " ";
+    avg_tpt_hop[i] += (8.0*hop2bytecount[i]/(sim_seconds-app_seconds_start));
+    hop2bytecount[i] = 0;
+  }
+  hop_ofs << std::endl;
+
+  std::ofstream app_ofs (result_dir + "/" + app_fn, std::ios::out | std::ios::app);
+  double total = 0.0;
+  for (uint32_t i = 0; i < packetsink_mysourceidtag2bytecount.size(); i++) {
+    app_ofs << std::fixed << std::setprecision (3) << 8.0*packetsink_mysourceidtag2bytecount[i]/period << " ";
+    avg_tpt_app[i] += (8.0*packetsink_mysourceidtag2bytecount[i]/(sim_seconds-app_seconds_start));
+    total += 8.0*packetsink_mysourceidtag2bytecount[i]/period;
+    packetsink_mysourceidtag2bytecount[i] = 0;
+  }
+  app_ofs << std::fixed << std::setprecision (3) << total << std::endl;
+
+  prevTime = curTime;
+  Simulator::Schedule(MicroSeconds(tracing_period_us), &TraceThroughput, hop_fn, app_fn);
+}
+
+bool printprogress = true;
+void
+PrintProgress (Time interval)
+{
+  std::cout << "[PID:" << getpid() << "] Progress: " << std::fixed << std::setprecision (1) << Simulator::Now ().GetSeconds () << "[s]" << std::endl;
+  Simulator::Schedule (interval, &PrintProgress, interval);
+}
+
+int
+main (int argc, char *argv[])
+{
+  CommandLine cmd (__FILE__);
+
+  // Non-configurable or derived params
+  bool sack = true;
+  std::string recovery = "ns3::TcpClassicRecovery";
+  // Naming the output directory using local system time
+  time_t rawtime;
+  struct tm * timeinfo;
+  char buffer [80];
+  time (&rawtime);
+  timeinfo = localtime (&rawtime);
+  strftime (buffer, sizeof (buffer), "%Y-%m-%d-%H-%M-%S-%Z", timeinfo);
+  std::string current_time (buffer);
+  result_dir = "tmp_index/" + current_time + "/";
+
+  // CMD configurable params
+  std::string config_path = "";
+  tracing_period_us = 1000000;
+  uint32_t progress_interval_ms = 1000;
+  bool enable_debug = 0;
+  bool skip_run = 0;
+  double checkpoint_seconds = 0;  // 0: no snapshot
+  uint32_t checkpoint_retries = 1;
+  uint32_t routing_threads = 1;  // 0: GlobalRouteManager
+  bool packet_metadata = false;  // Packet headers in the debug logs, at a cost per packet
+  uint32_t num_threads = 1;  // 1: sequential simulator
+  bool enable_stdout = 1;
+  uint32_t seed = 1;  // Fixed
+  uint32_t run = 1;  // Varry across replications
+  sim_seconds = 10;
+  uint32_t delackcount = 1;
+  std::string switch_netdev_size = "100p";
+  std::string server_netdev_size = "100p";
+  uint32_t app_packet_size = 1440;
+  std::string switch_total_bufsize = "100p";
+  std::string queuedisc_type = "FifoQueueDisc";
+  std::string bottleneck_bw = "5Mbps";
+  std::string bottleneck_delay = "2ms";
+  std::string leaf_bw = "10000Mbps";
+  std::string leaf_delay = "1ms";
+  std::string app_bw = "0Mbps";
+  uint32_t num_long_flows = 1;
+  uint32_t num_cross_flows = 1;
+  std::string transport_prot_long = "TcpNewReno";
+  // Comma-separated, assigned to the cross groups round robin
+  std::string transport_prot_cross = "TcpNewReno";
+  Time dt {NanoSeconds (1048576)};
+  Time vdt {NanoSeconds (1024)};
+  Time l {NanoSeconds (65536)};
+  uint32_t p {1};
+  double tau {0.05};
+  double delta_port {0.05};
+  double delta_flow {0.05};
+  bool pool = 0;
+
+  cmd.AddValue("config_path", "Path to the json configuration file", config_path);
+  cmd.AddValue("result_dir", "Optional path to the output dir", result_dir);
+  cmd.AddValue("seed", "Seed", seed);
+  cmd.AddValue("run", "Run", run);
+  cmd.AddValue ("enable_debug", "Enable logging", enable_debug);
+  cmd.AddValue ("pool", "Enable pool", pool);
+  cmd.AddValue ("enable_stdout", "Enable verbose rmterminal print", enable_stdout);
+  cmd.AddValue ("printprogress", "Enable verbose rmterminal print", printprogress);
+  cmd.AddValue ("skip_run", "Skip running if result_dir/digest exists", skip_run);
+  cmd.AddValue ("checkpoint_seconds", "Simulated time [s] of the in-memory snapshot to resume failed runs from (0 to disable)", checkpoint_seconds);
+  cmd.AddValue ("checkpoint_retries", "Number of resumptions from the snapshot upon failure", checkpoint_retries);
+  cmd.AddValue ("routing_threads", "Number of threads building the global routes (0 for the GlobalRouteManager)", routing_threads);
+  cmd.AddValue ("packet_metadata", "Enable the packet metadata, to print the packet headers (slower)", packet_metadata);
+  cmd.AddValue ("num_threads", "Number of threads to partition the topology over (1 for the sequential simulator, required by CebinaeQueueDisc)", num_threads);
+  cmd.AddValue ("sim_seconds", "Simulation time [s]", sim_seconds);
+  cmd.AddValue ("app_seconds_start", "Application start time [s]", app_seconds_start);
+  cmd.AddValue ("app_seconds_end", "Application stop time [s]", app_seconds_end);
+  cmd.AddValue ("tracing_period_us", "Tracing period [us]", tracing_period_us);
+  cmd.AddValue ("progress_interval_ms", "Prograss interval [ms]", progress_interval_ms);
+  cmd.AddValue ("delackcount", "TcpSocket::DelAckCount", delackcount);
+  cmd.AddValue ("app_packet_size", "App payload size", app_packet_size);
+  cmd.AddValue ("num_hops", "Number of bottleneck hops N (N+1 routers)", num_hops);
+  cmd.AddValue ("num_long_flows", "Number of flows crossing all hops", num_long_flows);
+  cmd.AddValue ("num_cross_flows", "Number of single-hop cross flows per hop", num_cross_flows);
+  cmd.AddValue ("transport_prot_long", "Transport protocol of the long flows", transport_prot_long);
+  cmd.AddValue ("transport_prot_cross", "Comma-separated transport protocols of the cross groups (round robin over hops)", transport_prot_cross);
+  cmd.AddValue ("bottleneck_bw", "BW of the bottleneck links", bottleneck_bw);
+  cmd.AddValue ("bottleneck_delay", "Delay of the bottleneck links", bottleneck_delay);
+  cmd.AddValue ("leaf_bw", "BW of the host links", leaf_bw);
+  cmd.AddValue ("leaf_delay", "Delay of the host links", leaf_delay);
+  cmd.AddValue ("app_bw", "BW of each application (0 for infinite demand)", app_bw);
+  cmd.AddValue ("switch_netdev_size", "Netdevice queue size (switch)", switch_netdev_size);
+  cmd.AddValue ("server_netdev_size", "Netdevice queue size (server)", server_netdev_size);
+  cmd.AddValue ("switch_total_bufsize", "Switch buffer size", switch_total_bufsize);
+  cmd.AddValue ("queuedisc_type", "Queue Disc type", queuedisc_type);
+  cmd.AddValue ("dt", "CebinaeQueueDisc", dt);
+  cmd.AddValue ("vdt", "CebinaeQueueDisc", vdt);
+  cmd.AddValue ("l", "CebinaeQueueDisc", l);
+  cmd.AddValue ("p", "CebinaeQueueDisc", p);
+  cmd.AddValue ("tau", "CebinaeQueueDisc", tau);
+  cmd.AddValue ("delta_port", "CebinaeQueueDisc", delta_port);
+  cmd.AddValue ("delta_flow", "CebinaeQueueDisc", delta_flow);
+
+  cmd.Parse (argc, argv);
+
+  // The packet metadata is decided once, before the first packet is created
+  if (packet_metadata) {
+    Packet::EnablePrinting ();
+  }
+
+  if (enable_debug) {
+    LogComponentEnable ("ParkinglotN", LOG_LEVEL_DEBUG);
+  }
+
+  // Validate the arguments before touching result_dir
+  if (num_hops == 0) {
+    std::cout << "ERR: num_hops must be positive" << std::endl;
+    return 1;
+  }
+  // Simultaneous arrivals from different partitions may not run in the sequential order, which
+  // changes the per-round LBF decisions of Cebinae (e.g. 4 threads with the default config)
+  if (num_threads > 1 && queuedisc_type == "CebinaeQueueDisc") {
+    std::cout << "ERR: num_threads > 1 is not supported with CebinaeQueueDisc" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> cross_prots;
+  {
+    std::istringstream iss (transport_prot_cross);
+    std::string prot;
+    while (std::getline (iss, prot, ',')) {
+      cross_prots.push_back (std::string("ns3::") + prot);
+    }
+  }
+  transport_prot_long = std::string("ns3::") + transport_prot_long;
+  TypeId tcpTid;
+  if (cross_prots.empty() || !TypeId::LookupByNameFailSafe (transport_prot_long, &tcpTid)) {
+    std::cout << "TypeId " << transport_prot_long << " not found" << std::endl;
+    return 1;
+  }
+  for (auto& prot : cross_prots) {
+    if (!TypeId::LookupByNameFailSafe (prot, &tcpTid)) {
+      std::cout << "TypeId " << prot << " not found" << std::endl;
+      return 1;
+    }
+  }
+
+  if (!config_path.empty() && !std::ifstream {config_path}) {
+    std::cout << "ERR: cannot read " << config_path << std::endl;
+    return 1;
+  }
+
+  if (skip_run) {
+    std::ifstream digest_file;
+    digest_file.open(result_dir+"/digest");
+    if (digest_file) {
+      std::cout << "Skip run per existence of " << result_dir << "/digest" << std::endl;
+      return 0;
+    }
+  }
+
+  std::string rm_dir_cmd = "rm -rf " + result_dir;
+  if (system (rm_dir_cmd.c_str ()) == -1) {
+    std::cout << "ERR: " << rm_dir_cmd << " failed, proceed anyway." << std::endl;
+  };
+  std::string create_dir_cmd = "mkdir -p " + result_dir;
+  if (system (create_dir_cmd.c_str ()) == -1) {
+    std::cout << "ERR: " << create_dir_cmd << " failed, proceed anyway." << std::endl;
+  }
+  if (!config_path.empty()) {
+    std::ifstream in_file {config_path};
+    std::ofstream out_file {result_dir+"/config.json"};
+    std::string line;
+    if(in_file && out_file){
+      while(getline(in_file, line)) { out_file << line << "\n"; }
+    } else {
+      printf("ERR mirroring config file");
+      return 1;
+    }
+  }
+
+  // Group 0 is the long group, group h+1 the cross group of hop h
+  uint32_t num_groups = num_hops + 1;
+  uint32_t num_flows = num_long_flows + num_hops*num_cross_flows;
+
+  std::ostringstream oss;
+  oss       << "=== CMD varas ===\n"
+            << "enable_debug: " << std::boolalpha << enable_debug << "\n"
+            << "enable_stdout: " << std::boolalpha << enable_stdout << "\n"
+            << "printprogress: " << std::boolalpha << printprogress << "\n"
+            << "skip_run: " << std::boolalpha << skip_run << "\n"
+            << "checkpoint_seconds: " << checkpoint_seconds << "\n"
+            << "checkpoint_retries: " << checkpoint_retries << "\n"
+            << "routing_threads: " << routing_threads << "\n"
+            << "packet_metadata: " << std::boolalpha << packet_metadata << "\n"
+            << "num_threads: " << num_threads << "\n"
+            << "config_path: " << config_path << "\n"
+            << "result_dir: " << result_dir << "\n"
+            << "sack: " << sack << "\n"
+            << "recovery: " << recovery << "\n"
+            << "app_packet_size: " << app_packet_size << "\n"
+            << "delackcount: " << delackcount << "\n"
+            << "seed: " << seed << "\n"
+            << "run: " << run << "\n"
+            << "tracing_period_us: " << tracing_period_us << "\n"
+            << "progress_interval_ms: " << progress_interval_ms << "\n"
+            << "sim_seconds: " << sim_seconds << "\n"
+            << "app_seconds_start: " << app_seconds_start << "\n"
+            << "app_seconds_end: " << app_seconds_end << "\n"
+            << "num_hops: " << num_hops << "\n"
+            << "num_long_flows: " << num_long_flows << "\n"
+            << "num_cross_flows: " << num_cross_flows << "\n"
+            << "transport_prot_long: " << transport_prot_long << "\n"
+            << "transport_prot_cross: " << transport_prot_cross << "\n"
+            << "bottleneck_bw: " << bottleneck_bw << "\n"
+            << "bottleneck_delay: " << bottleneck_delay << "\n"
+            << "leaf_bw: " << leaf_bw << "\n"
+            << "leaf_delay: " << leaf_delay << "\n"
+            << "app_bw: " << app_bw << "\n"
+            << "switch_total_bufsize: " << switch_total_bufsize << "\n"
+            << "switch_netdev_size: " << switch_netdev_size << "\n"
+            << "server_netdev_size: " << server_netdev_size << "\n"
+            << "queuedisc_type: " << queuedisc_type << "\n"
+            << "num_flows: " << num_flows << "\n"
+            << "======\n";
+
+  if (num_threads > 1) {
+    // The snapshot forks, which leaves the child without the partition threads
+    if (checkpoint_seconds > 0) {
+      std::cout << "WARN: checkpoint_seconds ignored with num_threads > 1" << std::endl;
+      checkpoint_seconds = 0;
+    }
+    MultithreadedSimulatorHelper::Enable ();
+  }
+
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+
+  NS_LOG_DEBUG("================== Topology: " << num_hops << "-hop parking lot ==================");
+
+  NodeContainer router;
+  NodeContainer senders;
+  NodeContainer receivers;
+  router.Create (num_hops+1);
+  senders.Create (num_groups);
+  receivers.Create (num_groups);
+
+  PointToPointHelper p2p_bottleneck;
+  p2p_bottleneck.SetDeviceAttribute ("DataRate", StringValue (bottleneck_bw));
+  p2p_bottleneck.SetDeviceAttribute ("Mtu", UintegerValue(1500));
+  p2p_bottleneck.SetChannelAttribute ("Delay", StringValue (bottleneck_delay));
+  p2p_bottleneck.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue (switch_netdev_size));
+  PointToPointHelper p2p_leaf;
+  p2p_leaf.SetDeviceAttribute ("DataRate", StringValue (leaf_bw));
+  p2p_leaf.SetDeviceAttribute ("Mtu", UintegerValue(1500));
+  p2p_leaf.SetChannelAttribute ("Delay", StringValue (leaf_delay));
+  p2p_leaf.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue (server_netdev_size));
+
+  NetDeviceContainer router_devices_right;
+  NetDeviceContainer router_devices_left;
+  for (uint32_t h = 0; h < num_hops; h++) {
+    NetDeviceContainer c = p2p_bottleneck.Install(router.Get(h), router.Get(h+1));
+    router_devices_right.Add(c.Get(0));
+    router_devices_left.Add(c.Get(1));
+  }
+
+  NetDeviceContainer sender_devices;
+  NetDeviceContainer receiver_devices;
+  NetDeviceContainer sender_router_devices;
+  NetDeviceContainer receiver_router_devices;
+  for (uint32_t g = 0; g < num_groups; g++) {
+    uint32_t first_router = (g == 0) ? 0 : g-1;
+    uint32_t last_router = (g == 0) ? num_hops : g;
+    NetDeviceContainer cl = p2p_leaf.Install(router.Get (first_router), senders.Get (g));
+    NetDeviceContainer cr = p2p_leaf.Install(router.Get (last_router), receivers.Get (g));
+    sender_router_devices.Add (cl.Get (0));
+    sender_devices.Add (cl.Get (1));
+    receiver_router_devices.Add (cr.Get (0));
+    receiver_devices.Add (cr.Get (1));
+  }
+
+  NS_LOG_DEBUG("================== InternetStackHelper ==================");
+
+  InternetStackHelper stack;
+  stack.Install (router);
+  stack.Install (senders);
+  stack.Install (receivers);
+
+  NS_LOG_DEBUG("================== Install TCP transport ==================");
+  // 2 MB (large enough) TCP buffers to prevent the applications from bottlenecking the exp
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 21));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 21));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (app_packet_size));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (sack));
+  Config::SetDefault ("ns3::TcpSocket::DelAckCount", UintegerValue (delackcount));
+  Config::SetDefault ("ns3::TcpL4Protocol::RecoveryType",
+                      TypeIdValue (TypeId::LookupByName (recovery)));
+
+  for (uint32_t g = 0; g < num_groups; g++) {
+    std::string prot = (g == 0) ? transport_prot_long : cross_prots[(g-1) % cross_prots.size()];
+    senders.Get(g)->GetObject<TcpL4Protocol> ()->SetAttribute ("SocketType", TypeIdValue (TypeId::LookupByName(prot)));
+    receivers.Get(g)->GetObject<TcpL4Protocol> ()->SetAttribute ("SocketType", TypeIdValue (TypeId::LookupByName(prot)));
+  }
+
+  NS_LOG_DEBUG("================== Configure TrafficControlLayer ==================");
+  // We keep the tch default ns3::FqCoDelQueueDisc (for point-to-point) untouched for sources and sinks.
+
+  TrafficControlHelper tch_switch;
+  QueueDiscContainer qdiscs;
+  if (queuedisc_type.compare("FifoQueueDisc") == 0) {
+    tch_switch.SetRootQueueDisc ("ns3::FifoQueueDisc", "MaxSize", StringValue (switch_total_bufsize));
+    qdiscs = tch_switch.Install(router_devices_right);
+    oss << "Configured FifoQueueDisc\n";
+  } else if (queuedisc_type.compare("CebinaeQueueDisc") == 0) {
+    Config::SetDefault ("ns3::CebinaeQueueDisc::debug", BooleanValue (enable_debug));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::dT", TimeValue (dt));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::vdT", TimeValue (vdt));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::L", TimeValue (l));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::P", UintegerValue (p));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::tau", DoubleValue (tau));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::delta_port", DoubleValue (delta_port));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::delta_flow", DoubleValue (delta_flow));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::pool", BooleanValue (pool));
+    Config::SetDefault ("ns3::CebinaeQueueDisc::DataRate", StringValue (bottleneck_bw));
+
+    tch_switch.SetRootQueueDisc ("ns3::CebinaeQueueDisc", "MaxSize", StringValue (switch_total_bufsize));
+    qdiscs = tch_switch.Install(router_devices_right);
+    oss << "--- Configured CebinaeQueueDisc ---\n"
+        << "dt: " << dt << "\n"
+        << "vdt: " << vdt << "\n"
+        << "l: " << l << "\n"
+        << "p: " << p << "\n"
+        << "tau: " << tau << "\n"
+        << "delta_port: " << delta_port << "\n"
+        << "delta_flow: " << delta_flow << "\n"
+        << "------\n";
+  } else if (queuedisc_type.compare("FqCoDelQueueDisc") == 0) {
+    tch_switch.SetRootQueueDisc ("ns3::FqCoDelQueueDisc", "MaxSize", StringValue (switch_total_bufsize),
+                                                          "Flows", UintegerValue (4294967295));
+    qdiscs = tch_switch.Install(router_devices_right);
+    oss << "Configured FqCoDelQueueDisc\n";
+  } else {
+    oss << "Configured NULL QueueDisc (which is the default FqCoDelQueueDisc and buffer size)\n";
+  }
+
+  NS_LOG_DEBUG("================== Configure Ipv4AddressHelper ==================");
+  // /30 per link leaves room for 2^22 links per helper
+  Ipv4AddressHelper ipv4_leaf ("10.0.0.0", "255.255.255.252");
+  Ipv4AddressHelper ipv4_router ("172.16.0.0", "255.255.255.252");
+
+  for (uint32_t h = 0; h < num_hops; h++) {
+    NetDeviceContainer ndc;
+    ndc.Add (router_devices_right.Get (h));
+    ndc.Add (router_devices_left.Get (h));
+    ipv4_router.Assign (ndc);
+    ipv4_router.NewNetwork ();
+  }
+  Ipv4InterfaceContainer receiver_ifc;
+  for (uint32_t g = 0; g < num_groups; g++) {
+    NetDeviceContainer ndc;
+    ndc.Add (sender_devices.Get (g));
+    ndc.Add (sender_router_devices.Get (g));
+    ipv4_leaf.Assign (ndc);
+    ipv4_leaf.NewNetwork ();
+    ndc = NetDeviceContainer ();
+    ndc.Add (receiver_devices.Get (g));
+    ndc.Add (receiver_router_devices.Get (g));
+    Ipv4InterfaceContainer ifc = ipv4_leaf.Assign (ndc);
+    receiver_ifc.Add (ifc.Get (0));
+    ipv4_leaf.NewNetwork ();
+  }
+
+  NS_LOG_DEBUG("================== Generate application ==================");
+
+  uint16_t sinkPort = 8080;
+  for (uint32_t g = 0; g < num_groups; g++) {
+    // A single sink accepts all connections of the group
+    Ptr<PacketSink> sink = CreateObject<PacketSink> ();
+    sink->SetAttribute ("Protocol", StringValue ("ns3::TcpSocketFactory"));
+    sink->SetAttribute ("Local", AddressValue (InetSocketAddress (Ipv4Address::GetAny (), sinkPort)));
+    receivers.Get(g)->AddApplication(sink);
+    sink->SetStartTime (Seconds (0.));
+    sink->SetStopTime (Seconds (app_seconds_end));
+    sink->TraceConnectWithoutContext("RxWithAddresses", MakeCallback(&RxWithAddressesPacketSink));
+  }
+
+  std::vector<Ptr<MySource>> sources;
+  for (uint32_t g = 0; g < num_groups; g++) {
+    uint32_t group_flows = (g == 0) ? num_long_flows : num_cross_flows;
+    Address sinkAddress (InetSocketAddress (receiver_ifc.GetAddress(g), sinkPort));
+    for (uint32_t f = 0; f < group_flows; f++) {
+      uint32_t sourceid = sources.size();
+      Ptr<Socket> ns3TcpSocket = Socket::CreateSocket (senders.Get (g), TcpSocketFactory::GetTypeId ());
+      Ptr<MySource> app = CreateObject<MySource> ();
+      app->Setup (ns3TcpSocket, sinkAddress, app_packet_size, DataRate (app_bw), sourceid, false);
+      senders.Get (g)->AddApplication (app);
+      app->SetStartTime (Seconds (app_seconds_start));
+      app->SetStopTime (Seconds (app_seconds_end));
+      sources.push_back(app);
+      flow2firsthop.push_back((g == 0) ? 0 : g-1);
+      flow2lasthop.push_back((g == 0) ? num_hops-1 : g-1);
+    }
+  }
+
+  NS_LOG_DEBUG("================== Tracing ==================");
+
+  for (uint32_t h = 0; h < num_hops; h++) {
+    router_devices_right.Get(h)->TraceConnectWithoutContext("PhyTxEnd", MakeBoundCallback (&PhyTxEndCb, h));
+  }
+  hop2bytecount.resize(num_hops, 0);
+  avg_tpt_hop.resize(num_hops, 0);
+  packetsink_mysourceidtag2bytecount.resize(num_flows, 0);
+  avg_tpt_app.resize(num_flows, 0);
+
+  Simulator::Schedule(MicroSeconds(0+tracing_period_us), &TraceThroughput,
+                      "hop_tpt_"+std::to_string(tracing_period_us)+".dat",
+                      "app_tpt_"+std::to_string(tracing_period_us)+".dat");
+
+  auto setup_start = std::chrono::high_resolution_clock::now();
+  if (routing_threads > 0) {
+    Ipv4GlobalRoutingHelper::BuildRoutingTables (routing_threads);
+  } else {
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  }
+  std::chrono::duration<double> routing_seconds = std::chrono::high_resolution_clock::now() - setup_start;
+  oss << "Routing setup time [s]: " << routing_seconds.count() << "\n";
+
+  if (num_threads > 1) {
+    Time lookahead = MultithreadedSimulatorHelper::AutoPartition (num_threads);
+    oss << "Partitions: " << DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ())->GetNPartitions ()
+        << ", lookahead [us]: " << lookahead.GetMicroSeconds () << "\n";
+  }
+
+  if (printprogress) {
+    Simulator::Schedule (MilliSeconds(progress_interval_ms), &PrintProgress, MilliSeconds(progress_interval_ms));
+  }
+
+  NS_LOG_DEBUG("================== Run ==================");
+
+  if (checkpoint_seconds > 0) {
+    SimSnapshot::Schedule (Seconds (checkpoint_seconds), result_dir, checkpoint_retries);
+  }
+
+  Simulator::Stop (Seconds (sim_seconds));
+  auto start = std::chrono::high_resolution_clock::now();
+  Simulator::Run ();
+  auto stop = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed_seconds = stop - start;
+
+  NS_LOG_DEBUG("================== Export digest ==================");
+
+  std::cout << elapsed_seconds.count() << "s" << std::endl;
+
+  oss << "=== avg_tpt_app[*] ===\n";
+  double sum = 0.0;
+  long double sum_squares = 0.0;
+  for (uint32_t i = 0; i < avg_tpt_app.size(); i++) {
+    sum += avg_tpt_app[i];
+    sum_squares += (avg_tpt_app[i] * avg_tpt_app[i]);
+    oss << std::fixed << std::setprecision (3) << i << " " << avg_tpt_app[i] << "\n";
+  }
+  oss << std::fixed << std::setprecision (3) << "Avg. Goodput [bps]: " << sum << "\n";
+  oss << std::fixed << std::setprecision (3) << "avg_jfi_app [computed]: " << (sum*sum)/avg_tpt_app.size()/sum_squares << "\n";
+
+  // Per-hop aggregates in a single pass over the flows: goodput and JFI of the flows crossing each hop
+  std::vector<long double> hop2sum (num_hops, 0);
+  std::vector<long double> hop2sumsquares (num_hops, 0);
+  std::vector<uint32_t> hop2numflows (num_hops, 0);
+  for (uint32_t i = 0; i < num_flows; i++) {
+    for (uint32_t h = flow2firsthop[i]; h <= flow2lasthop[i]; h++) {
+      hop2sum[h] += avg_tpt_app[i];
+      hop2sumsquares[h] += (avg_tpt_app[i] * avg_tpt_app[i]);
+      hop2numflows[h] += 1;
+    }
+  }
+  std::ofstream hops_ofs (result_dir + "/hops.dat", std::ios::out | std::ios::trunc);
+  hops_ofs << "# hop link_tpt_bps num_flows goodput_bps jfi\n";
+  oss << "=== Per-hop [hop link_tpt_bps num_flows goodput_bps jfi] ===\n";
+  for (uint32_t h = 0; h < num_hops; h++) {
+    double jfi = (hop2sumsquares[h] > 0) ? static_cast<double> ((hop2sum[h]*hop2sum[h])/hop2numflows[h]/hop2sumsquares[h]) : 0.0;
+    std::ostringstream row;
+    row << std::fixed << std::setprecision (3) << h << " " << avg_tpt_hop[h] << " " << hop2numflows[h] << " "
+        << static_cast<double> (hop2sum[h]) << " " << jfi << "\n";
+    hops_ofs << row.str();
+    oss << row.str();
+  }
+  hops_ofs.close();
+
+  oss << "====== Number of packets sent ======\n";
+  for (uint32_t sourceid = 0; sourceid < num_flows; sourceid++) {
+    oss << "MySource " << sourceid << ":" << sources[sourceid]->GetPacketsSent() << "\n";
+  }
+
+  if (queuedisc_type.compare("CebinaeQueueDisc") == 0) {
+    oss << "====== CebinaeQueueDisc digest ======\n";
+    std::ofstream cebinae_ofs;
+    if (enable_debug) {
+      cebinae_ofs.open (result_dir + "/cebinae_debug", std::ios::out | std::ios::trunc);
+    }
+    for (uint32_t h = 0; h < num_hops; h++) {
+      oss << "====== Switch " << h << " ======\n";
+      Ptr<CebinaeQueueDisc> q = DynamicCast<CebinaeQueueDisc>(qdiscs.Get(h));
+      oss << q->DumpDigest();
+      if (enable_debug) {
+        cebinae_ofs << "====== Switch " << h << " ======\n" << q->DumpDebugEvents();
+      }
+    }
+  }
+
+  oss << "\n=== Completion time [s]: " << elapsed_seconds.count() << "===\n";
+  // Write-then-rename: a digest is either complete or absent, which skip_run and batch_runner rely on
+  std::string digest_tmp = result_dir + "/digest.tmp." + std::to_string(getpid());
+  std::ofstream summary_ofs (digest_tmp, std::ios::out | std::ios::trunc);
+  summary_ofs << oss.str();
+  summary_ofs.close();
+  if (!summary_ofs || rename (digest_tmp.c_str (), (result_dir + "/digest").c_str ()) != 0) {
+    std::cout << "ERR: writing " << result_dir << "/digest failed" << std::endl;
+    return 1;
+  }
+
+  if (enable_stdout) {
+    std::cout << oss.str() << std::endl;
+  }
+  std::cout << "Result_dir: " << result_dir << std::endl;
+
+  Simulator::Destroy ();
+
+  return 0;
+}
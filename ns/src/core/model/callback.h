@@ -29,6 +29,7 @@
 #include "attribute-helper.h"
 #include "simple-ref-count.h"
 #include <typeinfo>
+#include <utility>
 
 /**
  * \file
@@ -460,7 +461,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (a1);
+    return m_functor (std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -469,7 +470,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (a1,a2);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -479,7 +480,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (a1,a2,a3);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -490,7 +491,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (a1,a2,a3,a4);
+    return m_functor (std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -502,7 +504,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (a1,a2,a3,a4,a5);
+    return m_functor (std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -515,7 +518,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6);
+    return m_functor (std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -529,7 +533,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6,a7);
+    return m_functor (std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                      std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -544,7 +550,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6,a7,a8);
+    return m_functor (std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                      std::forward<T7> (a7), std::forward<T8> (a8));
   }
   /**
    * \param [in] a1 First argument
@@ -560,7 +568,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8,T9 a9)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6,a7,a8,a9);
+    return m_functor (std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                      std::forward<T7> (a7), std::forward<T8> (a8), std::forward<T9> (a9));
   }
   /**@}*/
   /**
@@ -624,7 +634,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -633,7 +643,8 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -643,7 +654,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2),
+                                                                          std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -654,7 +667,10 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2),
+                                                                          std::forward<T3> (a3),
+                                                                          std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -666,7 +682,11 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2),
+                                                                          std::forward<T3> (a3),
+                                                                          std::forward<T4> (a4),
+                                                                          std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -679,7 +699,12 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2),
+                                                                          std::forward<T3> (a3),
+                                                                          std::forward<T4> (a4),
+                                                                          std::forward<T5> (a5),
+                                                                          std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -693,7 +718,13 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6, a7);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2),
+                                                                          std::forward<T3> (a3),
+                                                                          std::forward<T4> (a4),
+                                                                          std::forward<T5> (a5),
+                                                                          std::forward<T6> (a6),
+                                                                          std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -708,7 +739,14 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6, a7, a8);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2),
+                                                                          std::forward<T3> (a3),
+                                                                          std::forward<T4> (a4),
+                                                                          std::forward<T5> (a5),
+                                                                          std::forward<T6> (a6),
+                                                                          std::forward<T7> (a7),
+                                                                          std::forward<T8> (a8));
   }
   /**
    * \param [in] a1 First argument
@@ -724,7 +762,15 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8, T9 a9)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6, a7, a8, a9);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1),
+                                                                          std::forward<T2> (a2),
+                                                                          std::forward<T3> (a3),
+                                                                          std::forward<T4> (a4),
+                                                                          std::forward<T5> (a5),
+                                                                          std::forward<T6> (a6),
+                                                                          std::forward<T7> (a7),
+                                                                          std::forward<T8> (a8),
+                                                                          std::forward<T9> (a9));
   }
   /**@}*/
   /**
@@ -794,7 +840,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (m_a,a1);
+    return m_functor (m_a,std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -803,7 +849,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (m_a,a1,a2);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -813,7 +859,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (m_a,a1,a2,a3);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -824,7 +870,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (m_a,a1,a2,a3,a4);
+    return m_functor (m_a, std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -836,7 +883,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5);
+    return m_functor (m_a, std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -849,7 +897,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5,a6);
+    return m_functor (m_a, std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -863,7 +912,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5,a6,a7);
+    return m_functor (m_a, std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                      std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -878,7 +929,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5,a6,a7,a8);
+    return m_functor (m_a, std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                      std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                      std::forward<T7> (a7), std::forward<T8> (a8));
   }
   /**@}*/
   /**
@@ -952,7 +1005,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (m_a1,m_a2,a1);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -961,7 +1014,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (m_a1,m_a2,a1,a2);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -971,7 +1024,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -982,7 +1035,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4);
+    return m_functor (m_a1, m_a2, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3), std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -994,7 +1048,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4,a5);
+    return m_functor (m_a1, m_a2, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -1007,7 +1062,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4,a5,a6);
+    return m_functor (m_a1, m_a2, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5),
+                      std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -1021,7 +1078,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4,a5,a6,a7);
+    return m_functor (m_a1, m_a2, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5),
+                      std::forward<T6> (a6), std::forward<T7> (a7));
   }
   /**@}*/
   /**
@@ -1100,7 +1159,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -1109,7 +1168,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -1119,7 +1178,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3);
+    return m_functor (m_a1, m_a2, m_a3, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -1130,7 +1190,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3,a4);
+    return m_functor (m_a1, m_a2, m_a3, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3), std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -1142,7 +1203,8 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3,a4,a5);
+    return m_functor (m_a1, m_a2, m_a3, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -1155,7 +1217,9 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3,a4,a5,a6);
+    return m_functor (m_a1, m_a2, m_a3, std::forward<T1> (a1), std::forward<T2> (a2),
+                      std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5),
+                      std::forward<T6> (a6));
   }
   /**@}*/
   /**
@@ -1408,7 +1472,7 @@ public:
    */
   R operator() (T1 a1) const
   {
-    return (*(DoPeekImpl ()))(a1);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -1417,7 +1481,7 @@ public:
    */
   R operator() (T1 a1, T2 a2) const
   {
-    return (*(DoPeekImpl ()))(a1,a2);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -1427,7 +1491,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -1438,7 +1502,8 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                              std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -1450,7 +1515,8 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                              std::forward<T4> (a4), std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -1463,7 +1529,8 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                              std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -1477,7 +1544,9 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                              std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                              std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -1492,7 +1561,9 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7,T8 a8) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7,a8);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                              std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                              std::forward<T7> (a7), std::forward<T8> (a8));
   }
   /**
    * \param [in] a1 First argument
@@ -1508,7 +1579,9 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7,T8 a8, T9 a9) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7,a8,a9);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3),
+                              std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6),
+                              std::forward<T7> (a7), std::forward<T8> (a8), std::forward<T9> (a9));
   }
   /**@}*/
 
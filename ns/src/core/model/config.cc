@@ -143,6 +143,23 @@ MatchContainer::ConnectWithoutContext (std::string name, const CallbackBase &cb)
       NS_FATAL_ERROR ("Could not connect callback to " << name);
     }
 }
+void
+MatchContainer::ConnectWithoutContext (std::string name, const std::vector<CallbackBase> &cbs)
+{
+  NS_LOG_FUNCTION (this << name << cbs.size ());
+  if (cbs.size () != m_objects.size ())
+    {
+      NS_FATAL_ERROR ("Could not connect " << cbs.size () << " callbacks to " << name
+                      << " of " << m_objects.size () << " objects matching " << m_path);
+    }
+  for (std::size_t i = 0; i < m_objects.size (); ++i)
+    {
+      if (!m_objects[i]->TraceConnectWithoutContext (name, cbs[i]))
+        {
+          NS_FATAL_ERROR ("Could not connect callback to " << m_contexts[i] << name);
+        }
+    }
+}
 bool
 MatchContainer::ConnectWithoutContextFailSafe (std::string name, const CallbackBase &cb)
 {
@@ -337,6 +354,16 @@ private:
    * \param [in,out] vector The resulting list of matching objects.
    */
   void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  /**
+   * Parse a plain index on the Config path, fetching only the indexed
+   * object rather than the whole container.
+   *
+   * \param [in] path The remaining Config path.
+   * \param [in] root The object holding the container.
+   * \param [in] accessor The container accessor.
+   * \returns \c false if the next path element is not a plain index.
+   */
+  bool DoIndexResolve (std::string path, Ptr<Object> root, const ObjectPtrContainerAccessor *accessor);
   /**
    * Handle one object found on the path.
    *
@@ -559,10 +586,16 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                 {
                   NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
                   foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
                   m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
+                  const ObjectPtrContainerAccessor *accessor =
+                    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (info.accessor));
+                  if (accessor == 0 || !(info.flags & TypeId::ATTR_GET)
+                      || !DoIndexResolve (pathLeft, root, accessor))
+                    {
+                      ObjectPtrContainerValue vector;
+                      root->GetAttribute (info.name, vector);
+                      DoArrayResolve (pathLeft, vector);
+                    }
                   m_workStack.pop_back ();
                 }
               // this could be anything else and we don't know what to do with it.
@@ -610,6 +643,40 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
     }
 }
 
+bool
+Resolver::DoIndexResolve (std::string path, Ptr<Object> root, const ObjectPtrContainerAccessor *accessor)
+{
+  NS_LOG_FUNCTION (this << path << root << accessor);
+  NS_ASSERT ((path.find ("/")) == 0);
+  std::string::size_type next = path.find ("/", 1);
+  if (next == std::string::npos)
+    {
+      return false;
+    }
+  std::string item = path.substr (1, next - 1);
+  if (item.empty () || item.find_first_not_of ("0123456789") != std::string::npos)
+    {
+      return false;
+    }
+  std::istringstream iss (item);
+  std::size_t index;
+  iss >> index;
+  if (iss.fail ())
+    {
+      return false;
+    }
+  Ptr<Object> object = accessor->GetElement (PeekPointer (root), index);
+  if (object != 0)
+    {
+      std::ostringstream oss;
+      oss << index;
+      m_workStack.push_back (oss.str ());
+      DoResolve (path.substr (next, path.size () - next), object);
+      m_workStack.pop_back ();
+    }
+  return true;
+}
+
 /**
  * \ingroup config-impl
  * Config system implementation class.
@@ -278,6 +278,17 @@ public:
    * \returns \c true if any trace sources could be connected.
    */
   bool ConnectWithoutContextFailSafe (std::string name, const CallbackBase &cb);
+  /**
+   * \param [in] name The name of the trace source to connect to
+   * \param [in] cbs One sink per object, in the order of the objects
+   *
+   * Connect each object stored in this container to its own sink, for
+   * instance one bound to the index of the object, with a single path
+   * lookup.  This method will raise a fatal error if the numbers of sinks
+   * and objects differ or if any object could not be connected.
+   * \sa ns3::Config::LookupMatches
+   */
+  void ConnectWithoutContext (std::string name, const std::vector<CallbackBase> &cbs);
   /**
    * \param [in] name The name of the trace source to disconnect from
    * \param [in] cb The sink to disconnect from the trace source
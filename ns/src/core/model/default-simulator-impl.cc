@@ -22,9 +22,11 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-trace.h"
 
 #include "ptr.h"
 #include "pointer.h"
+#include "string.h"
 #include "assert.h"
 #include "log.h"
 
@@ -53,6 +55,12 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EventTraceFile",
+                   "File to record the event list operations to, see EventTrace (empty to disable)",
+                   TypeId::ATTR_CONSTRUCT,
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetEventTraceFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -73,12 +81,31 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_unscheduledEvents = 0;
   m_eventCount = 0;
   m_eventsWithContextEmpty = true;
+  m_trace = 0;
   m_main = SystemThread::Self ();
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_trace;
+}
+
+void
+DefaultSimulatorImpl::SetEventTraceFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  delete m_trace;
+  m_trace = 0;
+  if (filename.empty ())
+    {
+      return;
+    }
+  m_trace = new EventTrace ();
+  if (!m_trace->Open (filename))
+    {
+      NS_FATAL_ERROR ("Cannot open event trace file " << filename);
+    }
 }
 
 void
@@ -86,6 +113,9 @@ DefaultSimulatorImpl::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   ProcessEventsWithContext ();
+  // The events drained below are not part of the run
+  delete m_trace;
+  m_trace = 0;
 
   while (!m_events->IsEmpty ())
     {
@@ -139,6 +169,10 @@ void
 DefaultSimulatorImpl::ProcessOneEvent (void)
 {
   Scheduler::Event next = m_events->RemoveNext ();
+  if (m_trace != 0)
+    {
+      m_trace->Add (EventTrace::REMOVE_NEXT, next.key);
+    }
 
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
@@ -187,6 +221,10 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
       m_uid++;
       m_unscheduledEvents++;
       m_events->Insert (ev);
+      if (m_trace != 0)
+        {
+          m_trace->Add (EventTrace::INSERT, ev.key);
+        }
     }
 }
 
@@ -243,6 +281,10 @@ DefaultSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_trace != 0)
+    {
+      m_trace->Add (EventTrace::INSERT, ev.key);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -262,6 +304,10 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       m_uid++;
       m_unscheduledEvents++;
       m_events->Insert (ev);
+      if (m_trace != 0)
+        {
+          m_trace->Add (EventTrace::INSERT, ev.key);
+        }
     }
   else
     {
@@ -291,6 +337,10 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_trace != 0)
+    {
+      m_trace->Add (EventTrace::INSERT, ev.key);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -351,6 +401,10 @@ DefaultSimulatorImpl::Remove (const EventId &id)
   event.key.m_context = id.GetContext ();
   event.key.m_uid = id.GetUid ();
   m_events->Remove (event);
+  if (m_trace != 0)
+    {
+      m_trace->Add (EventTrace::REMOVE, event.key);
+    }
   event.impl->Cancel ();
   // whenever we remove an event from the event list, we have to unref it.
   event.impl->Unref ();
@@ -364,6 +418,14 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
   if (!IsExpired (id))
     {
       id.PeekEventImpl ()->Cancel ();
+      if (m_trace != 0 && id.GetUid () != 2)
+        {
+          Scheduler::EventKey key;
+          key.m_ts = id.GetTs ();
+          key.m_uid = id.GetUid ();
+          key.m_context = id.GetContext ();
+          m_trace->Add (EventTrace::CANCEL, key);
+        }
     }
 }
 
@@ -30,6 +30,7 @@
 #include "ptr.h"
 
 #include <list>
+#include <string>
 
 /**
  * \file
@@ -39,6 +40,8 @@
 
 namespace ns3 {
 
+class EventTrace;
+
 /**
  * \ingroup simulator
  *
@@ -86,6 +89,12 @@ private:
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
   void ProcessEventsWithContext (void);
+  /**
+   * Start recording the event list operations.
+   *
+   * \param [in] filename The trace file, empty to stop recording.
+   */
+  void SetEventTraceFile (std::string filename);
 
   /** Wrap an event with its execution context. */
   struct EventWithContext
@@ -133,6 +142,8 @@ private:
    *  not counting the Destroy events; this is used for validation
    */
   int m_unscheduledEvents;
+  /** Recorder of the event list operations, if enabled. */
+  EventTrace *m_trace;
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
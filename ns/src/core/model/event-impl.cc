@@ -20,6 +20,7 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include <new>
 
 /**
  * \file
@@ -31,6 +32,114 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Size class granularity [bytes]. */
+const std::size_t EVENT_POOL_GRANULE = 16;
+/** Number of size classes: events of up to 256 bytes are pooled. */
+const std::size_t EVENT_POOL_CLASSES = 16;
+/** Free blocks kept per size class, beyond which blocks go back to the heap. */
+const uint32_t EVENT_POOL_MAX_FREE = 4096;
+
+/** A free block, linked through its own storage. */
+struct EventPoolBlock
+{
+  EventPoolBlock *next;  /**< The next free block. */
+};
+
+/**
+ * Per-thread free lists.
+ *
+ * Trivially destructible and zero initialized, so it is usable from the
+ * first event to the very last one, including events released by static
+ * destructors after the thread-local drain below has run.
+ */
+struct EventPool
+{
+  EventPoolBlock *head[EVENT_POOL_CLASSES];  /**< Free list of each size class. */
+  uint32_t count[EVENT_POOL_CLASSES];        /**< Length of each free list. */
+  bool registered;                           /**< Is the drain registered. */
+  bool drained;                              /**< Has the thread released its free lists. */
+};
+
+/** The free lists of this thread. */
+thread_local EventPool g_eventPool;
+
+/** Releases the free lists of a thread when it exits. */
+struct EventPoolDrain
+{
+  ~EventPoolDrain ()
+  {
+    for (std::size_t c = 0; c < EVENT_POOL_CLASSES; ++c)
+      {
+        while (g_eventPool.head[c] != 0)
+          {
+            EventPoolBlock *block = g_eventPool.head[c];
+            g_eventPool.head[c] = block->next;
+            ::operator delete (block);
+          }
+        g_eventPool.count[c] = 0;
+      }
+    g_eventPool.drained = true;
+  }
+};
+
+/**
+ * Get the free lists of this thread.
+ *
+ * \returns The free lists, or 0 once they have been released.
+ */
+EventPool *
+GetEventPool (void)
+{
+  EventPool *pool = &g_eventPool;
+  if (!pool->registered)
+    {
+      pool->registered = true;
+      static thread_local EventPoolDrain drain;
+      (void)drain;
+    }
+  return pool->drained ? 0 : pool;
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  std::size_t c = (size + EVENT_POOL_GRANULE - 1) / EVENT_POOL_GRANULE - 1;
+  if (c >= EVENT_POOL_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  EventPool *pool = GetEventPool ();
+  if (pool != 0 && pool->head[c] != 0)
+    {
+      EventPoolBlock *block = pool->head[c];
+      pool->head[c] = block->next;
+      pool->count[c]--;
+      return block;
+    }
+  // Allocate the whole size class so that the block can serve any event of that class
+  return ::operator new ((c + 1) * EVENT_POOL_GRANULE);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  std::size_t c = (size + EVENT_POOL_GRANULE - 1) / EVENT_POOL_GRANULE - 1;
+  EventPool *pool = (c < EVENT_POOL_CLASSES) ? GetEventPool () : 0;
+  if (pool == 0 || pool->count[c] >= EVENT_POOL_MAX_FREE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  EventPoolBlock *block = static_cast<EventPoolBlock *> (p);
+  block->next = pool->head[c];
+  pool->head[c] = block;
+  pool->count[c]++;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,14 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Every event is allocated and freed exactly once, so EventImpl (and
+ * thereby every subclass, including the MakeEvent() closures which hold
+ * their bound arguments inline) is allocated from per-thread, size-class
+ * free lists rather than from the general purpose heap.  A freed block
+ * is recycled by the next event of the same size class, which keeps the
+ * working set of live events small.  Reference counting, and hence
+ * EventId cancellation and expiry semantics, are unchanged.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +75,21 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate an event from the free list of its size class.
+   *
+   * \param [in] size The size of the (derived) event.
+   * \returns The storage for the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Return an event to the free list of its size class.
+   *
+   * \param [in] p The storage of the event.
+   * \param [in] size The size of the (derived) event.
+   */
+  static void operator delete (void *p, std::size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
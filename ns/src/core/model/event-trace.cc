@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-trace.h"
+#include "log.h"
+
+#include <cstring>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventTrace implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventTrace");
+
+namespace {
+
+/** File magic, which also versions the record layout. */
+const char EVENT_TRACE_MAGIC[8] = { 'N', 'S', '3', 'E', 'V', 'T', 'R', '1' };
+
+} // unnamed namespace
+
+EventTrace::EventTrace ()
+  : m_file (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EventTrace::~EventTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+EventTrace::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_file = std::fopen (filename.c_str (), "wb");
+  if (m_file == 0)
+    {
+      return false;
+    }
+  m_buffer.reserve (BUFFER_RECORDS);
+  if (std::fwrite (EVENT_TRACE_MAGIC, sizeof (EVENT_TRACE_MAGIC), 1, m_file) != 1)
+    {
+      Close ();
+      return false;
+    }
+  return true;
+}
+
+void
+EventTrace::Flush (void)
+{
+  if (m_file != 0 && !m_buffer.empty ()
+      && std::fwrite (&m_buffer[0], sizeof (Record), m_buffer.size (), m_file) != m_buffer.size ())
+    {
+      NS_LOG_WARN ("Short write, the event trace is truncated");
+    }
+  m_buffer.clear ();
+}
+
+void
+EventTrace::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file == 0)
+    {
+      return;
+    }
+  Flush ();
+  std::fclose (m_file);
+  m_file = 0;
+}
+
+bool
+EventTrace::Load (std::string filename, std::vector<Record> &records)
+{
+  NS_LOG_FUNCTION (filename);
+  std::FILE *file = std::fopen (filename.c_str (), "rb");
+  if (file == 0)
+    {
+      return false;
+    }
+  char magic[sizeof (EVENT_TRACE_MAGIC)];
+  if (std::fread (magic, sizeof (magic), 1, file) != 1
+      || std::memcmp (magic, EVENT_TRACE_MAGIC, sizeof (magic)) != 0)
+    {
+      std::fclose (file);
+      return false;
+    }
+  records.clear ();
+  Record chunk[BUFFER_RECORDS];
+  std::size_t n;
+  while ((n = std::fread (chunk, sizeof (Record), BUFFER_RECORDS, file)) > 0)
+    {
+      records.insert (records.end (), chunk, chunk + n);
+    }
+  std::fclose (file);
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventTrace declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Binary trace of the operations applied to the event list.
+ *
+ * DefaultSimulatorImpl records every Scheduler operation of a run
+ * when its \c EventTraceFile attribute is set, e.g. without touching
+ * the program:
+ * \verbatim
+   $ NS_ATTRIBUTE_DEFAULT='ns3::DefaultSimulatorImpl::EventTraceFile=events.bin' \
+       ./waf --run dumbbell_long ... \endverbatim
+ * The trace can then be replayed against any Scheduler with
+ * \c utils/bench-scheduler-trace, which applies exactly the same
+ * sequence of Insert, RemoveNext and Remove calls.
+ *
+ * The file is the 8 byte magic \c "NS3EVTR1" followed by 16 byte
+ * records in host byte order: the event timestamp (in the current
+ * Time resolution) with the operation in its two most significant
+ * bits, the event uid and the event context.  Cancel records do not
+ * correspond to a Scheduler call (canceled events stay in the event
+ * list until they are removed as the next event), they are kept for
+ * completeness.
+ */
+class EventTrace
+{
+public:
+  /** Operation on the event list. */
+  enum Op
+  {
+    INSERT = 0,       /**< Scheduler::Insert. */
+    REMOVE_NEXT = 1,  /**< Scheduler::RemoveNext. */
+    REMOVE = 2,       /**< Scheduler::Remove. */
+    CANCEL = 3        /**< EventId::Cancel, no Scheduler call. */
+  };
+
+  /** One operation. */
+  struct Record
+  {
+    uint64_t tsOp;     /**< Timestamp, operation in the two most significant bits. */
+    uint32_t uid;      /**< Event uid. */
+    uint32_t context;  /**< Event context. */
+    /** \returns The operation. */
+    Op GetOp (void) const
+    {
+      return static_cast<Op> (tsOp >> 62);
+    }
+    /** \returns The event key. */
+    Scheduler::EventKey GetKey (void) const
+    {
+      Scheduler::EventKey key;
+      key.m_ts = tsOp & ((1ULL << 62) - 1);
+      key.m_uid = uid;
+      key.m_context = context;
+      return key;
+    }
+  };
+
+  /** Constructor. */
+  EventTrace ();
+  /** Destructor, closes the file. */
+  ~EventTrace ();
+
+  /**
+   * Create the trace file and write its header.
+   *
+   * \param [in] filename The trace file.
+   * \returns \c true on success.
+   */
+  bool Open (std::string filename);
+  /** Flush the buffered records and close the file. */
+  void Close (void);
+  /**
+   * Record an operation.
+   *
+   * \param [in] op The operation.
+   * \param [in] key The key of the event operated on.
+   */
+  void Add (Op op, const Scheduler::EventKey &key)
+  {
+    Record record;
+    record.tsOp = key.m_ts | (static_cast<uint64_t> (op) << 62);
+    record.uid = key.m_uid;
+    record.context = key.m_context;
+    m_buffer.push_back (record);
+    if (m_buffer.size () == BUFFER_RECORDS)
+      {
+        Flush ();
+      }
+  }
+
+  /**
+   * Read a whole trace file.
+   *
+   * \param [in] filename The trace file.
+   * \param [out] records The records of the file.
+   * \returns \c true on success.
+   */
+  static bool Load (std::string filename, std::vector<Record> &records);
+
+private:
+  /** Number of records buffered before they are written out. */
+  static const std::size_t BUFFER_RECORDS = 4096;
+
+  /** Write out the buffered records. */
+  void Flush (void);
+
+  /** The trace file. */
+  std::FILE *m_file;
+  /** The records not yet written. */
+  std::vector<Record> m_buffer;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_TRACE_H */
@@ -0,0 +1,336 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "unused.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/**
+ * \ingroup scheduler
+ * Order used for the Bottom: descending, so the next event is at the back.
+ *
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \pname{a} is later than \pname{b}.
+ */
+inline bool
+IsLater (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return b < a;
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("BucketThreshold",
+                   "Number of events above which a bucket is spread over a finer rung",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::SetBucketThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (std::numeric_limits<uint64_t>::max ()),
+    m_topMax (0),
+    m_topStart (0),
+    m_rungs (MAX_RUNGS),
+    m_nRungs (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+  SetBucketThreshold (50);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LadderScheduler::SetBucketThreshold (uint32_t threshold)
+{
+  NS_LOG_FUNCTION (this << threshold);
+  m_threshold = threshold;
+  m_bottomLimit = 4 * threshold;
+}
+
+uint64_t
+LadderScheduler::Boundary (const Rung &rung) const
+{
+  return rung.start + rung.cur * rung.width;
+}
+
+LadderScheduler::Rung &
+LadderScheduler::NewRung (uint64_t start, uint64_t width, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << start << width << n);
+  NS_ASSERT (m_nRungs < MAX_RUNGS);
+  NS_ASSERT (width > 0 && n > 0);
+  uint64_t nBuckets = std::min<uint64_t> (n, width);
+  Rung &rung = m_rungs[m_nRungs++];
+  rung.start = start;
+  rung.width = (width + nBuckets - 1) / nBuckets;
+  rung.nBuckets = static_cast<uint32_t> (nBuckets);
+  rung.cur = 0;
+  if (rung.buckets.size () < nBuckets)
+    {
+      rung.buckets.resize (nBuckets);
+    }
+  return rung;
+}
+
+void
+LadderScheduler::Spread (Rung &rung, Bucket &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      uint64_t index = (i->key.m_ts - rung.start) / rung.width;
+      NS_ASSERT (index >= rung.cur && index < rung.nBuckets);
+      rung.buckets[index].push_back (*i);
+    }
+  events.clear ();
+}
+
+void
+LadderScheduler::SortIntoBottom (Bucket &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  NS_ASSERT (m_bottom.empty ());
+  // Swap rather than copy: the vectors' capacities keep circulating between tiers
+  m_bottom.swap (events);
+  std::sort (m_bottom.begin (), m_bottom.end (), IsLater);
+  // Let the Bottom double before it is spread again, which keeps the spreading amortized
+  m_bottomLimit = std::max<uint32_t> (4 * m_threshold, 2 * m_bottom.size ());
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          if (m_top.empty ())
+            {
+              return;
+            }
+          if (m_top.size () <= m_threshold)
+            {
+              m_topStart = m_topMax + 1;
+              SortIntoBottom (m_top);
+            }
+          else
+            {
+              Rung &rung = NewRung (m_topMin, m_topMax - m_topMin + 1, m_top.size ());
+              m_topStart = rung.start + rung.nBuckets * rung.width;
+              Spread (rung, m_top);
+            }
+          m_topMin = std::numeric_limits<uint64_t>::max ();
+          m_topMax = 0;
+          continue;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.cur < rung.nBuckets && rung.buckets[rung.cur].empty ())
+        {
+          rung.cur++;
+        }
+      if (rung.cur == rung.nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+      Bucket &bucket = rung.buckets[rung.cur];
+      uint64_t bucketStart = Boundary (rung);
+      rung.cur++;
+      if (bucket.size () > m_threshold && rung.width > 1 && m_nRungs < MAX_RUNGS)
+        {
+          Rung &child = NewRung (bucketStart, rung.width, bucket.size ());
+          Spread (child, bucket);
+        }
+      else
+        {
+          SortIntoBottom (bucket);
+        }
+    }
+}
+
+bool
+LadderScheduler::RemoveFrom (Bucket &bucket, const Scheduler::Event &ev)
+{
+  for (Bucket::iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      if (*i == ev)
+        {
+          *i = bucket.back ();
+          bucket.pop_back ();
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LadderScheduler::Insert (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  m_size++;
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      Refill ();
+      return;
+    }
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= Boundary (rung))
+        {
+          uint64_t index = (ts - rung.start) / rung.width;
+          NS_ASSERT (index < rung.nBuckets);
+          rung.buckets[index].push_back (ev);
+          return;
+        }
+    }
+  m_bottom.insert (std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, IsLater), ev);
+  if (m_bottom.size () > m_bottomLimit && m_nRungs < MAX_RUNGS
+      && m_bottom.front ().key.m_ts != m_bottom.back ().key.m_ts)
+    {
+      // Too many near-future events for a sorted insert: spread the Bottom over a new deepest rung
+      uint64_t end = (m_nRungs == 0) ? m_topStart : Boundary (m_rungs[m_nRungs - 1]);
+      uint64_t start = m_bottom.back ().key.m_ts;
+      Rung &rung = NewRung (start, end - start, m_bottom.size ());
+      Spread (rung, m_bottom);
+      Refill ();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_bottom.empty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_bottom.empty ());
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_size--;
+  if (m_size == 0)
+    {
+      // Every bucket is empty, restart from scratch rather than keep a stale ladder
+      m_nRungs = 0;
+      m_topStart = 0;
+    }
+  else
+    {
+      Refill ();
+    }
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  bool found = false;
+  if (ts >= m_topStart)
+    {
+      // m_topMin and m_topMax remain valid, if loose, bounds
+      found = RemoveFrom (m_top, ev);
+    }
+  else
+    {
+      uint32_t i = 0;
+      while (i < m_nRungs && ts < Boundary (m_rungs[i]))
+        {
+          i++;
+        }
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          found = RemoveFrom (rung.buckets[(ts - rung.start) / rung.width], ev);
+        }
+      else
+        {
+          Bucket::iterator it = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, IsLater);
+          if (it != m_bottom.end () && *it == ev)
+            {
+              m_bottom.erase (it);
+              found = true;
+            }
+        }
+    }
+  NS_ASSERT_MSG (found, "Event not found in the LadderScheduler");
+  NS_UNUSED (found);
+  m_size--;
+  if (m_size == 0)
+    {
+      m_nRungs = 0;
+      m_topStart = 0;
+    }
+  else
+    {
+      Refill ();
+    }
+}
+
+} // namespace ns3
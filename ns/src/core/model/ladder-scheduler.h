@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This is a variant of the Ladder Queue of Tang, Goh and Thng
+ * ("Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation", ACM TOMACS 15(3), 2005).
+ * Events live in one of three tiers:
+ *
+ *  - Top: an unsorted `std::vector` holding all events at or beyond
+ *    the end of the ladder.  Far-future events only pay a `push_back`.
+ *  - Ladder: up to eight rungs of buckets.  Each bucket is an unsorted
+ *    `std::vector`.  When the Bottom runs dry, the Top is spread over
+ *    a new rung whose bucket width is the mean event spacing; a bucket
+ *    holding more than \c BucketThreshold events is in turn spread over
+ *    a finer rung, until buckets are small enough to be sorted.
+ *  - Bottom: a small `std::vector` sorted in descending order, so the
+ *    next event is removed from its back.
+ *
+ * Rung and bucket vectors are kept across refills, so in steady state
+ * the scheduler does not allocate at all.  Near-future and periodic
+ * events (link serialization, timers) land in already sized buckets,
+ * which is where this scheduler beats the tree and heap based ones.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Constant        | Append to Top or bucket; small sorted insert into Bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Bottom kept sorted
+ * Remove()     | Linear in bucket | Search within the owning tier
+ * RemoveNext() | Constant        | Each event is moved a bounded number of times
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | Rung bucket arrays               | Reused across refills
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Bucket type: unsorted events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** One rung of the ladder. */
+  struct Rung
+  {
+    uint64_t start;              /**< Timestamp of the start of bucket 0. */
+    uint64_t width;              /**< Bucket width. */
+    uint32_t nBuckets;           /**< Number of buckets in use. */
+    uint32_t cur;                /**< Index of the first bucket not yet transferred. */
+    std::vector<Bucket> buckets; /**< Buckets, never shrunk. */
+  };
+
+  /** Maximum number of rungs. */
+  static const uint32_t MAX_RUNGS = 8;
+
+  /**
+   * Get the first timestamp still held by a rung.
+   *
+   * \param [in] rung The rung.
+   * \returns The start of the first bucket not yet transferred.
+   */
+  inline uint64_t Boundary (const Rung &rung) const;
+  /**
+   * Start a new (deepest) rung spanning \pname{width} ticks
+   * from \pname{start} with about \pname{n} buckets.
+   *
+   * \param [in] start The first timestamp covered.
+   * \param [in] width The span covered.
+   * \param [in] n The number of events to be spread over the rung.
+   * \returns The new rung.
+   */
+  Rung & NewRung (uint64_t start, uint64_t width, std::size_t n);
+  /**
+   * Spread events over a rung.
+   *
+   * \param [in,out] rung The rung.
+   * \param [in,out] events The events, cleared on return.
+   */
+  void Spread (Rung &rung, Bucket &events);
+  /**
+   * Sort events into the (empty) Bottom.
+   *
+   * \param [in,out] events The events, cleared on return.
+   */
+  void SortIntoBottom (Bucket &events);
+  /** Refill the Bottom from the ladder or the Top, if it is empty. */
+  void Refill (void);
+  /**
+   * Remove an event from an unsorted bucket.
+   *
+   * \param [in,out] bucket The bucket.
+   * \param [in] ev The event to remove.
+   * \returns \c true if the event was found.
+   */
+  bool RemoveFrom (Bucket &bucket, const Scheduler::Event &ev);
+  /**
+   * Set the bucket threshold.
+   *
+   * \param [in] threshold Number of events above which a bucket is spread over a new rung.
+   */
+  void SetBucketThreshold (uint32_t threshold);
+
+  /** Top: events at or after \c m_topStart. */
+  Bucket m_top;
+  /** Smallest timestamp in the Top. */
+  uint64_t m_topMin;
+  /** Largest timestamp in the Top. */
+  uint64_t m_topMax;
+  /** Events at or after this timestamp go to the Top. */
+  uint64_t m_topStart;
+  /** The rungs, rung 0 being the coarsest. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Bottom: sorted in descending order. */
+  Bucket m_bottom;
+  /** Number of events in the Bottom above which it is spread over a new rung. */
+  uint32_t m_bottomLimit;
+  /** Number of events above which a bucket is spread over a new rung. */
+  uint32_t m_threshold;
+  /** Total number of events. */
+  uint64_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
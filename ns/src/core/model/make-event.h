@@ -317,6 +317,8 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
 #include "event-impl.h"
 #include "type-traits.h"
 
+#include <utility>
+
 namespace ns3 {
 
 /**
@@ -363,7 +365,7 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
   {
   public:
     EventMemberImpl0 (OBJ obj, MEM function)
-      : m_obj (obj),
+      : m_obj (std::forward<OBJ> (obj)),
         m_function (function)
     {}
     virtual ~EventMemberImpl0 ()
@@ -376,7 +378,7 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
     }
     OBJ m_obj;
     MEM m_function;
-  } *ev = new EventMemberImpl0 (obj, mem_ptr);
+  } *ev = new EventMemberImpl0 (std::forward<OBJ> (obj), mem_ptr);
   return ev;
 }
 
@@ -390,9 +392,9 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1)
   {
   public:
     EventMemberImpl1 (OBJ obj, MEM function, T1 a1)
-      : m_obj (obj),
+      : m_obj (std::forward<OBJ> (obj)),
         m_function (function),
-        m_a1 (a1)
+        m_a1 (std::forward<T1> (a1))
     {}
 
   protected:
@@ -407,7 +409,7 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1)
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
-  } *ev = new EventMemberImpl1 (obj, mem_ptr, a1);
+  } *ev = new EventMemberImpl1 (std::forward<OBJ> (obj), mem_ptr, std::forward<T1> (a1));
   return ev;
 }
 
@@ -420,10 +422,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
   {
   public:
     EventMemberImpl2 (OBJ obj, MEM function, T1 a1, T2 a2)
-      : m_obj (obj),
+      : m_obj (std::forward<OBJ> (obj)),
         m_function (function),
-        m_a1 (a1),
-        m_a2 (a2)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2))
     {}
 
   protected:
@@ -439,7 +441,9 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
-  } *ev = new EventMemberImpl2 (obj, mem_ptr, a1, a2);
+  } *ev = new EventMemberImpl2 (std::forward<OBJ> (obj), mem_ptr,
+                                std::forward<T1> (a1),
+                                std::forward<T2> (a2));
   return ev;
 }
 
@@ -452,11 +456,11 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
   {
   public:
     EventMemberImpl3 (OBJ obj, MEM function, T1 a1, T2 a2, T3 a3)
-      : m_obj (obj),
+      : m_obj (std::forward<OBJ> (obj)),
         m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3))
     {}
 
   protected:
@@ -473,7 +477,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
     typename TypeTraits<T3>::ReferencedType m_a3;
-  } *ev = new EventMemberImpl3 (obj, mem_ptr, a1, a2, a3);
+  } *ev = new EventMemberImpl3 (std::forward<OBJ> (obj), mem_ptr,
+                                std::forward<T1> (a1),
+                                std::forward<T2> (a2),
+                                std::forward<T3> (a3));
   return ev;
 }
 
@@ -486,12 +493,12 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4)
   {
   public:
     EventMemberImpl4 (OBJ obj, MEM function, T1 a1, T2 a2, T3 a3, T4 a4)
-      : m_obj (obj),
+      : m_obj (std::forward<OBJ> (obj)),
         m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3),
-        m_a4 (a4)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3)),
+        m_a4 (std::forward<T4> (a4))
     {}
 
   protected:
@@ -509,7 +516,11 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4)
     typename TypeTraits<T2>::ReferencedType m_a2;
     typename TypeTraits<T3>::ReferencedType m_a3;
     typename TypeTraits<T4>::ReferencedType m_a4;
-  } *ev = new EventMemberImpl4 (obj, mem_ptr, a1, a2, a3, a4);
+  } *ev = new EventMemberImpl4 (std::forward<OBJ> (obj), mem_ptr,
+                                std::forward<T1> (a1),
+                                std::forward<T2> (a2),
+                                std::forward<T3> (a3),
+                                std::forward<T4> (a4));
   return ev;
 }
 
@@ -523,13 +534,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
   {
   public:
     EventMemberImpl5 (OBJ obj, MEM function, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
-      : m_obj (obj),
+      : m_obj (std::forward<OBJ> (obj)),
         m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3),
-        m_a4 (a4),
-        m_a5 (a5)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3)),
+        m_a4 (std::forward<T4> (a4)),
+        m_a5 (std::forward<T5> (a5))
     {}
 
   protected:
@@ -548,7 +559,12 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     typename TypeTraits<T3>::ReferencedType m_a3;
     typename TypeTraits<T4>::ReferencedType m_a4;
     typename TypeTraits<T5>::ReferencedType m_a5;
-  } *ev = new EventMemberImpl5 (obj, mem_ptr, a1, a2, a3, a4, a5);
+  } *ev = new EventMemberImpl5 (std::forward<OBJ> (obj), mem_ptr,
+                                std::forward<T1> (a1),
+                                std::forward<T2> (a2),
+                                std::forward<T3> (a3),
+                                std::forward<T4> (a4),
+                                std::forward<T5> (a5));
   return ev;
 }
 
@@ -562,14 +578,14 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
   {
   public:
     EventMemberImpl6 (OBJ obj, MEM function, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6)
-      : m_obj (obj),
+      : m_obj (std::forward<OBJ> (obj)),
         m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3),
-        m_a4 (a4),
-        m_a5 (a5),
-        m_a6 (a6)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3)),
+        m_a4 (std::forward<T4> (a4)),
+        m_a5 (std::forward<T5> (a5)),
+        m_a6 (std::forward<T6> (a6))
     {}
 
   protected:
@@ -589,7 +605,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     typename TypeTraits<T4>::ReferencedType m_a4;
     typename TypeTraits<T5>::ReferencedType m_a5;
     typename TypeTraits<T6>::ReferencedType m_a6;
-  } *ev = new EventMemberImpl6 (obj, mem_ptr, a1, a2, a3, a4, a5, a6);
+  } *ev = new EventMemberImpl6 (std::forward<OBJ> (obj), mem_ptr,
+                                std::forward<T1> (a1),
+                                std::forward<T2> (a2),
+                                std::forward<T3> (a3),
+                                std::forward<T4> (a4),
+                                std::forward<T5> (a5),
+                                std::forward<T6> (a6));
   return ev;
 }
 
@@ -604,7 +626,7 @@ EventImpl * MakeEvent (void (*f)(U1), T1 a1)
 
     EventFunctionImpl1 (F function, T1 a1)
       : m_function (function),
-        m_a1 (a1)
+        m_a1 (std::forward<T1> (a1))
     {}
 
   protected:
@@ -618,7 +640,7 @@ EventImpl * MakeEvent (void (*f)(U1), T1 a1)
     }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
-  } *ev = new EventFunctionImpl1 (f, a1);
+  } *ev = new EventFunctionImpl1 (f, std::forward<T1> (a1));
   return ev;
 }
 
@@ -633,8 +655,8 @@ EventImpl * MakeEvent (void (*f)(U1,U2), T1 a1, T2 a2)
 
     EventFunctionImpl2 (F function, T1 a1, T2 a2)
       : m_function (function),
-        m_a1 (a1),
-        m_a2 (a2)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2))
     {}
 
   protected:
@@ -649,7 +671,7 @@ EventImpl * MakeEvent (void (*f)(U1,U2), T1 a1, T2 a2)
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
-  } *ev = new EventFunctionImpl2 (f, a1, a2);
+  } *ev = new EventFunctionImpl2 (f, std::forward<T1> (a1), std::forward<T2> (a2));
   return ev;
 }
 
@@ -665,9 +687,9 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3), T1 a1, T2 a2, T3 a3)
 
     EventFunctionImpl3 (F function, T1 a1, T2 a2, T3 a3)
       : m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3))
     {}
 
   protected:
@@ -683,7 +705,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3), T1 a1, T2 a2, T3 a3)
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
     typename TypeTraits<T3>::ReferencedType m_a3;
-  } *ev = new EventFunctionImpl3 (f, a1, a2, a3);
+  } *ev = new EventFunctionImpl3 (f,
+                                  std::forward<T1> (a1),
+                                  std::forward<T2> (a2),
+                                  std::forward<T3> (a3));
   return ev;
 }
 
@@ -699,10 +724,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4), T1 a1, T2 a2, T3 a3, T4 a4)
 
     EventFunctionImpl4 (F function, T1 a1, T2 a2, T3 a3, T4 a4)
       : m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3),
-        m_a4 (a4)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3)),
+        m_a4 (std::forward<T4> (a4))
     {}
 
   protected:
@@ -719,7 +744,11 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4), T1 a1, T2 a2, T3 a3, T4 a4)
     typename TypeTraits<T2>::ReferencedType m_a2;
     typename TypeTraits<T3>::ReferencedType m_a3;
     typename TypeTraits<T4>::ReferencedType m_a4;
-  } *ev = new EventFunctionImpl4 (f, a1, a2, a3, a4);
+  } *ev = new EventFunctionImpl4 (f,
+                                  std::forward<T1> (a1),
+                                  std::forward<T2> (a2),
+                                  std::forward<T3> (a3),
+                                  std::forward<T4> (a4));
   return ev;
 }
 
@@ -735,11 +764,11 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
 
     EventFunctionImpl5 (F function, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
       : m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3),
-        m_a4 (a4),
-        m_a5 (a5)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3)),
+        m_a4 (std::forward<T4> (a4)),
+        m_a5 (std::forward<T5> (a5))
     {}
 
   protected:
@@ -757,7 +786,12 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
     typename TypeTraits<T3>::ReferencedType m_a3;
     typename TypeTraits<T4>::ReferencedType m_a4;
     typename TypeTraits<T5>::ReferencedType m_a5;
-  } *ev = new EventFunctionImpl5 (f, a1, a2, a3, a4, a5);
+  } *ev = new EventFunctionImpl5 (f,
+                                  std::forward<T1> (a1),
+                                  std::forward<T2> (a2),
+                                  std::forward<T3> (a3),
+                                  std::forward<T4> (a4),
+                                  std::forward<T5> (a5));
   return ev;
 }
 
@@ -773,12 +807,12 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
 
     EventFunctionImpl6 (F function, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6)
       : m_function (function),
-        m_a1 (a1),
-        m_a2 (a2),
-        m_a3 (a3),
-        m_a4 (a4),
-        m_a5 (a5),
-        m_a6 (a6)
+        m_a1 (std::forward<T1> (a1)),
+        m_a2 (std::forward<T2> (a2)),
+        m_a3 (std::forward<T3> (a3)),
+        m_a4 (std::forward<T4> (a4)),
+        m_a5 (std::forward<T5> (a5)),
+        m_a6 (std::forward<T6> (a6))
     {}
 
   protected:
@@ -797,7 +831,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
     typename TypeTraits<T4>::ReferencedType m_a4;
     typename TypeTraits<T5>::ReferencedType m_a5;
     typename TypeTraits<T6>::ReferencedType m_a6;
-  } *ev = new EventFunctionImpl6 (f, a1, a2, a3, a4, a5, a6);
+  } *ev = new EventFunctionImpl6 (f,
+                                  std::forward<T1> (a1),
+                                  std::forward<T2> (a2),
+                                  std::forward<T3> (a3),
+                                  std::forward<T4> (a4),
+                                  std::forward<T5> (a5),
+                                  std::forward<T6> (a6));
   return ev;
 }
 
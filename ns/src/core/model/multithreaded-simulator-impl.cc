@@ -0,0 +1,724 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "simulator.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+#include "rng-seed-manager.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** Time step value standing for "no event". */
+const uint64_t NEVER = 0x7fffffffffffffffULL;
+/** Size, in bits, of the range of automatic RNG stream indices of a partition. */
+const uint32_t STREAM_RANGE_BITS = 48;
+
+} // unnamed namespace
+
+thread_local MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::m_current = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_nPartitions (1),
+    m_lookahead (NEVER),
+    m_windowEnd (0),
+    m_windowEndUid (0),
+    m_nWindows (0),
+    m_stop (false),
+    m_windowGeneration (0),
+    m_busy (0),
+    m_exit (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_global = new Partition ();
+  m_global->index = 0;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_global->uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_global->currentUid = 0;
+  m_global->currentTs = 0;
+  m_global->currentContext = Simulator::NO_CONTEXT;
+  m_global->eventCount = 0;
+  m_global->unscheduledEvents = 0;
+  m_mainThread = std::this_thread::get_id ();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      delete *i;
+    }
+  delete m_global;
+}
+
+void
+MultithreadedSimulatorImpl::DrainEvents (Partition *p)
+{
+  for (std::vector<std::vector<Message> >::iterator box = p->outbox.begin (); box != p->outbox.end (); ++box)
+    {
+      for (std::vector<Message>::iterator m = box->begin (); m != box->end (); ++m)
+        {
+          m->event->Unref ();
+        }
+      box->clear ();
+    }
+  if (p->events != 0)
+    {
+      while (!p->events->IsEmpty ())
+        {
+          Scheduler::Event next = p->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      p->events = 0;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  ProcessEventsWithContext ();
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      DrainEvents (*i);
+    }
+  DrainEvents (m_global);
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetPartitions (const std::vector<uint32_t> &partitions, Time lookahead)
+{
+  NS_LOG_FUNCTION (this << partitions.size () << lookahead);
+  NS_ABORT_MSG_IF (!m_partitions.empty (), "The partitions must be set before the simulation runs");
+  NS_ABORT_MSG_IF (!lookahead.IsStrictlyPositive (), "The lookahead must be positive");
+  m_partitionOf = partitions;
+  m_nPartitions = 1;
+  for (std::vector<uint32_t>::const_iterator i = partitions.begin (); i != partitions.end (); ++i)
+    {
+      m_nPartitions = std::max (m_nPartitions, *i + 1);
+    }
+  m_lookahead = lookahead.GetTimeStep ();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions (void) const
+{
+  return m_nPartitions;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return TimeStep (m_lookahead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNWindows (void) const
+{
+  return m_nWindows;
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  std::vector<Partition *> all = m_partitions;
+  all.push_back (m_global);
+  for (std::vector<Partition *>::iterator i = all.begin (); i != all.end (); ++i)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if ((*i)->events != 0)
+        {
+          while (!(*i)->events->IsEmpty ())
+            {
+              scheduler->Insert ((*i)->events->RemoveNext ());
+            }
+        }
+      (*i)->events = scheduler;
+    }
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == Simulator::NO_CONTEXT || m_partitions.empty ())
+    {
+      return m_global;
+    }
+  if (context < m_partitionOf.size ())
+    {
+      return m_partitions[m_partitionOf[context]];
+    }
+  return m_partitions[0];
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  // The automatic stream indices end at 2^63
+  NS_ABORT_MSG_IF (m_nPartitions >= (1U << (63 - STREAM_RANGE_BITS)), "Too many partitions");
+  for (uint32_t i = 0; i < m_nPartitions; ++i)
+    {
+      Partition *p = new Partition ();
+      p->index = i;
+      p->events = m_schedulerFactory.Create<Scheduler> ();
+      // Keep clear of the uids already handed out by the main thread
+      p->uid = m_global->uid;
+      p->currentUid = 0;
+      p->currentTs = m_global->currentTs;
+      p->currentContext = Simulator::NO_CONTEXT;
+      p->eventCount = 0;
+      p->unscheduledEvents = 0;
+      // Streams in a range of its own, above those of the main thread,
+      // in an order which does not depend on the other partitions
+      p->nextStream = static_cast<uint64_t> (i + 1) << STREAM_RANGE_BITS;
+      p->outbox.resize (m_nPartitions + 1);
+      m_partitions.push_back (p);
+    }
+
+  // Move the events scheduled so far to their partition, keeping their
+  // keys so that the EventIds given out stay valid.
+  std::vector<Scheduler::Event> pending;
+  while (!m_global->events->IsEmpty ())
+    {
+      pending.push_back (m_global->events->RemoveNext ());
+    }
+  m_global->unscheduledEvents = 0;
+  for (std::vector<Scheduler::Event>::const_iterator i = pending.begin (); i != pending.end (); ++i)
+    {
+      Partition *p = GetPartition (i->key.m_context);
+      p->events->Insert (*i);
+      p->unscheduledEvents++;
+    }
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert (Partition *p, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = p->uid;
+  p->uid++;
+  p->unscheduledEvents++;
+  p->events->Insert (ev);
+  return ev.key;
+}
+
+void
+MultithreadedSimulatorImpl::DeliverMessages (void)
+{
+  // Sources in partition order, each mailbox in send order: the
+  // delivery order, and therefore the uids, do not depend on the
+  // thread interleaving.
+  for (std::vector<Partition *>::iterator src = m_partitions.begin (); src != m_partitions.end (); ++src)
+    {
+      for (uint32_t dst = 0; dst <= m_nPartitions; ++dst)
+        {
+          std::vector<Message> &box = (*src)->outbox[dst];
+          if (box.empty ())
+            {
+              continue;
+            }
+          Partition *p = dst < m_nPartitions ? m_partitions[dst] : m_global;
+          for (std::vector<Message>::const_iterator m = box.begin (); m != box.end (); ++m)
+            {
+              Insert (p, m->ts, m->context, m->event);
+            }
+          box.clear ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessEventsWithContext (void)
+{
+  std::list<EventWithContext> eventsWithContext;
+  {
+    std::lock_guard<std::mutex> lock (m_listMutex);
+    if (m_eventsWithContext.empty ())
+      {
+        return;
+      }
+    m_eventsWithContext.swap (eventsWithContext);
+  }
+  for (std::list<EventWithContext>::const_iterator i = eventsWithContext.begin (); i != eventsWithContext.end (); ++i)
+    {
+      Insert (GetPartition (i->context), m_global->currentTs + i->timestamp, i->context, i->event);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *p)
+{
+  Scheduler::Event next = p->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= p->currentTs);
+  p->unscheduledEvents--;
+  p->eventCount++;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  p->currentTs = next.key.m_ts;
+  p->currentContext = next.key.m_context;
+  p->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow (Partition *p)
+{
+  m_current = p;
+  RngSeedManager::SetThreadStreamIndex (&p->nextStream);
+  while (!p->events->IsEmpty () && !m_stop.load (std::memory_order_relaxed))
+    {
+      const Scheduler::EventKey &key = p->events->PeekNext ().key;
+      if (key.m_ts > m_windowEnd || (key.m_ts == m_windowEnd && key.m_uid >= m_windowEndUid))
+        {
+          break;
+        }
+      ProcessOneEvent (p);
+    }
+  RngSeedManager::SetThreadStreamIndex (0);
+  m_current = 0;
+}
+
+void
+MultithreadedSimulatorImpl::Worker (Partition *p)
+{
+  uint64_t generation = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_windowMutex);
+        m_windowStart.wait (lock, [this, generation] () {
+                              return m_exit || m_windowGeneration != generation;
+                            });
+        if (m_exit)
+          {
+            return;
+          }
+        generation = m_windowGeneration;
+      }
+      RunWindow (p);
+      {
+        std::lock_guard<std::mutex> lock (m_windowMutex);
+        if (--m_busy == 0)
+          {
+            m_windowDone.notify_one ();
+          }
+      }
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  if (!m_global->events->IsEmpty ())
+    {
+      return false;
+    }
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_mainThread = std::this_thread::get_id ();
+  if (m_partitions.empty ())
+    {
+      CreatePartitions ();
+    }
+  ProcessEventsWithContext ();
+  m_stop = false;
+
+  {
+    std::lock_guard<std::mutex> lock (m_windowMutex);
+    m_exit = false;
+  }
+  for (uint32_t i = 1; i < m_nPartitions; ++i)
+    {
+      m_threads.push_back (std::thread (&MultithreadedSimulatorImpl::Worker, this, m_partitions[i]));
+    }
+
+  while (!m_stop)
+    {
+      DeliverMessages ();
+      ProcessEventsWithContext ();
+
+      // As in DefaultSimulatorImpl, the events at the same time run in uid
+      // order, the NO_CONTEXT ones included: those scheduled before Run
+      // share the uids of the main thread.
+      Scheduler::EventKey next;
+      next.m_ts = NEVER;
+      next.m_uid = 0;
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          if (!(*i)->events->IsEmpty () && (*i)->events->PeekNext ().key < next)
+            {
+              next = (*i)->events->PeekNext ().key;
+            }
+        }
+      Scheduler::EventKey nextGlobal;
+      nextGlobal.m_ts = NEVER;
+      nextGlobal.m_uid = 0;
+      if (!m_global->events->IsEmpty ())
+        {
+          nextGlobal = m_global->events->PeekNext ().key;
+        }
+      if (next.m_ts == NEVER && nextGlobal.m_ts == NEVER)
+        {
+          break;
+        }
+      if (nextGlobal < next)
+        {
+          // Every partition is at or before nextGlobal
+          ProcessOneEvent (m_global);
+          continue;
+        }
+
+      m_windowEnd = next.m_ts + std::min (m_lookahead, NEVER - next.m_ts);
+      m_windowEndUid = 0;
+      if (nextGlobal.m_ts <= m_windowEnd)
+        {
+          m_windowEnd = nextGlobal.m_ts;
+          m_windowEndUid = nextGlobal.m_uid;
+        }
+      m_nWindows++;
+      {
+        std::lock_guard<std::mutex> lock (m_windowMutex);
+        m_busy = m_nPartitions - 1;
+        m_windowGeneration++;
+      }
+      m_windowStart.notify_all ();
+      RunWindow (m_partitions[0]);
+      {
+        std::unique_lock<std::mutex> lock (m_windowMutex);
+        m_windowDone.wait (lock, [this] () {
+                             return m_busy == 0;
+                           });
+      }
+      // Events run from main between windows follow the partitions
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          m_global->currentTs = std::max (m_global->currentTs, (*i)->currentTs);
+        }
+    }
+
+  {
+    std::lock_guard<std::mutex> lock (m_windowMutex);
+    m_exit = true;
+  }
+  m_windowStart.notify_all ();
+  for (std::vector<std::thread>::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      i->join ();
+    }
+  m_threads.clear ();
+  // A stop leaves messages behind, keep them for the next Run
+  DeliverMessages ();
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (m_current != 0 || std::this_thread::get_id () == m_mainThread,
+                 "Simulator::Schedule Thread-unsafe invocation!");
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+  Partition *p = Current ();
+  Scheduler::EventKey key = Insert (p, p->currentTs + delay.GetTimeStep (), p->currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  Partition *src = m_current;
+  if (src == 0)
+    {
+      if (std::this_thread::get_id () != m_mainThread)
+        {
+          EventWithContext ev;
+          ev.context = context;
+          // Current time added in ProcessEventsWithContext()
+          ev.timestamp = delay.GetTimeStep ();
+          ev.event = event;
+          std::lock_guard<std::mutex> lock (m_listMutex);
+          m_eventsWithContext.push_back (ev);
+          return;
+        }
+      // Main thread, no window running: any event list can be written
+      Insert (GetPartition (context), m_global->currentTs + delay.GetTimeStep (), context, event);
+      return;
+    }
+
+  uint64_t ts = src->currentTs + delay.GetTimeStep ();
+  Partition *dst = GetPartition (context);
+  if (dst == src)
+    {
+      Insert (src, ts, context, event);
+      return;
+    }
+  if (ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("Event for context " << context << " scheduled by partition " << src->index
+                      << " at " << TimeStep (src->currentTs).As (Time::S)
+                      << " with delay " << delay.As (Time::S)
+                      << ", below the lookahead " << GetLookahead ().As (Time::S));
+    }
+  Message m;
+  m.ts = ts;
+  m.context = context;
+  m.event = event;
+  src->outbox[dst == m_global ? m_nPartitions : dst->index].push_back (m);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  NS_ASSERT_MSG (m_current != 0 || std::this_thread::get_id () == m_mainThread,
+                 "Simulator::ScheduleNow Thread-unsafe invocation!");
+
+  Partition *p = Current ();
+  Scheduler::EventKey key = Insert (p, p->currentTs, p->currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Current ()->currentTs, 0xffffffff, 2);
+  std::lock_guard<std::mutex> lock (m_listMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (Current ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - Current ()->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_listMutex);
+      for (std::list<EventId>::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *p = GetPartition (id.GetContext ());
+  NS_ASSERT_MSG (m_current == 0 || m_current == p,
+                 "Simulator::Remove of an event owned by another partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  p->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  p->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events, which other partitions may be adding or removing.
+      std::lock_guard<std::mutex> lock (m_listMutex);
+      for (std::list<EventId>::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  const Partition *p = GetPartition (id.GetContext ());
+  if (id.PeekEventImpl () == 0
+      || id.GetTs () < p->currentTs
+      || (id.GetTs () == p->currentTs && id.GetUid () <= p->currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return m_current != 0 ? m_current->index : 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return Current ()->currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = m_global->eventCount;
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      count += (*i)->eventCount;
+    }
+  return count;
+}
+
+} // namespace ns3
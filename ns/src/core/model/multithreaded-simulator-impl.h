@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Shared memory parallel simulator, one thread per partition.
+ *
+ * The contexts (node ids) are split into partitions, each with its own
+ * event list, clock and thread.  Partitions advance in windows: all
+ * partitions run the events earlier than the smallest next event time
+ * plus the lookahead, then meet at a barrier.  The lookahead is a lower
+ * bound on the delay of any event one partition schedules for another,
+ * normally the smallest propagation delay of the channels joining two
+ * partitions, so no partition can receive an event for a time it has
+ * already passed.  MultithreadedSimulatorHelper computes the partitions
+ * and the lookahead from the topology.
+ *
+ * Events for another partition are appended to a mailbox owned by the
+ * sending partition and inserted into the destination event list at the
+ * barrier, so the send path takes no lock.  Scheduling an event for
+ * another partition closer than the lookahead is a fatal error.
+ *
+ * Events without a context (Simulator::NO_CONTEXT), which are typically
+ * the periodic statistics and progress events scheduled from \c main,
+ * are run by the main thread between windows, while every partition is
+ * stopped at exactly the time of the event.  They can therefore inspect
+ * the state of any node.
+ *
+ * Events scheduled before the partitions are set (before the first
+ * Run) are kept by the main thread and moved to their partitions when
+ * Run starts.  Events can only be removed or canceled from the
+ * partition which owns them, or between windows.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  /**
+   * Set the partitions, before the first Run.
+   *
+   * \param [in] partitions The partition of each context, indexed by
+   *             context.  Contexts beyond the end are in partition 0.
+   * \param [in] lookahead The smallest delay of an event scheduled by
+   *             one partition for another.
+   */
+  void SetPartitions (const std::vector<uint32_t> &partitions, Time lookahead);
+  /** \returns The number of partitions, and therefore of threads. */
+  uint32_t GetNPartitions (void) const;
+  /** \returns The lookahead. */
+  Time GetLookahead (void) const;
+  /** \returns The number of windows run so far. */
+  uint64_t GetNWindows (void) const;
+
+  // Inherited from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event sent to another partition, waiting for the barrier. */
+  struct Message
+  {
+    uint64_t ts;       /**< Absolute event time. */
+    uint32_t context;  /**< Event context. */
+    EventImpl *event;  /**< The event. */
+  };
+
+  /** The state of one partition, or of the main thread. */
+  struct Partition
+  {
+    uint32_t index;              /**< Partition index. */
+    Ptr<Scheduler> events;       /**< The event list. */
+    uint32_t uid;                /**< Next event uid. */
+    uint32_t currentUid;         /**< Uid of the current event. */
+    uint64_t currentTs;          /**< Time of the current event. */
+    uint32_t currentContext;     /**< Context of the current event. */
+    uint64_t eventCount;         /**< Number of events run. */
+    int unscheduledEvents;       /**< Number of events in the event list. */
+    uint64_t nextStream;         /**< Next RNG stream index of the objects created by the events. */
+    /** Mailboxes, indexed by destination partition. */
+    std::vector<std::vector<Message> > outbox;
+  };
+
+  /**
+   * \returns The partition of the calling thread, the main one
+   * outside of the parallel windows.
+   */
+  Partition * Current (void) const
+  {
+    return m_current != 0 ? m_current : m_global;
+  }
+  /**
+   * \param [in] context A context.
+   * \returns The partition owning the context.
+   */
+  Partition * GetPartition (uint32_t context) const;
+  /**
+   * Insert an event.
+   *
+   * \param [in] p The partition.
+   * \param [in] ts Absolute event time.
+   * \param [in] context Event context.
+   * \param [in] event The event.
+   * \returns The event key.
+   */
+  Scheduler::EventKey Insert (Partition *p, uint64_t ts, uint32_t context, EventImpl *event);
+  /**
+   * Run the next event of a partition.
+   * \param [in] p The partition.
+   */
+  void ProcessOneEvent (Partition *p);
+  /**
+   * Run the events of a partition up to the window end.
+   * \param [in] p The partition.
+   */
+  void RunWindow (Partition *p);
+  /**
+   * Thread body of a partition.
+   * \param [in] p The partition.
+   */
+  void Worker (Partition *p);
+  /** Create the partitions and move the pending events to them. */
+  void CreatePartitions (void);
+  /** Insert the mailbox contents into the destination event lists. */
+  void DeliverMessages (void);
+  /** Insert the events scheduled from other threads. */
+  void ProcessEventsWithContext (void);
+  /**
+   * Release the partition event lists.
+   * \param [in] p The partition.
+   */
+  void DrainEvents (Partition *p);
+
+  /** The partition run by the calling thread, during windows. */
+  static thread_local Partition *m_current;
+
+  /** The main thread state: events before Run, and NO_CONTEXT events. */
+  Partition *m_global;
+  /** The partitions, created on the first Run. */
+  std::vector<Partition *> m_partitions;
+  /** Partition of each context, as set by SetPartitions. */
+  std::vector<uint32_t> m_partitionOf;
+  /** Number of partitions to create. */
+  uint32_t m_nPartitions;
+  /** The lookahead, in time steps. */
+  uint64_t m_lookahead;
+  /** The events of the current window are those before this time. */
+  uint64_t m_windowEnd;
+  /**
+   * And those at m_windowEnd with a smaller uid, when the window ends at
+   * a NO_CONTEXT event which must follow them.
+   */
+  uint32_t m_windowEndUid;
+  /** Number of windows run. */
+  uint64_t m_nWindows;
+  /** The factory for the event lists. */
+  ObjectFactory m_schedulerFactory;
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+
+  /** The thread running Run. */
+  std::thread::id m_mainThread;
+  /** The partition threads, other than partition 0 which is run by Run. */
+  std::vector<std::thread> m_threads;
+  /** Protects the window hand-over. */
+  std::mutex m_windowMutex;
+  /** Signals the start of a window, or the exit, to the threads. */
+  std::condition_variable m_windowStart;
+  /** Signals the end of a window to Run. */
+  std::condition_variable m_windowDone;
+  /** Window counter, bumped to start a window. */
+  uint64_t m_windowGeneration;
+  /** Number of threads still running the current window. */
+  uint32_t m_busy;
+  /** Flag telling the threads to exit. */
+  bool m_exit;
+
+  /** Wrap an event with its execution context. */
+  struct EventWithContext
+  {
+    uint32_t context;    /**< The event context. */
+    uint64_t timestamp;  /**< The event delay. */
+    EventImpl *event;    /**< The event. */
+  };
+  /** Events scheduled from threads other than the simulation ones. */
+  std::list<EventWithContext> m_eventsWithContext;
+  /** Destroy events. */
+  std::list<EventId> m_destroyEvents;
+  /** Protects m_eventsWithContext and m_destroyEvents. */
+  mutable std::mutex m_listMutex;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
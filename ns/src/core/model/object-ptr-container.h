@@ -229,6 +229,17 @@ public:
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
 
+  /**
+   * Get one instance from the container, without copying the others
+   * into an ObjectPtrContainerValue as Get does.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the instance, as ObjectPtrContainerValue
+   *            would report it.
+   * \returns The instance, or 0 if there is none with this index.
+   */
+  Ptr<Object> GetElement (const ObjectBase *object, std::size_t index) const;
+
 private:
   /**
    * Get the number of instances in the container.
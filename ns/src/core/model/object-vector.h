@@ -25,6 +25,8 @@
 #include "attribute.h"
 #include "object-ptr-container.h"
 
+#include <iterator>
+
 /**
  * \file
  * \ingroup attribute_ObjectVector
@@ -95,21 +97,17 @@ MakeObjectVectorAccessor (U T::*memberVector)
     virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const
     {
       const T *obj = static_cast<const T *> (object);
-      typename U::const_iterator begin = (obj->*m_memberVector).begin ();
-      typename U::const_iterator end = (obj->*m_memberVector).end ();
-      std::size_t k = 0;
-      for (typename U::const_iterator j = begin; j != end; j++, k++)
+      if (i >= (obj->*m_memberVector).size ())
         {
-          if (k == i)
-            {
-              *index = k;
-              return *j;
-              break;
-            }
+          NS_ASSERT (false);
+          // quiet compiler.
+          return 0;
         }
-      NS_ASSERT (false);
-      // quiet compiler.
-      return 0;
+      // Constant time for random access containers such as std::vector
+      typename U::const_iterator j = (obj->*m_memberVector).begin ();
+      std::advance (j, i);
+      *index = i;
+      return *j;
     }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
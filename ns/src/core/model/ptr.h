@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <stdint.h>
+#include <utility>
 #include "assert.h"
 
 /**
@@ -85,8 +86,9 @@ private:
     void operator delete (void *);
   };
 
-  /** Interoperate with const instances. */
-  friend class Ptr<const T>;
+  /** Interoperate with const and base class instances. */
+  template <typename U>
+  friend class Ptr;
 
   /**
    * Get a permanent pointer to the underlying object.
@@ -155,6 +157,23 @@ public:
    */
   template <typename U>
   Ptr (Ptr<U> const &o);
+  /**
+   * Take over the reference of another Ptr, which becomes empty.
+   *
+   * Unlike a copy, this does not change the reference count.
+   *
+   * \param [in] o The other Ptr instance.
+   */
+  Ptr (Ptr &&o);
+  /**
+   * Take over the reference of a Ptr to a derived or non-\c const type,
+   * which becomes empty.
+   *
+   * \tparam U \deduced The type underlying the Ptr being moved.
+   * \param [in] o The Ptr to move.
+   */
+  template <typename U>
+  Ptr (Ptr<U> &&o);
   /** Destructor. */
   ~Ptr ();
   /**
@@ -164,6 +183,14 @@ public:
    * \return A reference to self.
    */
   Ptr<T> &operator = (Ptr const& o);
+  /**
+   * Assignment operator taking over the reference of another Ptr,
+   * which becomes empty.
+   *
+   * \param [in] o The other Ptr instance.
+   * \return A reference to self.
+   */
+  Ptr<T> &operator = (Ptr &&o);
   /**
    * An rvalue member access.
    * \returns A pointer to the underlying object.
@@ -616,6 +643,20 @@ Ptr<T>::Ptr (Ptr<U> const &o)
   Acquire ();
 }
 
+template <typename T>
+Ptr<T>::Ptr (Ptr &&o)
+  : m_ptr (o.m_ptr)
+{
+  o.m_ptr = 0;
+}
+template <typename T>
+template <typename U>
+Ptr<T>::Ptr (Ptr<U> &&o)
+  : m_ptr (o.m_ptr)
+{
+  o.m_ptr = 0;
+}
+
 template <typename T>
 Ptr<T>::~Ptr ()
 {
@@ -642,6 +683,21 @@ Ptr<T>::operator = (Ptr const& o)
   return *this;
 }
 
+template <typename T>
+Ptr<T> &
+Ptr<T>::operator = (Ptr &&o)
+{
+  // Detach o first, in case it belongs to the object released below
+  T *ptr = o.m_ptr;
+  o.m_ptr = 0;
+  if (m_ptr != 0)
+    {
+      m_ptr->Unref ();
+    }
+  m_ptr = ptr;
+  return *this;
+}
+
 template <typename T>
 T *
 Ptr<T>::operator -> ()
@@ -23,6 +23,9 @@
 #include "uinteger.h"
 #include "config.h"
 #include "log.h"
+#include "thread-local.h"
+
+#include <atomic>
 
 /**
  * \file
@@ -37,9 +40,15 @@ NS_LOG_COMPONENT_DEFINE ("RngSeedManager");
 /**
  * \relates RngSeedManager
  * The next random number generator stream number to use
- * for automatic assignment.
+ * for automatic assignment.  Atomic, since threads without a counter
+ * of their own may create objects concurrently.
+ */
+static std::atomic<uint64_t> g_nextStreamIndex (0);
+/**
+ * \relates RngSeedManager
+ * The counter of the calling thread set by SetThreadStreamIndex, if any.
  */
-static uint64_t g_nextStreamIndex = 0;
+static NS_THREAD_LOCAL uint64_t *g_threadStreamIndex = 0;
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -102,9 +111,16 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  uint64_t next = g_nextStreamIndex;
-  g_nextStreamIndex++;
-  return next;
+  if (g_threadStreamIndex != 0)
+    {
+      return (*g_threadStreamIndex)++;
+    }
+  return g_nextStreamIndex++;
+}
+
+void RngSeedManager::SetThreadStreamIndex (uint64_t *next)
+{
+  g_threadStreamIndex = next;
 }
 
 } // namespace ns3
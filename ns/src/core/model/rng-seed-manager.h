@@ -105,6 +105,14 @@ public:
    */
   static uint64_t GetNextStreamIndex (void);
 
+  /**
+   * Make the calling thread take the automatically assigned stream
+   * indices from its own counter, so that they do not depend on the
+   * interleaving with other threads.
+   * \param [in] next The counter, or null for the shared one.
+   */
+  static void SetThreadStreamIndex (uint64_t *next);
+
 };
 
 /** Alias for compatibility. */
@@ -0,0 +1,44 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_THREAD_LOCAL_H
+#define NS3_THREAD_LOCAL_H
+
+/**
+ * \file
+ * \ingroup core
+ * NS_THREAD_LOCAL macro definition.
+ */
+
+/**
+ * \ingroup core
+ * \def NS_THREAD_LOCAL
+ * Storage class of the per-thread state used on every packet or event.
+ *
+ * Code in a shared library reaches a plain \c thread_local variable
+ * through a call to \c __tls_get_addr.  With the initial-exec TLS model
+ * the variable is at a fixed offset from the thread pointer instead.
+ * This requires the library to be loaded with the program rather than
+ * opened later, or else to fit in the small static TLS reserve of the
+ * C library, so it is for a few bytes of state only.
+ */
+#if defined(__GNUC__) && defined(__ELF__)
+# define NS_THREAD_LOCAL thread_local __attribute__ ((tls_model ("initial-exec")))
+#else
+# define NS_THREAD_LOCAL thread_local
+#endif
+
+#endif /* NS3_THREAD_LOCAL_H */
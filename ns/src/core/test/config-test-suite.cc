@@ -840,6 +840,106 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test the resolution of plain indexes into large vectors of Object,
+ * and the connection of one sink per matched object.
+ */
+class IndexedPathConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  IndexedPathConfigTestCase ();
+  /** Destructor. */
+  virtual ~IndexedPathConfigTestCase ()
+  {}
+
+  /**
+   * Trace callback bound to the index of the traced object.
+   * \param index The object index.
+   * \param oldValue The old value.
+   * \param newValue The new value.
+   */
+  void Trace (uint32_t index, int16_t oldValue, int16_t newValue)
+  {
+    NS_UNUSED (oldValue);
+    m_index = index;
+    m_newValue = newValue;
+  }
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_index;   //!< Index bound to the last fired callback.
+  int16_t m_newValue; //!< Value of the last fired callback.
+};
+
+IndexedPathConfigTestCase::IndexedPathConfigTestCase ()
+  : TestCase ("Check indexed paths into large vectors of Object and per-object trace connections")
+{}
+
+void
+IndexedPathConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  a->SetNodeB (b);
+
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      b->AddNodeA (objects.back ());
+    }
+
+  Config::MatchContainer matches = Config::LookupMatches ("/NodeA/NodeB/NodesA/500");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Index 500 not found");
+  NS_TEST_EXPECT_MSG_EQ (matches.Get (0), objects[500], "Index 500 resolved to the wrong object");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetMatchedPath (0), "/NodeA/NodeB/NodesA/500/", "Wrong matched path");
+
+  matches = Config::LookupMatches ("/NodeA/NodeB/NodesA/0999");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Index 0999 not found");
+  NS_TEST_EXPECT_MSG_EQ (matches.Get (0), objects[999], "Index 0999 resolved to the wrong object");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetMatchedPath (0), "/NodeA/NodeB/NodesA/999/", "Index not canonicalized");
+
+  matches = Config::LookupMatches ("/NodeA/NodeB/NodesA/1000");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetN (), 0, "Index beyond the end found");
+
+  Config::Set ("/NodeA/NodeB/NodesA/7/A", IntegerValue (-7));
+  IntegerValue iv;
+  objects[7]->GetAttribute ("A", iv);
+  NS_TEST_EXPECT_MSG_EQ (iv.Get (), -7, "Object Attribute \"A\" not set through an index");
+  objects[8]->GetAttribute ("A", iv);
+  NS_TEST_EXPECT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+
+  //
+  // One sink per object, each bound to the index of its object.
+  //
+  matches = Config::LookupMatches ("/NodeA/NodeB/NodesA/[100-199]");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 100, "Wrong number of matches of the range");
+  std::vector<CallbackBase> sinks;
+  for (uint32_t i = 0; i < matches.GetN (); ++i)
+    {
+      sinks.push_back (MakeCallback (&IndexedPathConfigTestCase::Trace, this).Bind (100 + i));
+    }
+  matches.ConnectWithoutContext ("Source", sinks);
+
+  m_index = 0;
+  m_newValue = 0;
+  objects[150]->SetAttribute ("Source", IntegerValue (-5));
+  NS_TEST_EXPECT_MSG_EQ (m_index, 150, "The sink of another object fired");
+  NS_TEST_EXPECT_MSG_EQ (m_newValue, -5, "The sink did not fire");
+
+  m_index = 0;
+  objects[200]->SetAttribute ("Source", IntegerValue (-6));
+  NS_TEST_EXPECT_MSG_EQ (m_index, 0, "An object out of the range fired a sink");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -858,6 +958,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new IndexedPathConfigTestCase);
 }
 
 /**
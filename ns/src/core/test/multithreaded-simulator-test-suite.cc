@@ -0,0 +1,531 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+
+#include <set>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup tests
+ *
+ * Run the same event pattern with the DefaultSimulatorImpl and the
+ * MultithreadedSimulatorImpl, and check that every context sees its
+ * events at the same times, in the expected partition, and that the
+ * NO_CONTEXT events see the same global state.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] schedulerType The Scheduler TypeId name.
+   */
+  MultithreadedSimulatorTestCase (std::string schedulerType);
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Run the pattern.
+   * \param [in] simulatorType The SimulatorImpl TypeId name.
+   */
+  void RunPattern (std::string simulatorType);
+  /**
+   * Event of a context.
+   * \param [in] context The context.
+   * \param [in] n The event number in the local chain.
+   */
+  void Event (uint32_t context, uint32_t n);
+  /** Event without context, samples the state of every context. */
+  void Sample (void);
+
+  /** Number of contexts. */
+  static const uint32_t N_CONTEXTS = 4;
+  /** Length of the local event chains. */
+  static const uint32_t N_EVENTS = 50;
+
+  std::string m_schedulerType;                        //!< Scheduler TypeId name
+  std::vector<std::vector<uint64_t> > m_times;        //!< Event times of each context
+  std::vector<uint32_t> m_systemIds;                  //!< Last system id of each context
+  std::vector<uint64_t> m_samples;                    //!< Event count seen by Sample
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase (std::string schedulerType)
+  : TestCase ("Check the multithreaded simulator against the default one with " + schedulerType),
+    m_schedulerType (schedulerType)
+{}
+
+void
+MultithreadedSimulatorTestCase::Event (uint32_t context, uint32_t n)
+{
+  m_times[context].push_back (Simulator::Now ().GetNanoSeconds ());
+  m_systemIds[context] = Simulator::GetSystemId ();
+  if (n >= N_EVENTS)
+    {
+      return;
+    }
+  Simulator::Schedule (NanoSeconds (3000 + context * 100),
+                       &MultithreadedSimulatorTestCase::Event, this, context, n + 1);
+  if (n % 3 == 0)
+    {
+      // Across the partitions, no closer than the 10us lookahead
+      uint32_t peer = (context + 2) % N_CONTEXTS;
+      Simulator::ScheduleWithContext (peer, MicroSeconds (10) + NanoSeconds (context),
+                                      &MultithreadedSimulatorTestCase::Event, this, peer, N_EVENTS);
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Sample (void)
+{
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      count += m_times[i].size ();
+    }
+  m_samples.push_back (count);
+  Simulator::Schedule (MicroSeconds (20), &MultithreadedSimulatorTestCase::Sample, this);
+}
+
+void
+MultithreadedSimulatorTestCase::RunPattern (std::string simulatorType)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetGlobal ("SchedulerType", StringValue (m_schedulerType));
+  m_times.assign (N_CONTEXTS, std::vector<uint64_t> ());
+  m_systemIds.assign (N_CONTEXTS, 0);
+  m_samples.clear ();
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      std::vector<uint32_t> partitions;
+      partitions.push_back (0);
+      partitions.push_back (0);
+      partitions.push_back (1);
+      partitions.push_back (1);
+      impl->SetPartitions (partitions, MicroSeconds (10));
+    }
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      Simulator::ScheduleWithContext (i, NanoSeconds (i), &MultithreadedSimulatorTestCase::Event, this, i, 0);
+    }
+  Simulator::Schedule (NanoSeconds (7), &MultithreadedSimulatorTestCase::Sample, this);
+  Simulator::Stop (MicroSeconds (400));
+  Simulator::Run ();
+  if (impl != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetNPartitions (), 2, "Wrong number of partitions");
+      NS_TEST_EXPECT_MSG_GT (impl->GetNWindows (), 1, "The partitions did not synchronize");
+    }
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  RunPattern ("ns3::DefaultSimulatorImpl");
+  std::vector<std::vector<uint64_t> > times = m_times;
+  std::vector<uint64_t> samples = m_samples;
+
+  RunPattern ("ns3::MultithreadedSimulatorImpl");
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_times[i].size (), times[i].size (), "Wrong number of events in context " << i);
+      for (std::size_t j = 0; j < times[i].size (); ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_times[i][j], times[i][j], "Wrong time of event " << j << " in context " << i);
+        }
+      NS_TEST_EXPECT_MSG_EQ (m_systemIds[i], i / 2, "Context " << i << " run by the wrong partition");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_samples.size (), samples.size (), "Wrong number of samples");
+  for (std::size_t j = 0; j < samples.size (); ++j)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_samples[j], samples[j], "Sample " << j << " saw a different state");
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetGlobal ("SchedulerType", StringValue ("ns3::MapScheduler"));
+}
+
+/**
+ * \ingroup tests
+ *
+ * Schedule and cancel destroy events from one partition while the
+ * other keeps checking its own destroy events, so that the shared list
+ * of destroy events is used from both threads at once.
+ */
+class MultithreadedSimulatorDestroyTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorDestroyTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Event of a context of the first partition: schedules a destroy
+   * event and cancels every other one.
+   * \param [in] context The context.
+   * \param [in] n The event number in the local chain.
+   */
+  void Churn (uint32_t context, uint32_t n);
+  /**
+   * Event of a context of the second partition: checks its own destroy event.
+   * \param [in] context The context.
+   * \param [in] n The event number in the local chain.
+   */
+  void Check (uint32_t context, uint32_t n);
+  /** Destroy event. */
+  void Destroyed (void);
+
+  /** Number of contexts, half of them in each partition. */
+  static const uint32_t N_CONTEXTS = 4;
+  /** Length of the local event chains. */
+  static const uint32_t N_EVENTS = 500;
+
+  std::vector<EventId> m_ids;           //!< Destroy event of each checking context
+  std::vector<uint32_t> m_expired;      //!< Times each checking context found its destroy event expired
+  std::vector<uint32_t> m_notCancelled; //!< Cancelled destroy events each churning context found pending
+  uint32_t m_destroyed;                 //!< Destroy events run
+};
+
+MultithreadedSimulatorDestroyTestCase::MultithreadedSimulatorDestroyTestCase ()
+  : TestCase ("Check the destroy events of the multithreaded simulator from concurrent partitions"),
+    m_destroyed (0)
+{}
+
+void
+MultithreadedSimulatorDestroyTestCase::Churn (uint32_t context, uint32_t n)
+{
+  EventId id = Simulator::ScheduleDestroy (&MultithreadedSimulatorDestroyTestCase::Destroyed, this);
+  if (n % 2 == 0)
+    {
+      Simulator::Cancel (id);
+      if (!Simulator::IsExpired (id))
+        {
+          m_notCancelled[context]++;
+        }
+    }
+  if (n + 1 < N_EVENTS)
+    {
+      Simulator::Schedule (NanoSeconds (100 + context), &MultithreadedSimulatorDestroyTestCase::Churn, this, context, n + 1);
+    }
+}
+
+void
+MultithreadedSimulatorDestroyTestCase::Check (uint32_t context, uint32_t n)
+{
+  if (n == 0)
+    {
+      m_ids[context] = Simulator::ScheduleDestroy (&MultithreadedSimulatorDestroyTestCase::Destroyed, this);
+    }
+  if (Simulator::IsExpired (m_ids[context]))
+    {
+      m_expired[context]++;
+    }
+  if (n + 1 < N_EVENTS)
+    {
+      Simulator::Schedule (NanoSeconds (100 + context), &MultithreadedSimulatorDestroyTestCase::Check, this, context, n + 1);
+    }
+}
+
+void
+MultithreadedSimulatorDestroyTestCase::Destroyed (void)
+{
+  m_destroyed++;
+}
+
+void
+MultithreadedSimulatorDestroyTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  m_ids.assign (N_CONTEXTS, EventId ());
+  m_expired.assign (N_CONTEXTS, 0);
+  m_notCancelled.assign (N_CONTEXTS, 0);
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Not the multithreaded simulator");
+  std::vector<uint32_t> partitions;
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      partitions.push_back (i < N_CONTEXTS / 2 ? 0 : 1);
+    }
+  impl->SetPartitions (partitions, MicroSeconds (10));
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      if (i < N_CONTEXTS / 2)
+        {
+          Simulator::ScheduleWithContext (i, NanoSeconds (i), &MultithreadedSimulatorDestroyTestCase::Churn, this, i, 0);
+        }
+      else
+        {
+          Simulator::ScheduleWithContext (i, NanoSeconds (i), &MultithreadedSimulatorDestroyTestCase::Check, this, i, 0);
+        }
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (impl->GetNPartitions (), 2, "Wrong number of partitions");
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_expired[i], 0, "Context " << i << " found its destroy event expired");
+      NS_TEST_EXPECT_MSG_EQ (m_notCancelled[i], 0, "Context " << i << " found a cancelled destroy event pending");
+    }
+  Simulator::Destroy ();
+  // Half of the churned destroy events, plus one per checking context
+  NS_TEST_EXPECT_MSG_EQ (m_destroyed, N_CONTEXTS / 2 * N_EVENTS / 2 + N_CONTEXTS / 2, "Wrong number of destroy events run");
+}
+
+void
+MultithreadedSimulatorDestroyTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup tests
+ *
+ * Check that the NO_CONTEXT events and the events of the partitions at
+ * the same time run in uid order, as with the DefaultSimulatorImpl: a
+ * NO_CONTEXT event scheduled at 0 after the events which initialize the
+ * contexts, as an object created after the nodes does, must see them done.
+ */
+class MultithreadedSimulatorTieTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTieTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Event of a context.
+   * \param [in] context The context.
+   */
+  void ContextEvent (uint32_t context);
+  /** NO_CONTEXT event, records how many context events ran. */
+  void GlobalEvent (void);
+  /**
+   * Run the pattern.
+   * \param [in] simulatorType The SimulatorImpl TypeId name.
+   */
+  void RunPattern (std::string simulatorType);
+
+  /** Number of contexts, one per partition. */
+  static const uint32_t N_CONTEXTS = 2;
+
+  std::vector<uint32_t> m_done;       //!< Whether the event of each context ran
+  std::vector<uint32_t> m_seen;       //!< Context events run, seen by each NO_CONTEXT event
+};
+
+MultithreadedSimulatorTieTestCase::MultithreadedSimulatorTieTestCase ()
+  : TestCase ("Check the order of the NO_CONTEXT and context events at the same time")
+{}
+
+void
+MultithreadedSimulatorTieTestCase::ContextEvent (uint32_t context)
+{
+  m_done[context] = 1;
+}
+
+void
+MultithreadedSimulatorTieTestCase::GlobalEvent (void)
+{
+  uint32_t seen = 0;
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      seen += m_done[i];
+    }
+  m_seen.push_back (seen);
+}
+
+void
+MultithreadedSimulatorTieTestCase::RunPattern (std::string simulatorType)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  m_done.assign (N_CONTEXTS, 0);
+  m_seen.clear ();
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      std::vector<uint32_t> partitions;
+      for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+        {
+          partitions.push_back (i);
+        }
+      impl->SetPartitions (partitions, MicroSeconds (10));
+    }
+
+  Simulator::Schedule (Seconds (0), &MultithreadedSimulatorTieTestCase::GlobalEvent, this);
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      Simulator::ScheduleWithContext (i, Seconds (0), &MultithreadedSimulatorTieTestCase::ContextEvent, this, i);
+    }
+  Simulator::Schedule (Seconds (0), &MultithreadedSimulatorTieTestCase::GlobalEvent, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedSimulatorTieTestCase::DoRun (void)
+{
+  RunPattern ("ns3::DefaultSimulatorImpl");
+  std::vector<uint32_t> seen = m_seen;
+  NS_TEST_ASSERT_MSG_EQ (seen.size (), 2, "Wrong number of NO_CONTEXT events");
+  NS_TEST_EXPECT_MSG_EQ (seen[0], 0, "The default simulator does not run the events in uid order");
+  NS_TEST_EXPECT_MSG_EQ (seen[1], N_CONTEXTS, "The default simulator does not run the events in uid order");
+
+  RunPattern ("ns3::MultithreadedSimulatorImpl");
+  NS_TEST_ASSERT_MSG_EQ (m_seen.size (), seen.size (), "Wrong number of NO_CONTEXT events");
+  NS_TEST_EXPECT_MSG_EQ (m_seen[0], seen[0], "A NO_CONTEXT event ran after later context events");
+  NS_TEST_EXPECT_MSG_EQ (m_seen[1], seen[1], "A NO_CONTEXT event ran before earlier context events");
+}
+
+void
+MultithreadedSimulatorTieTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup tests
+ *
+ * Create random variables from the events of several partitions, as the
+ * sockets forked by a TCP listener do, and check that they draw the same
+ * values from one run to the next, whatever the interleaving of the
+ * threads.
+ */
+class MultithreadedSimulatorStreamTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorStreamTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Event of a context, creating a random variable.
+   * \param [in] context The context.
+   * \param [in] n The event number in the local chain.
+   */
+  void Create (uint32_t context, uint32_t n);
+  /** Run the pattern once. */
+  void RunPattern (void);
+
+  /** Number of contexts, one per partition. */
+  static const uint32_t N_CONTEXTS = 4;
+  /** Length of the local event chains. */
+  static const uint32_t N_EVENTS = 200;
+
+  std::vector<std::vector<double> > m_values;  //!< First value of each variable of each context
+};
+
+MultithreadedSimulatorStreamTestCase::MultithreadedSimulatorStreamTestCase ()
+  : TestCase ("Check that the multithreaded simulator assigns the RNG streams deterministically")
+{}
+
+void
+MultithreadedSimulatorStreamTestCase::Create (uint32_t context, uint32_t n)
+{
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  m_values[context].push_back (rv->GetValue ());
+  if (n + 1 < N_EVENTS)
+    {
+      Simulator::Schedule (NanoSeconds (100), &MultithreadedSimulatorStreamTestCase::Create, this, context, n + 1);
+    }
+}
+
+void
+MultithreadedSimulatorStreamTestCase::RunPattern (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  m_values.assign (N_CONTEXTS, std::vector<double> ());
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  std::vector<uint32_t> partitions;
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      partitions.push_back (i);
+    }
+  impl->SetPartitions (partitions, MicroSeconds (10));
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      Simulator::ScheduleWithContext (i, NanoSeconds (0), &MultithreadedSimulatorStreamTestCase::Create, this, i, 0);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedSimulatorStreamTestCase::DoRun (void)
+{
+  RunPattern ();
+  std::vector<std::vector<double> > values = m_values;
+  RunPattern ();
+  std::set<double> distinct;
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_values[i].size (), N_EVENTS, "Wrong number of variables in context " << i);
+      for (uint32_t j = 0; j < N_EVENTS; ++j)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_values[i][j], values[i][j], "Variable " << j << " of context " << i << " changed");
+          distinct.insert (m_values[i][j]);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (distinct.size (), N_CONTEXTS * N_EVENTS, "Variables share a stream");
+}
+
+void
+MultithreadedSimulatorStreamTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup tests
+ *
+ * MultithreadedSimulatorImpl test suite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase ("ns3::MapScheduler"), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase ("ns3::HeapScheduler"), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase ("ns3::LadderScheduler"), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorDestroyTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTieTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorStreamTestCase (), TestCase::QUICK);
+  }
+};
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite; //!< Static variable for test initialization
@@ -21,6 +21,8 @@
 #include "ns3/test.h"
 #include "ns3/ptr.h"
 
+#include <utility>
+
 /**
  * \file
  * \ingroup core-tests
@@ -56,6 +58,11 @@ public:
   void Ref (void) const;
   /** Decrement the reference count, and delete if necessary. */
   void Unref (void) const;
+  /**
+   * Get the reference count.
+   * \returns The reference count.
+   */
+  uint32_t GetReferenceCount (void) const;
 
 private:
   mutable uint32_t m_count; //!< The reference count.
@@ -134,6 +141,12 @@ PtrTestBase::Unref (void) const
     }
 }
 
+uint32_t
+PtrTestBase::GetReferenceCount (void) const
+{
+  return m_count;
+}
+
 NoCount::NoCount (PtrTestCase *test)
   : m_test (test)
 {}
@@ -322,6 +335,31 @@ PtrTestCase::DoRun (void)
     NS_TEST_EXPECT_MSG_EQ ((p0 == p1), false, "operator == failed");
     NS_TEST_EXPECT_MSG_EQ ((p0 != p1), true, "operator != failed");
   }
+
+  m_nDestroyed = 0;
+  {
+    Ptr<NoCount> p = Create<NoCount> (this);
+    const NoCount *raw = PeekPointer (p);
+    Ptr<NoCount> p1 = std::move (p);
+    NS_TEST_EXPECT_MSG_EQ (p, 0, "move constructor did not empty its source");
+    NS_TEST_EXPECT_MSG_EQ (PeekPointer (p1), raw, "move constructor lost the object");
+    NS_TEST_EXPECT_MSG_EQ (raw->GetReferenceCount (), 1, "move constructor changed the count");
+    Ptr<PtrTestBase const> p2 = std::move (p1);
+    NS_TEST_EXPECT_MSG_EQ (p1, 0, "converting move did not empty its source");
+    NS_TEST_EXPECT_MSG_EQ (raw->GetReferenceCount (), 1, "converting move changed the count");
+    Ptr<NoCount> p3 = Create<NoCount> (this);
+    p1 = p3;
+    p3 = CallTest (std::move (p1));
+    NS_TEST_EXPECT_MSG_EQ (p1, 0, "move to a parameter did not empty its source");
+    NS_TEST_EXPECT_MSG_EQ (p3->GetReferenceCount (), 1, "moves through a call changed the count");
+    p2 = std::move (p3);
+    NS_TEST_EXPECT_MSG_EQ (m_nDestroyed, 1, "move assignment did not release the old object");
+    NS_TEST_EXPECT_MSG_EQ (p2->GetReferenceCount (), 1, "move assignment changed the count");
+    Ptr<PtrTestBase const> &alias = p2;
+    p2 = std::move (alias);
+    NS_TEST_EXPECT_MSG_EQ (p2->GetReferenceCount (), 1, "self move assignment changed the count");
+  }
+  NS_TEST_EXPECT_MSG_EQ (m_nDestroyed, 2, "moved objects not destroyed once");
 }
 
 /**
@@ -24,6 +24,11 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/event-trace.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
 
 using namespace ns3;
 
@@ -170,6 +175,191 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorOrderTestCase : public TestCase
+{
+public:
+  SimulatorOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Check (uint64_t seq);
+  void ScheduleOne (Time delay);
+  uint64_t m_seq;
+  uint64_t m_lastSeq;
+  uint64_t m_lastTs;
+  uint32_t m_run;
+  bool m_ordered;
+  Ptr<UniformRandomVariable> m_rng;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorOrderTestCase::SimulatorOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that events run in (time, insertion) order with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+void
+SimulatorOrderTestCase::ScheduleOne (Time delay)
+{
+  Simulator::Schedule (delay, &SimulatorOrderTestCase::Check, this, m_seq++);
+}
+
+void
+SimulatorOrderTestCase::Check (uint64_t seq)
+{
+  uint64_t ts = Now ().GetTimeStep ();
+  if (ts < m_lastTs || (ts == m_lastTs && seq < m_lastSeq))
+    {
+      m_ordered = false;
+    }
+  m_lastTs = ts;
+  m_lastSeq = seq;
+  m_run++;
+  // Keep a population of near-future, same-time and far-future events
+  if (m_run < 20000)
+    {
+      uint32_t kind = m_rng->GetInteger (0, 9);
+      if (kind == 0)
+        {
+          ScheduleOne (Seconds (0));
+        }
+      else if (kind == 1)
+        {
+          ScheduleOne (MilliSeconds (m_rng->GetInteger (1, 1000)));
+        }
+      else
+        {
+          ScheduleOne (NanoSeconds (m_rng->GetInteger (0, 10000)));
+        }
+    }
+}
+
+void
+SimulatorOrderTestCase::DoRun (void)
+{
+  m_seq = 0;
+  m_lastSeq = 0;
+  m_lastTs = 0;
+  m_run = 0;
+  m_ordered = true;
+  m_rng = CreateObject<UniformRandomVariable> ();
+
+  Simulator::SetScheduler (m_schedulerFactory);
+
+  std::vector<EventId> removed;
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      ScheduleOne (NanoSeconds (m_rng->GetInteger (0, 100000)));
+      // Bursts of simultaneous events
+      ScheduleOne (MicroSeconds (i % 7));
+      removed.push_back (Simulator::Schedule (NanoSeconds (m_rng->GetInteger (0, 100000)),
+                                              &SimulatorOrderTestCase::Check, this, 0));
+    }
+  for (std::vector<EventId>::iterator i = removed.begin (); i != removed.end (); ++i)
+    {
+      Simulator::Remove (*i);
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "Events ran out of order");
+  NS_TEST_EXPECT_MSG_EQ (m_run, 4000 + 20000 - 1, "Unexpected number of events");
+  Simulator::Destroy ();
+}
+
+class SimulatorRemoveTestCase : public TestCase
+{
+public:
+  SimulatorRemoveTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Event (uint32_t us);
+  std::vector<uint32_t> m_ran;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorRemoveTestCase::SimulatorRemoveTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check Remove of an event whose replacement is smaller than its new parent with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+void
+SimulatorRemoveTestCase::Event (uint32_t us)
+{
+  m_ran.push_back (us);
+}
+
+void
+SimulatorRemoveTestCase::DoRun (void)
+{
+  Simulator::SetScheduler (m_schedulerFactory);
+
+  // In a binary heap, removing the event at 16us moves the one at 4us
+  // below the one at 8us, where sifting it down is not enough
+  uint32_t times[] = { 8, 16, 15, 13, 18, 3, 4 };
+  EventId removed;
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      EventId id = Simulator::Schedule (MicroSeconds (times[i]), &SimulatorRemoveTestCase::Event, this, times[i]);
+      if (times[i] == 16)
+        {
+          removed = id;
+        }
+    }
+  Simulator::Remove (removed);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  uint32_t expected[] = { 3, 4, 8, 13, 15, 18 };
+  NS_TEST_ASSERT_MSG_EQ (m_ran.size (), 6U, "Unexpected number of events");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_ran[i], expected[i], "Event " << i << " ran out of order");
+    }
+}
+
+class SimulatorEventTraceTestCase : public TestCase
+{
+public:
+  SimulatorEventTraceTestCase ();
+  virtual void DoRun (void);
+  void Event (void);
+};
+
+SimulatorEventTraceTestCase::SimulatorEventTraceTestCase ()
+  : TestCase ("Check that DefaultSimulatorImpl records the event list operations")
+{}
+
+void
+SimulatorEventTraceTestCase::Event (void)
+{}
+
+void
+SimulatorEventTraceTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("events.bin");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventTraceFile", StringValue (filename));
+
+  EventId a = Simulator::Schedule (MicroSeconds (1), &SimulatorEventTraceTestCase::Event, this);
+  EventId b = Simulator::Schedule (MicroSeconds (2), &SimulatorEventTraceTestCase::Event, this);
+  EventId c = Simulator::Schedule (MicroSeconds (3), &SimulatorEventTraceTestCase::Event, this);
+  Simulator::Remove (c);
+  Simulator::Cancel (b);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventTraceFile", StringValue (""));
+
+  std::vector<EventTrace::Record> records;
+  NS_TEST_ASSERT_MSG_EQ (EventTrace::Load (filename, records), true, "Cannot read " << filename);
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 7U, "Unexpected number of records");
+  EventTrace::Op ops[] = { EventTrace::INSERT, EventTrace::INSERT, EventTrace::INSERT, EventTrace::REMOVE,
+                           EventTrace::CANCEL, EventTrace::REMOVE_NEXT, EventTrace::REMOVE_NEXT };
+  uint32_t uids[] = { a.GetUid (), b.GetUid (), c.GetUid (), c.GetUid (), b.GetUid (), a.GetUid (), b.GetUid () };
+  for (uint32_t i = 0; i < records.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (records[i].GetOp (), ops[i], "Unexpected operation of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (records[i].uid, uids[i], "Unexpected event of record " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (records[0].GetKey ().m_ts, static_cast<uint64_t> (MicroSeconds (1).GetTimeStep ()), "Unexpected timestamp");
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -483,5 +673,27 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorRemoveTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorRemoveTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorRemoveTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorRemoveTestCase (factory), TestCase::QUICK);
+
+    AddTestCase (new SimulatorEventTraceTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -19,6 +19,7 @@
  */
 #include "ipv4-global-routing-helper.h"
 #include "ns3/global-router-interface.h"
+#include "ns3/global-route-builder.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
@@ -70,6 +71,11 @@ Ipv4GlobalRoutingHelper::RecomputeRoutingTables (void)
   GlobalRouteManager::BuildGlobalRoutingDatabase ();
   GlobalRouteManager::InitializeRoutes ();
 }
+void
+Ipv4GlobalRoutingHelper::BuildRoutingTables (uint32_t nThreads)
+{
+  GlobalRouteBuilder::BuildRoutes (nThreads);
+}
 
 
 } // namespace ns3
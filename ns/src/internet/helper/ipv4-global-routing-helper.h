@@ -85,6 +85,20 @@ public:
    *
    */
   static void RecomputeRoutingTables (void);
+  /**
+   * \brief Build the routing tables of the nodes in the simulation with
+   * the GlobalRouteBuilder, meant for topologies too large for
+   * PopulateRoutingTables.
+   *
+   * The routes are equivalent.  Later interface events are then handled by
+   * the builder, which recomputes only the routes using a failed link.  The
+   * builder keeps a single next hop per destination: if any node has
+   * Ipv4GlobalRouting::RandomEcmpRouting set, this does the same as
+   * PopulateRoutingTables instead.
+   *
+   * \param [in] nThreads The number of threads computing the routes.
+   */
+  static void BuildRoutingTables (uint32_t nThreads = 1);
 private:
   /**
    * \brief Assignment operator declared private and not implemented to disallow
@@ -0,0 +1,628 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/simulation-singleton.h"
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/ipv4.h"
+#include "global-route-builder.h"
+#include "global-route-manager.h"
+#include "global-router-interface.h"
+#include "ipv4-global-routing.h"
+#include "loopback-net-device.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <vector>
+#ifdef HAVE_PTHREAD_H
+#include <thread>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GlobalRouteBuilder");
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief The state of the GlobalRouteBuilder: the graph of the routers
+ * and the destinations they own.
+ */
+class GlobalRouteBuilderImpl
+{
+public:
+  GlobalRouteBuilderImpl ();
+
+  /**
+   * \brief Build the graph and the routes of every router.
+   * \param [in] nThreads The number of threads computing the routes.
+   */
+  void BuildRoutes (uint32_t nThreads);
+  /** \brief Build the graph and the routes again. */
+  void Rebuild (void);
+  /** \returns \c true once BuildRoutes has been called. */
+  bool IsEnabled (void) const;
+  /**
+   * \brief Remove the links of an interface and recompute the routes
+   * which may use them.
+   * \param [in] node The node of the interface.
+   * \param [in] interface The interface index.
+   */
+  void NotifyInterfaceDown (Ptr<Node> node, uint32_t interface);
+
+private:
+  /** Distance of the unreachable vertices. */
+  static const uint32_t INFINITE_DISTANCE = std::numeric_limits<uint32_t>::max ();
+  /** No edge, or no vertex. */
+  static const uint32_t NONE = std::numeric_limits<uint32_t>::max ();
+  /** Number of sources searched by each thread between two installs. */
+  static const uint32_t SOURCES_PER_THREAD = 64;
+
+  /** A directed link between two routers. */
+  struct Edge
+  {
+    uint32_t from;           //!< Source vertex
+    uint32_t to;             //!< Destination vertex
+    uint32_t metric;         //!< Link metric, of the source interface
+    uint32_t interface;      //!< Interface of the source vertex
+    uint32_t peerInterface;  //!< Interface of the destination vertex
+    Ipv4Address gateway;     //!< Address of the destination interface
+    bool pointToPoint;       //!< The link is a point-to-point one
+    bool up;                 //!< False once the link failed
+  };
+
+  /** An interface address of a router. */
+  struct Host
+  {
+    Ipv4Address address;     //!< The address
+    uint32_t owner;          //!< The router vertex
+  };
+
+  /** A prefix with the interfaces of the routers attached to it. */
+  struct Prefix
+  {
+    Ipv4Address network;     //!< The network address
+    Ipv4Mask mask;           //!< The network mask
+    /** Every address of the prefix is the address of a router. */
+    bool covered;
+    /** The attached (vertex, interface). */
+    std::vector<std::pair<uint32_t, uint32_t> > owners;
+  };
+
+  /** \brief Read the routers, links and addresses of the topology. */
+  void BuildGraph (void);
+  /**
+   * \brief Compute and install the routes of some routers.
+   * \param [in] sources The router vertices.
+   */
+  void Compute (const std::vector<uint32_t> &sources);
+  /**
+   * \brief Dijkstra search over the links which are up.
+   *
+   * \param [in] source The source vertex.
+   * \param [in] reverse Follow the links backwards, to get the distances
+   *             from every vertex to the source.
+   * \param [out] dist The distance of each vertex.
+   * \param [out] firstEdge If not null, the first edge of the path to each
+   *              vertex.
+   */
+  void ShortestPaths (uint32_t source, bool reverse, uint32_t *dist, uint32_t *firstEdge) const;
+  /**
+   * \brief Replace the routes of a router.
+   * \param [in] source The router vertex.
+   * \param [in] dist The distance of each vertex from the source.
+   * \param [in] firstEdge The first edge of the path to each vertex.
+   */
+  void InstallRoutes (uint32_t source, const uint32_t *dist, const uint32_t *firstEdge) const;
+
+  bool m_enabled;                                 //!< BuildRoutes built the routes
+  uint32_t m_nThreads;                            //!< Number of threads
+  std::vector<uint32_t> m_vertexOf;               //!< Vertex of each node id
+  std::vector<Ptr<Ipv4GlobalRouting> > m_routing; //!< Routing of each vertex
+  std::vector<Edge> m_edges;                      //!< Edges, by source vertex
+  std::vector<uint32_t> m_outStart;               //!< First edge of each vertex
+  std::vector<uint32_t> m_inEdges;                //!< Edges, by destination vertex
+  std::vector<uint32_t> m_inStart;                //!< First incoming edge of each vertex
+  std::vector<Host> m_hosts;                      //!< Router addresses
+  std::vector<Prefix> m_prefixes;                 //!< Prefixes, longest first
+};
+
+const uint32_t GlobalRouteBuilderImpl::INFINITE_DISTANCE;
+const uint32_t GlobalRouteBuilderImpl::NONE;
+const uint32_t GlobalRouteBuilderImpl::SOURCES_PER_THREAD;
+
+GlobalRouteBuilderImpl::GlobalRouteBuilderImpl ()
+  : m_enabled (false),
+    m_nThreads (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+GlobalRouteBuilderImpl::IsEnabled (void) const
+{
+  return m_enabled;
+}
+
+void
+GlobalRouteBuilderImpl::BuildRoutes (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+  m_nThreads = std::max (nThreads, 1u);
+  BuildGraph ();
+  for (uint32_t v = 0; v < m_routing.size (); ++v)
+    {
+      BooleanValue randomEcmp;
+      m_routing[v]->GetAttribute ("RandomEcmpRouting", randomEcmp);
+      if (randomEcmp.Get ())
+        {
+          // Only the GlobalRouteManager keeps every equal cost next hop;
+          // it then also handles the interface events
+          NS_LOG_WARN ("RandomEcmpRouting set, building the routes with the GlobalRouteManager");
+          m_enabled = false;
+          GlobalRouteManager::DeleteGlobalRoutes ();
+          GlobalRouteManager::BuildGlobalRoutingDatabase ();
+          GlobalRouteManager::InitializeRoutes ();
+          return;
+        }
+    }
+  m_enabled = true;
+  std::vector<uint32_t> sources (m_routing.size ());
+  for (uint32_t v = 0; v < sources.size (); ++v)
+    {
+      sources[v] = v;
+    }
+  Compute (sources);
+}
+
+void
+GlobalRouteBuilderImpl::Rebuild (void)
+{
+  NS_LOG_FUNCTION (this);
+  BuildRoutes (m_nThreads);
+}
+
+void
+GlobalRouteBuilderImpl::BuildGraph (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_vertexOf.assign (NodeList::GetNNodes (), NONE);
+  m_routing.clear ();
+  m_edges.clear ();
+  m_outStart.clear ();
+  m_hosts.clear ();
+  m_prefixes.clear ();
+
+  std::vector<Ptr<Ipv4> > ipv4s;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<GlobalRouter> router = (*i)->GetObject<GlobalRouter> ();
+      Ptr<Ipv4> ipv4 = (*i)->GetObject<Ipv4> ();
+      if (router == 0 || ipv4 == 0)
+        {
+          continue;
+        }
+      m_vertexOf[(*i)->GetId ()] = m_routing.size ();
+      m_routing.push_back (router->GetRoutingProtocol ());
+      ipv4s.push_back (ipv4);
+    }
+
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> prefixIndex;
+  for (uint32_t u = 0; u < ipv4s.size (); ++u)
+    {
+      m_outStart.push_back (m_edges.size ());
+      Ptr<Ipv4> ipv4 = ipv4s[u];
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces (); ++i)
+        {
+          Ptr<NetDevice> device = ipv4->GetNetDevice (i);
+          if (DynamicCast<LoopbackNetDevice> (device))
+            {
+              continue;
+            }
+          for (uint32_t k = 0; k < ipv4->GetNAddresses (i); ++k)
+            {
+              Ipv4InterfaceAddress address = ipv4->GetAddress (i, k);
+              Host host = { address.GetLocal (), u };
+              m_hosts.push_back (host);
+              Ipv4Address network = address.GetLocal ().CombineMask (address.GetMask ());
+              std::pair<uint32_t, uint32_t> key (network.Get (), address.GetMask ().Get ());
+              std::map<std::pair<uint32_t, uint32_t>, uint32_t>::iterator it = prefixIndex.find (key);
+              if (it == prefixIndex.end ())
+                {
+                  it = prefixIndex.insert (std::make_pair (key, m_prefixes.size ())).first;
+                  Prefix prefix;
+                  prefix.network = network;
+                  prefix.mask = address.GetMask ();
+                  prefix.covered = false;
+                  m_prefixes.push_back (prefix);
+                }
+              m_prefixes[it->second].owners.push_back (std::make_pair (u, i));
+            }
+          Ptr<Channel> channel = device->GetChannel ();
+          if (!ipv4->IsUp (i) || ipv4->GetNAddresses (i) == 0 || channel == 0)
+            {
+              continue;
+            }
+          for (std::size_t j = 0; j < channel->GetNDevices (); ++j)
+            {
+              Ptr<NetDevice> peerDevice = channel->GetDevice (j);
+              if (peerDevice == device)
+                {
+                  continue;
+                }
+              uint32_t v = m_vertexOf[peerDevice->GetNode ()->GetId ()];
+              if (v == NONE)
+                {
+                  continue;
+                }
+              int32_t peerInterface = ipv4s[v]->GetInterfaceForDevice (peerDevice);
+              if (peerInterface < 0 || !ipv4s[v]->IsUp (peerInterface)
+                  || ipv4s[v]->GetNAddresses (peerInterface) == 0)
+                {
+                  continue;
+                }
+              Edge edge;
+              edge.from = u;
+              edge.to = v;
+              edge.metric = ipv4->GetMetric (i);
+              edge.interface = i;
+              edge.peerInterface = peerInterface;
+              edge.gateway = ipv4s[v]->GetAddress (peerInterface, 0).GetLocal ();
+              edge.pointToPoint = device->IsPointToPoint ();
+              edge.up = true;
+              m_edges.push_back (edge);
+            }
+        }
+    }
+  m_outStart.push_back (m_edges.size ());
+
+  // Incoming edges, by counting sort on the destination vertex
+  m_inStart.assign (m_routing.size () + 1, 0);
+  for (std::size_t e = 0; e < m_edges.size (); ++e)
+    {
+      m_inStart[m_edges[e].to + 1]++;
+    }
+  for (std::size_t v = 0; v < m_routing.size (); ++v)
+    {
+      m_inStart[v + 1] += m_inStart[v];
+    }
+  m_inEdges.resize (m_edges.size ());
+  std::vector<uint32_t> next (m_inStart.begin (), m_inStart.end () - 1);
+  for (std::size_t e = 0; e < m_edges.size (); ++e)
+    {
+      m_inEdges[next[m_edges[e].to]++] = e;
+    }
+
+  // A prefix needs no network route when all its addresses are routers'
+  for (std::vector<Prefix>::iterator p = m_prefixes.begin (); p != m_prefixes.end (); ++p)
+    {
+      uint16_t length = p->mask.GetPrefixLength ();
+      uint64_t size = uint64_t (1) << (32 - length);
+      uint64_t usable = length >= 31 ? size : size - 2;
+      p->covered = p->owners.size () >= usable;
+    }
+  std::stable_sort (m_prefixes.begin (), m_prefixes.end (),
+                    [] (const Prefix &a, const Prefix &b)
+                    {
+                      return a.mask.GetPrefixLength () > b.mask.GetPrefixLength ();
+                    });
+  NS_LOG_INFO ("Graph of " << m_routing.size () << " routers, " << m_edges.size ()
+               << " links, " << m_hosts.size () << " addresses and "
+               << m_prefixes.size () << " prefixes");
+}
+
+void
+GlobalRouteBuilderImpl::ShortestPaths (uint32_t source, bool reverse, uint32_t *dist, uint32_t *firstEdge) const
+{
+  uint32_t nVertices = m_routing.size ();
+  std::fill (dist, dist + nVertices, INFINITE_DISTANCE);
+  if (firstEdge != 0)
+    {
+      std::fill (firstEdge, firstEdge + nVertices, NONE);
+    }
+  // Ties are broken by vertex index, so the result does not depend on
+  // the thread doing the search
+  typedef std::pair<uint32_t, uint32_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+  dist[source] = 0;
+  queue.push (Entry (0, source));
+  while (!queue.empty ())
+    {
+      Entry top = queue.top ();
+      queue.pop ();
+      uint32_t v = top.second;
+      if (top.first != dist[v])
+        {
+          continue;
+        }
+      uint32_t begin = reverse ? m_inStart[v] : m_outStart[v];
+      uint32_t end = reverse ? m_inStart[v + 1] : m_outStart[v + 1];
+      for (uint32_t k = begin; k < end; ++k)
+        {
+          uint32_t e = reverse ? m_inEdges[k] : k;
+          const Edge &edge = m_edges[e];
+          if (!edge.up)
+            {
+              continue;
+            }
+          uint32_t w = reverse ? edge.from : edge.to;
+          uint32_t d = top.first + edge.metric;
+          if (d < dist[w])
+            {
+              dist[w] = d;
+              if (firstEdge != 0)
+                {
+                  firstEdge[w] = v == source ? e : firstEdge[v];
+                }
+              queue.push (Entry (d, w));
+            }
+        }
+    }
+}
+
+void
+GlobalRouteBuilderImpl::InstallRoutes (uint32_t source, const uint32_t *dist, const uint32_t *firstEdge) const
+{
+  Ptr<Ipv4GlobalRouting> routing = m_routing[source];
+  for (uint32_t n = routing->GetNRoutes (); n > 0; --n)
+    {
+      routing->RemoveRoute (0);
+    }
+
+  // A stub node, whose only link to a router is a point-to-point one, gets a
+  // default route, as in GlobalRouteManagerImpl::CheckForStubNode
+  uint32_t defaultEdge = NONE;
+  uint32_t nLinks = 0;
+  for (uint32_t e = m_outStart[source]; e < m_outStart[source + 1]; ++e)
+    {
+      if (m_edges[e].up)
+        {
+          nLinks++;
+          defaultEdge = e;
+        }
+    }
+  if (nLinks != 1 || !m_edges[defaultEdge].pointToPoint)
+    {
+      defaultEdge = NONE;
+    }
+
+  // Otherwise, does every destination go through the same neighbor?  Only
+  // if asked to, since the default route also forwards the destinations
+  // which have no route.
+  BooleanValue compactDefaultRoute;
+  routing->GetAttribute ("CompactDefaultRoute", compactDefaultRoute);
+  if (defaultEdge == NONE && compactDefaultRoute.Get ())
+    {
+      for (uint32_t v = 0; v < m_routing.size (); ++v)
+        {
+          if (firstEdge[v] == NONE)
+            {
+              continue;
+            }
+          if (defaultEdge == NONE)
+            {
+              defaultEdge = firstEdge[v];
+            }
+          else if (m_edges[firstEdge[v]].gateway != m_edges[defaultEdge].gateway
+                   || m_edges[firstEdge[v]].interface != m_edges[defaultEdge].interface)
+            {
+              defaultEdge = NONE;
+              break;
+            }
+        }
+    }
+
+  for (std::vector<Prefix>::const_iterator p = m_prefixes.begin (); p != m_prefixes.end (); ++p)
+    {
+      if (p->covered)
+        {
+          continue;
+        }
+      uint32_t best = NONE;
+      for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator o = p->owners.begin ();
+           o != p->owners.end (); ++o)
+        {
+          if (o->first == source)
+            {
+              best = NONE;
+              routing->AddNetworkRouteTo (p->network, p->mask, o->second);
+              break;
+            }
+          if (firstEdge[o->first] != NONE
+              && (best == NONE || dist[o->first] < dist[best]))
+            {
+              best = o->first;
+            }
+        }
+      if (best != NONE && defaultEdge == NONE)
+        {
+          const Edge &edge = m_edges[firstEdge[best]];
+          routing->AddNetworkRouteTo (p->network, p->mask, edge.gateway, edge.interface);
+        }
+    }
+  if (defaultEdge != NONE)
+    {
+      const Edge &edge = m_edges[defaultEdge];
+      routing->AddNetworkRouteTo (Ipv4Address::GetZero (), Ipv4Mask::GetZero (),
+                                  edge.gateway, edge.interface);
+      return;
+    }
+  for (std::vector<Host>::const_iterator h = m_hosts.begin (); h != m_hosts.end (); ++h)
+    {
+      if (h->owner != source && firstEdge[h->owner] != NONE)
+        {
+          const Edge &edge = m_edges[firstEdge[h->owner]];
+          routing->AddHostRouteTo (h->address, edge.gateway, edge.interface);
+        }
+    }
+}
+
+void
+GlobalRouteBuilderImpl::Compute (const std::vector<uint32_t> &sources)
+{
+  NS_LOG_FUNCTION (this << sources.size ());
+  std::size_t nVertices = m_routing.size ();
+  uint32_t nThreads = m_nThreads;
+#ifndef HAVE_PTHREAD_H
+  nThreads = 1;
+#endif
+  std::size_t batch = std::min<std::size_t> (SOURCES_PER_THREAD * nThreads, sources.size ());
+  std::vector<uint32_t> dist (batch * nVertices);
+  std::vector<uint32_t> firstEdge (batch * nVertices);
+  for (std::size_t start = 0; start < sources.size (); start += batch)
+    {
+      std::size_t n = std::min (batch, sources.size () - start);
+      auto search = [&] (std::size_t first)
+        {
+          for (std::size_t k = first; k < n; k += nThreads)
+            {
+              ShortestPaths (sources[start + k], false, &dist[k * nVertices], &firstEdge[k * nVertices]);
+            }
+        };
+#ifdef HAVE_PTHREAD_H
+      std::vector<std::thread> threads;
+      for (uint32_t t = 1; t < nThreads && t < n; ++t)
+        {
+          threads.push_back (std::thread (search, t));
+        }
+      search (0);
+      for (std::size_t t = 0; t < threads.size (); ++t)
+        {
+          threads[t].join ();
+        }
+#else
+      search (0);
+#endif
+      // The routing tables are only touched by this thread
+      for (std::size_t k = 0; k < n; ++k)
+        {
+          InstallRoutes (sources[start + k], &dist[k * nVertices], &firstEdge[k * nVertices]);
+        }
+    }
+}
+
+void
+GlobalRouteBuilderImpl::NotifyInterfaceDown (Ptr<Node> node, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << node->GetId () << interface);
+  uint32_t u = node->GetId () < m_vertexOf.size () ? m_vertexOf[node->GetId ()] : NONE;
+  if (u == NONE)
+    {
+      return;
+    }
+  std::vector<uint32_t> failed;
+  for (uint32_t e = m_outStart[u]; e < m_outStart[u + 1]; ++e)
+    {
+      if (m_edges[e].up && m_edges[e].interface == interface)
+        {
+          failed.push_back (e);
+        }
+    }
+  for (uint32_t k = m_inStart[u]; k < m_inStart[u + 1]; ++k)
+    {
+      uint32_t e = m_inEdges[k];
+      if (m_edges[e].up && m_edges[e].peerInterface == interface)
+        {
+          failed.push_back (e);
+        }
+    }
+  if (failed.empty ())
+    {
+      return;
+    }
+
+  // A router is affected if a failed edge lies on one of its shortest
+  // paths, that is if d(s, from) + metric == d(s, to), with the distances
+  // to the edge ends taken before the failure.
+  std::size_t nVertices = m_routing.size ();
+  std::map<uint32_t, std::vector<uint32_t> > distanceTo;
+  for (std::vector<uint32_t>::const_iterator e = failed.begin (); e != failed.end (); ++e)
+    {
+      uint32_t ends[2] = { m_edges[*e].from, m_edges[*e].to };
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          std::vector<uint32_t> &dist = distanceTo[ends[j]];
+          if (dist.empty ())
+            {
+              dist.resize (nVertices);
+              ShortestPaths (ends[j], true, &dist[0], 0);
+            }
+        }
+    }
+  std::vector<uint32_t> affected;
+  for (uint32_t s = 0; s < nVertices; ++s)
+    {
+      for (std::vector<uint32_t>::const_iterator e = failed.begin (); e != failed.end (); ++e)
+        {
+          uint32_t dFrom = distanceTo[m_edges[*e].from][s];
+          uint32_t dTo = distanceTo[m_edges[*e].to][s];
+          if (dFrom != INFINITE_DISTANCE && dFrom + m_edges[*e].metric == dTo)
+            {
+              affected.push_back (s);
+              break;
+            }
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator e = failed.begin (); e != failed.end (); ++e)
+    {
+      m_edges[*e].up = false;
+    }
+  NS_LOG_INFO ("Interface " << interface << " of node " << node->GetId () << " down: "
+               << failed.size () << " links removed, recomputing "
+               << affected.size () << " of " << nVertices << " routers");
+  Compute (affected);
+}
+
+// ---------------------------------------------------------------------------
+//
+// GlobalRouteBuilder Implementation
+//
+// ---------------------------------------------------------------------------
+
+void
+GlobalRouteBuilder::BuildRoutes (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (nThreads);
+  SimulationSingleton<GlobalRouteBuilderImpl>::Get ()->BuildRoutes (nThreads);
+}
+
+void
+GlobalRouteBuilder::Rebuild (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  SimulationSingleton<GlobalRouteBuilderImpl>::Get ()->Rebuild ();
+}
+
+bool
+GlobalRouteBuilder::IsEnabled (void)
+{
+  return SimulationSingleton<GlobalRouteBuilderImpl>::Get ()->IsEnabled ();
+}
+
+void
+GlobalRouteBuilder::NotifyInterfaceDown (Ptr<Node> node, uint32_t interface)
+{
+  NS_LOG_FUNCTION (node << interface);
+  SimulationSingleton<GlobalRouteBuilderImpl>::Get ()->NotifyInterfaceDown (node, interface);
+}
+
+} // namespace ns3
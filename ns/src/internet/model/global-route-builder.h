@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GLOBAL_ROUTE_BUILDER_H
+#define GLOBAL_ROUTE_BUILDER_H
+
+#include "ns3/ptr.h"
+
+#include <stdint.h>
+
+namespace ns3 {
+
+class Node;
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief Compute the global routes of large topologies.
+ *
+ * An alternative to the GlobalRouteManager for topologies with thousands
+ * of nodes.  Instead of exchanging Link State Advertisements, the builder
+ * reads the links of every node with a GlobalRouter into compact
+ * adjacency arrays, runs one Dijkstra search per node over them,
+ * optionally on several threads, and installs the results directly in
+ * the Ipv4GlobalRouting tables:
+ *
+ *  - a host route to every interface address of the other nodes;
+ *  - a network route to every prefix which has addresses not assigned to
+ *    a node with a GlobalRouter, such as a LAN with plain hosts;
+ *  - on a node whose only link to another router is a point-to-point
+ *    one, typically an end host, a single default route instead, as the
+ *    GlobalRouteManager does.  With Ipv4GlobalRouting::CompactDefaultRoute
+ *    set, on any node which reaches every destination through the same
+ *    neighbor, which then also forwards the destinations without a route.
+ *
+ * The link metrics are those of Ipv4::GetMetric.  Only one next hop is
+ * kept per destination, so when a node has Ipv4GlobalRouting::RandomEcmpRouting
+ * set, BuildRoutes falls back to the GlobalRouteManager, which installs
+ * every equal cost next hop, for all the nodes.  Links through bridges are
+ * not followed.
+ *
+ * When Ipv4GlobalRouting::RespondToInterfaceEvents is set, an interface
+ * going down only recomputes the nodes whose shortest path trees may use
+ * one of its links; the other events rebuild all the routes.  The
+ * addresses of an interface which is down are still routed to its node,
+ * which accepts them on its other interfaces.
+ */
+class GlobalRouteBuilder
+{
+public:
+  /**
+   * \brief Build the routes of every node with a GlobalRouter, replacing
+   * the routes already in their Ipv4GlobalRouting tables.
+   *
+   * \param [in] nThreads The number of threads computing the routes.
+   */
+  static void BuildRoutes (uint32_t nThreads);
+  /**
+   * \brief Build the routes again from the current topology, with the
+   * number of threads of the last BuildRoutes.
+   */
+  static void Rebuild (void);
+  /**
+   * \returns \c true if the routes were built by BuildRoutes, in which
+   * case the interface events are handled by the builder.
+   */
+  static bool IsEnabled (void);
+  /**
+   * \brief Recompute the routes using the links of an interface which
+   * went down.
+   *
+   * \param [in] node The node of the interface.
+   * \param [in] interface The interface index.
+   */
+  static void NotifyInterfaceDown (Ptr<Node> node, uint32_t interface);
+
+private:
+  /**
+   * \brief Copy construction is disallowed.
+   * \param [in] o Object to copy from.
+   */
+  GlobalRouteBuilder (GlobalRouteBuilder &o);
+  /**
+   * \brief Copy assignment is disallowed.
+   * \param [in] o Object to copy from.
+   * \returns The object.
+   */
+  GlobalRouteBuilder & operator= (GlobalRouteBuilder &o);
+};
+
+} // namespace ns3
+
+#endif /* GLOBAL_ROUTE_BUILDER_H */
@@ -23,6 +23,8 @@
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+
 
 namespace ns3 {
 
@@ -43,20 +45,16 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_positions.clear ();
+  m_index.clear ();
+  m_portCount.clear ();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_portCount.find (port) != m_portCount.end ();
 }
 
 bool
@@ -86,7 +84,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -102,7 +100,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -125,7 +123,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -136,21 +134,23 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<uint64_t, EndPointBucket>::const_iterator bucket =
+    m_index.find (GetKey (localPort, peerAddress, peerPort));
+  if (bucket != m_index.end ())
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      for (EndPointBucket::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++)
         {
-          NS_LOG_WARN ("Duplicated endpoint.");
-          return 0;
+          if ((*i)->GetLocalAddress () == localAddress &&
+              ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+            {
+              NS_LOG_WARN ("Duplicated endpoint.");
+              return 0;
+            }
         }
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
 
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
 
@@ -161,14 +161,59 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<Ipv4EndPoint *, EndPointsI>::iterator position = m_positions.find (endPoint);
+  if (position == m_positions.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
+    }
+  RemoveFromIndex (endPoint);
+  std::unordered_map<uint16_t, uint32_t>::iterator count = m_portCount.find (endPoint->GetLocalPort ());
+  if (--count->second == 0)
+    {
+      m_portCount.erase (count);
+    }
+  m_endPoints.erase (position->second);
+  m_positions.erase (position);
+  delete endPoint;
+}
+
+uint64_t
+Ipv4EndPointDemux::GetKey (uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort)
+{
+  return (static_cast<uint64_t> (peerAddress.Get ()) << 32)
+         | (static_cast<uint64_t> (peerPort) << 16) | localPort;
+}
+
+void
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_positions[endPoint] = m_endPoints.insert (m_endPoints.end (), endPoint);
+  m_portCount[endPoint->GetLocalPort ()]++;
+  AddToIndex (endPoint);
+  endPoint->m_demux = this;
+}
+
+void
+Ipv4EndPointDemux::AddToIndex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t key = GetKey (endPoint->GetLocalPort (), endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  m_index[key].push_back (endPoint);
+}
+
+void
+Ipv4EndPointDemux::RemoveFromIndex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t key = GetKey (endPoint->GetLocalPort (), endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  std::unordered_map<uint64_t, EndPointBucket>::iterator bucket = m_index.find (key);
+  NS_ASSERT (bucket != m_index.end ());
+  EndPointBucket &endPoints = bucket->second;
+  endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+  if (endPoints.empty ())
+    {
+      m_index.erase (bucket);
     }
 }
 
@@ -208,9 +253,31 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+
+  // Only the endpoints of dport whose peer is either the source of the
+  // packet or a wildcard can match
+  static const EndPointBucket empty;
+  const EndPointBucket *connected = &empty;
+  const EndPointBucket *unconnected = &empty;
+  std::unordered_map<uint64_t, EndPointBucket>::const_iterator bucket;
+  bucket = m_index.find (GetKey (dport, saddr, sport));
+  if (bucket != m_index.end ())
     {
-      Ipv4EndPoint* endP = *i;
+      connected = &bucket->second;
+    }
+  if (saddr != Ipv4Address::GetAny () || sport != 0)
+    {
+      bucket = m_index.find (GetKey (dport, Ipv4Address::GetAny (), 0));
+      if (bucket != m_index.end ())
+        {
+          unconnected = &bucket->second;
+        }
+    }
+
+  std::size_t nConnected = connected->size ();
+  for (std::size_t i = 0; i < nConnected + unconnected->size (); i++)
+    {
+      Ipv4EndPoint* endP = i < nConnected ? (*connected)[i] : (*unconnected)[i - nConnected];
 
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
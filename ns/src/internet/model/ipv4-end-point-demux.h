@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +42,13 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * Besides the list, the endpoints are indexed in a hash table by local
+ * port, peer address and peer port, which the endpoints keep up to date
+ * when their peer is set.  Lookup only examines the endpoints connected
+ * to the source of the packet and the endpoints open to any peer on the
+ * destination port, so its cost does not grow with the number of
+ * connections of the node.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +175,12 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief Endpoints sharing the same index key.
+   */
+  typedef std::vector<Ipv4EndPoint *> EndPointBucket;
 
   /**
    * \brief Allocate an ephemeral port.
@@ -173,6 +188,33 @@ private:
    */
   uint16_t AllocateEphemeralPort (void);
 
+  /**
+   * \brief Get the index key of a local port and a peer.
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the key
+   */
+  static uint64_t GetKey (uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Add a new end point to the list and to the index.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the index, with its current peer.
+   * \param endPoint the end point
+   */
+  void AddToIndex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the index, with its current peer.
+   * \param endPoint the end point
+   */
+  void RemoveFromIndex (Ipv4EndPoint *endPoint);
+
   /**
    * \brief The ephemeral port.
    */
@@ -192,6 +234,21 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The position of each end point in m_endPoints.
+   */
+  std::unordered_map<Ipv4EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief The end points, by local port, peer address and peer port.
+   */
+  std::unordered_map<uint64_t, EndPointBucket> m_index;
+
+  /**
+   * \brief The number of end points of each local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_portCount;
 };
 
 } // namespace ns3
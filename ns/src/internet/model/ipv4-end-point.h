@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \ingroup ipv4
@@ -183,6 +184,13 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv4EndPointDemux;
+
+  /**
+   * \brief The demux which indexes this endpoint by its peer (if any).
+   */
+  Ipv4EndPointDemux *m_demux;
+
   /**
    * \brief The local address.
    */
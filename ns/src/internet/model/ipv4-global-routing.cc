@@ -16,8 +16,10 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
-#include <vector>
+#include <algorithm>
 #include <iomanip>
+#include <map>
+#include <vector>
 #include "ns3/names.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -30,6 +32,7 @@
 #include "ns3/node.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
+#include "global-route-builder.h"
 
 namespace ns3 {
 
@@ -53,13 +56,20 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_respondToInterfaceEvents),
                    MakeBooleanChecker ())
+    .AddAttribute ("CompactDefaultRoute",
+                   "Set to true if the GlobalRouteBuilder may install a single default route, instead of a route to every destination, whenever they all have the same next hop, and not only on a node with a single point-to-point link.  Destinations without a route are then forwarded to it too",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4GlobalRouting::m_compactDefaultRoute),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_compactDefaultRoute (false),
+    m_lookupIndexValid (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -80,6 +90,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_lookupIndexValid = false;
 }
 
 void 
@@ -90,6 +101,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_lookupIndexValid = false;
 }
 
 void 
@@ -105,6 +117,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_lookupIndexValid = false;
 }
 
 void 
@@ -118,6 +131,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_lookupIndexValid = false;
 }
 
 void 
@@ -136,6 +150,38 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
 }
 
 
+void
+Ipv4GlobalRouting::BuildLookupIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_hostRouteIndex.clear ();
+  m_networkRouteIndex.clear ();
+  for (HostRoutesCI i = m_hostRoutes.begin (); i != m_hostRoutes.end (); i++)
+    {
+      m_hostRouteIndex[(*i)->GetDest ().Get ()].push_back (*i);
+    }
+  std::map<uint32_t, uint32_t> indexOfMask;
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      Ipv4Mask mask = (*j)->GetDestNetworkMask ();
+      std::map<uint32_t, uint32_t>::iterator it = indexOfMask.find (mask.Get ());
+      if (it == indexOfMask.end ())
+        {
+          it = indexOfMask.insert (std::make_pair (mask.Get (), m_networkRouteIndex.size ())).first;
+          m_networkRouteIndex.push_back (NetworkRouteIndex ());
+          m_networkRouteIndex.back ().mask = mask;
+        }
+      uint32_t network = (*j)->GetDestNetwork ().CombineMask (mask).Get ();
+      m_networkRouteIndex[it->second].routes[network].push_back (*j);
+    }
+  std::stable_sort (m_networkRouteIndex.begin (), m_networkRouteIndex.end (),
+                    [] (const NetworkRouteIndex &a, const NetworkRouteIndex &b)
+                    {
+                      return a.mask.GetPrefixLength () > b.mask.GetPrefixLength ();
+                    });
+  m_lookupIndexValid = true;
+}
+
 Ptr<Ipv4Route>
 Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
 {
@@ -146,48 +192,41 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
-  NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  if (!m_lookupIndexValid)
+    {
+      BuildLookupIndex ();
+    }
+  // the routes of the host, or else of the longest matching prefix,
+  // leaving out those not on the requested interface
+  auto collect = [&] (const RouteVec &routes)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest () == dest)
+      for (RouteVec::const_iterator k = routes.begin (); k != routes.end (); k++)
         {
           if (oif != 0)
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
+              if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
                 {
                   NS_LOG_LOGIC ("Not on requested interface, skipping");
                   continue;
                 }
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
+          allRoutes.push_back (*k);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global route" << *k);
         }
+    };
+  std::unordered_map<uint32_t, RouteVec>::const_iterator host = m_hostRouteIndex.find (dest.Get ());
+  if (host != m_hostRouteIndex.end ())
+    {
+      collect (host->second);
     }
-  if (allRoutes.size () == 0) // if no host route is found
+  for (std::vector<NetworkRouteIndex>::const_iterator j = m_networkRouteIndex.begin ();
+       allRoutes.size () == 0 && j != m_networkRouteIndex.end ();
+       j++)
     {
-      NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      std::unordered_map<uint32_t, RouteVec>::const_iterator network = j->routes.find (dest.CombineMask (j->mask).Get ());
+      if (network != j->routes.end ())
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
-            {
-              if (oif != 0)
-                {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
-                }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
-            }
+          collect (network->second);
         }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
@@ -321,6 +360,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
               delete *i;
               m_hostRoutes.erase (i);
+              m_lookupIndexValid = false;
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
               return;
             }
@@ -338,6 +378,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
           delete *j;
           m_networkRoutes.erase (j);
+          m_lookupIndexValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -392,6 +433,9 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostRouteIndex.clear ();
+  m_networkRouteIndex.clear ();
+  m_lookupIndexValid = false;
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -544,6 +588,11 @@ Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
+      if (GlobalRouteBuilder::IsEnabled ())
+        {
+          GlobalRouteBuilder::Rebuild ();
+          return;
+        }
       GlobalRouteManager::DeleteGlobalRoutes ();
       GlobalRouteManager::BuildGlobalRoutingDatabase ();
       GlobalRouteManager::InitializeRoutes ();
@@ -556,6 +605,11 @@ Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
+      if (GlobalRouteBuilder::IsEnabled ())
+        {
+          GlobalRouteBuilder::NotifyInterfaceDown (m_ipv4->GetObject<Node> (), i);
+          return;
+        }
       GlobalRouteManager::DeleteGlobalRoutes ();
       GlobalRouteManager::BuildGlobalRoutingDatabase ();
       GlobalRouteManager::InitializeRoutes ();
@@ -568,6 +622,11 @@ Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress ad
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
+      if (GlobalRouteBuilder::IsEnabled ())
+        {
+          GlobalRouteBuilder::Rebuild ();
+          return;
+        }
       GlobalRouteManager::DeleteGlobalRoutes ();
       GlobalRouteManager::BuildGlobalRoutingDatabase ();
       GlobalRouteManager::InitializeRoutes ();
@@ -580,6 +639,11 @@ Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
+      if (GlobalRouteBuilder::IsEnabled ())
+        {
+          GlobalRouteBuilder::Rebuild ();
+          return;
+        }
       GlobalRouteManager::DeleteGlobalRoutes ();
       GlobalRouteManager::BuildGlobalRoutingDatabase ();
       GlobalRouteManager::InitializeRoutes ();
@@ -21,6 +21,8 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -65,6 +67,12 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * Destinations are matched against the host routes first, then against
+ * the network routes with the longest matching prefix, then against the
+ * AS external routes.  The host and network routes are indexed by hash
+ * tables, one per prefix length, rebuilt on the first lookup after the
+ * table changed, so that forwarding does not scan the route lists.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -236,6 +244,8 @@ private:
   bool m_randomEcmpRouting;
   /// Set to true if this interface should respond to interface events by globallly recomputing routes 
   bool m_respondToInterfaceEvents;
+  /// Set to true if the GlobalRouteBuilder may replace all the routes by a default route whenever they share the next hop
+  bool m_compactDefaultRoute;
   /// A uniform random number generator for randomly routing packets among ECMP 
   Ptr<UniformRandomVariable> m_rand;
 
@@ -267,11 +277,29 @@ private:
    * \return Ipv4Route to route the packet to reach dest address
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
+  /**
+   * \brief Index the host and network routes for LookupGlobal.
+   */
+  void BuildLookupIndex (void);
+
+  /// Routes to the same destination, in table order
+  typedef std::vector<Ipv4RoutingTableEntry *> RouteVec;
+
+  /// Network routes with the same mask
+  struct NetworkRouteIndex
+  {
+    Ipv4Mask mask;                                 //!< The mask
+    std::unordered_map<uint32_t, RouteVec> routes; //!< Routes by network address
+  };
 
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  bool m_lookupIndexValid;                                  //!< The indexes match the route lists
+  std::unordered_map<uint32_t, RouteVec> m_hostRouteIndex; //!< Host routes by destination
+  std::vector<NetworkRouteIndex> m_networkRouteIndex;       //!< Network routes, longest prefix first
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
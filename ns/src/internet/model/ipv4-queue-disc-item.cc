@@ -27,9 +27,12 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4QueueDiscItem");
 
 Ipv4QueueDiscItem::Ipv4QueueDiscItem (Ptr<Packet> p, const Address& addr,
                                       uint16_t protocol, const Ipv4Header & header)
-  : QueueDiscItem (p, addr, protocol),
+  : QueueDiscItem (std::move (p), addr, protocol),
     m_header (header),
-    m_headerAdded (false)
+    m_headerAdded (false),
+    m_flowHash (0),
+    m_flowHashZero (0),
+    m_flowHashComputed (false)
 {
 }
 
@@ -116,6 +119,11 @@ Ipv4QueueDiscItem::Hash (uint32_t perturbation) const
 {
   NS_LOG_FUNCTION (this << perturbation);
 
+  if (m_flowHashComputed)
+    {
+      return perturbation == 0 ? m_flowHashZero : PerturbHash (m_flowHash, perturbation);
+    }
+
   Ipv4Address src = m_header.GetSource ();
   Ipv4Address dest = m_header.GetDestination ();
   uint8_t prot = m_header.GetProtocol ();
@@ -143,8 +151,8 @@ Ipv4QueueDiscItem::Hash (uint32_t perturbation) const
       NS_LOG_WARN ("Unknown transport protocol, no port number included in hash computation");
     }
 
-  /* serialize the 5-tuple and the perturbation in buf */
-  uint8_t buf[17];
+  /* serialize the 5-tuple and a zero perturbation in buf */
+  uint8_t buf[17] = {};
   src.Serialize (buf);
   dest.Serialize (buf + 4);
   buf[8] = prot;
@@ -152,18 +160,17 @@ Ipv4QueueDiscItem::Hash (uint32_t perturbation) const
   buf[10] = srcPort & 0xff;
   buf[11] = (destPort >> 8) & 0xff;
   buf[12] = destPort & 0xff;
-  buf[13] = (perturbation >> 24) & 0xff;
-  buf[14] = (perturbation >> 16) & 0xff;
-  buf[15] = (perturbation >> 8) & 0xff;
-  buf[16] = perturbation & 0xff;
 
   // Linux calculates jhash2 (jenkins hash), we calculate murmur3 because it is
-  // already available in ns-3
-  uint32_t hash = Hash32 ((char*) buf, 17);
-
-  NS_LOG_DEBUG ("Hash value " << hash);
-
-  return hash;
+  // already available in ns-3.  Perturbation 0, the default of the fair
+  // queuing disciplines, keeps the Murmur3 hash of the 5-tuple and the
+  // perturbation, so that their mapping of flows to queues is unchanged.
+  m_flowHashZero = Hash32 ((char*) buf, 17);
+  m_flowHash = Hash64 ((char*) buf, 13);
+  m_flowHashComputed = true;
+  NS_LOG_DEBUG ("Hash value " << m_flowHash);
+
+  return perturbation == 0 ? m_flowHashZero : PerturbHash (m_flowHash, perturbation);
 }
 
 } // namespace ns3
@@ -88,7 +88,10 @@ public:
    *
    * Computes the hash of the source and destination IP addresses, protocol
    * number and, if the transport protocol is either UDP or TCP, the source
-   * and destination port
+   * and destination port. The 5-tuple is hashed once, on the first call.
+   * The hash of perturbation 0 is Murmur3 of the 5-tuple and the
+   * perturbation; the hashes of the other perturbations are derived from
+   * the 64-bit hash of the 5-tuple with QueueDiscItem::PerturbHash.
    *
    * \param perturbation hash perturbation value
    * \return the hash of the packet's 5-tuple
@@ -118,6 +121,9 @@ private:
 
   Ipv4Header m_header;  //!< The IPv4 header.
   bool m_headerAdded;   //!< True if the header has already been added to the packet.
+  mutable uint64_t m_flowHash;       //!< The hash of the 5-tuple, if computed.
+  mutable uint32_t m_flowHashZero;   //!< The hash of the 5-tuple for perturbation 0, if computed.
+  mutable bool m_flowHashComputed;   //!< True if the hash of the 5-tuple has been computed.
 };
 
 } // namespace ns3
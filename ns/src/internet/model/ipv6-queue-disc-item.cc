@@ -27,9 +27,12 @@ NS_LOG_COMPONENT_DEFINE ("Ipv6QueueDiscItem");
 
 Ipv6QueueDiscItem::Ipv6QueueDiscItem (Ptr<Packet> p, const Address& addr,
                                       uint16_t protocol, const Ipv6Header & header)
-  : QueueDiscItem (p, addr, protocol),
+  : QueueDiscItem (std::move (p), addr, protocol),
     m_header (header),
-    m_headerAdded (false)
+    m_headerAdded (false),
+    m_flowHash (0),
+    m_flowHashZero (0),
+    m_flowHashComputed (false)
 {
 }
 
@@ -115,6 +118,11 @@ Ipv6QueueDiscItem::Hash (uint32_t perturbation) const
 {
   NS_LOG_FUNCTION (this << perturbation);
 
+  if (m_flowHashComputed)
+    {
+      return perturbation == 0 ? m_flowHashZero : PerturbHash (m_flowHash, perturbation);
+    }
+
   Ipv6Address src = m_header.GetSource ();
   Ipv6Address dest = m_header.GetDestination ();
   uint8_t prot = m_header.GetNextHeader ();
@@ -141,8 +149,8 @@ Ipv6QueueDiscItem::Hash (uint32_t perturbation) const
       NS_LOG_WARN ("Unknown transport protocol, no port number included in hash computation");
     }
 
-  /* serialize the 5-tuple and the perturbation in buf */
-  uint8_t buf[41];
+  /* serialize the 5-tuple and a zero perturbation in buf */
+  uint8_t buf[41] = {};
   src.Serialize (buf);
   dest.Serialize (buf + 16);
   buf[32] = prot;
@@ -150,18 +158,17 @@ Ipv6QueueDiscItem::Hash (uint32_t perturbation) const
   buf[34] = srcPort & 0xff;
   buf[35] = (destPort >> 8) & 0xff;
   buf[36] = destPort & 0xff;
-  buf[37] = (perturbation >> 24) & 0xff;
-  buf[38] = (perturbation >> 16) & 0xff;
-  buf[39] = (perturbation >> 8) & 0xff;
-  buf[40] = perturbation & 0xff;
 
   // Linux calculates jhash2 (jenkins hash), we calculate murmur3 because it is
-  // already available in ns-3
-  uint32_t hash = Hash32 ((char*) buf, 41);
-
-  NS_LOG_DEBUG ("Found Ipv6 packet; hash of the five tuple " << hash);
-
-  return hash;
+  // already available in ns-3.  Perturbation 0, the default of the fair
+  // queuing disciplines, keeps the Murmur3 hash of the 5-tuple and the
+  // perturbation, so that their mapping of flows to queues is unchanged.
+  m_flowHashZero = Hash32 ((char*) buf, 41);
+  m_flowHash = Hash64 ((char*) buf, 37);
+  m_flowHashComputed = true;
+  NS_LOG_DEBUG ("Found Ipv6 packet; hash of the five tuple " << m_flowHash);
+
+  return perturbation == 0 ? m_flowHashZero : PerturbHash (m_flowHash, perturbation);
 }
 
 } // namespace ns3
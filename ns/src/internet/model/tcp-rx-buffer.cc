@@ -22,6 +22,8 @@
 #include "ns3/log.h"
 #include "tcp-rx-buffer.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TcpRxBuffer");
@@ -113,9 +115,9 @@ TcpRxBuffer::MaxRxSequence (void) const
     { // No data allowed beyond FIN
       return m_finSeq;
     }
-  else if (m_data.size () && m_nextRxSeq > m_data.begin ()->first)
+  else if (m_data.size () && m_nextRxSeq > m_data.front ().first)
     { // No data allowed beyond Rx window allowed
-      return m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      return m_data.front ().first + SequenceNumber32 (m_maxBuffer);
     }
   return m_nextRxSeq + SequenceNumber32 (m_maxBuffer);
 }
@@ -151,30 +153,38 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   if (headSeq < m_nextRxSeq) headSeq = m_nextRxSeq;
   if (m_data.size ())
     {
-      SequenceNumber32 maxSeq = m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      SequenceNumber32 maxSeq = m_data.front ().first + SequenceNumber32 (m_maxBuffer);
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
+  // Remove overlapped bytes from packet.  The segments are sorted and do
+  // not overlap, so the first one which can overlap is the first ending
+  // after headSeq, and the segments embedded in the packet are consecutive.
+  uint32_t i = FindSegment (headSeq);
+  uint32_t embeddedBegin = i;
+  uint32_t embeddedEnd = i;
+  while (i < m_data.size () && m_data[i].first <= tailSeq)
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
+      SequenceNumber32 lastByteSeq = m_data[i].first + SequenceNumber32 (m_data[i].second->GetSize ());
       if (lastByteSeq > headSeq)
         {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
+          if (m_data[i].first > headSeq && lastByteSeq < tailSeq)
             { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
+              if (embeddedBegin == embeddedEnd)
+                {
+                  embeddedBegin = i;
+                }
+              embeddedEnd = i + 1;
+              ++i;
               continue;
             }
-          if (i->first <= headSeq)
+          if (m_data[i].first <= headSeq)
             { // Incoming head is overlapped
               headSeq = lastByteSeq;
             }
           if (lastByteSeq >= tailSeq)
             { // Incoming tail is overlapped
-              tailSeq = i->first;
+              tailSeq = m_data[i].first;
             }
         }
       ++i;
@@ -192,9 +202,16 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       p = p->CreateFragment (start, length);
       NS_ASSERT (length == p->GetSize ());
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
+  // Replace the embedded packets, if any, and insert packet into buffer
+  for (i = embeddedBegin; i < embeddedEnd; ++i)
+    {
+      m_size -= m_data[i].second->GetSize ();
+    }
+  m_data.erase (m_data.begin () + embeddedBegin, m_data.begin () + embeddedEnd);
+  uint32_t pos = FindSegment (headSeq);
+  NS_ASSERT (pos == m_data.size () || m_data[pos].first >= tailSeq); // Shouldn't be there yet
+  m_data.insert (m_data.begin () + pos, Segment (headSeq, p));
+  TcpOptionSack::SackBlock range = AddRange (headSeq, tailSeq);
 
   if (headSeq > m_nextRxSeq)
     {
@@ -205,18 +222,10 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (i = m_data.begin (); i != m_data.end (); ++i)
-    {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+  if (range.first <= m_nextRxSeq && m_nextRxSeq < range.second)
+    { // The packet joined the contiguous data at the head of the buffer
+      m_availBytes += static_cast<uint32_t> (range.second - m_nextRxSeq);
+      m_nextRxSeq = range.second;
       ClearSackList (m_nextRxSeq);
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -227,6 +236,59 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   return true;
 }
 
+uint32_t
+TcpRxBuffer::FindSegment (const SequenceNumber32 &seq) const
+{
+  // The segments do not overlap, so their ends are sorted like their starts
+  uint32_t low = 0;
+  uint32_t high = static_cast<uint32_t> (m_data.size ());
+  while (low < high)
+    {
+      uint32_t mid = low + (high - low) / 2;
+      if (m_data[mid].first + SequenceNumber32 (m_data[mid].second->GetSize ()) > seq)
+        {
+          high = mid;
+        }
+      else
+        {
+          low = mid + 1;
+        }
+    }
+  return low;
+}
+
+TcpOptionSack::SackBlock
+TcpRxBuffer::AddRange (const SequenceNumber32 &head, const SequenceNumber32 &tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+
+  // The first range ending at or after head is the first one which the new
+  // data overlaps or touches; it is merged with the following ones which
+  // start at or before tail
+  std::deque<TcpOptionSack::SackBlock>::iterator first =
+    std::lower_bound (m_ranges.begin (), m_ranges.end (), head,
+                      [] (const TcpOptionSack::SackBlock &range, const SequenceNumber32 &seq)
+                      { return range.second < seq; });
+  std::deque<TcpOptionSack::SackBlock>::iterator last = first;
+  TcpOptionSack::SackBlock merged (head, tail);
+  while (last != m_ranges.end () && last->first <= tail)
+    {
+      merged.first = std::min (merged.first, last->first);
+      merged.second = std::max (merged.second, last->second);
+      ++last;
+    }
+  if (first == last)
+    {
+      m_ranges.insert (first, merged);
+    }
+  else
+    {
+      *first = merged;
+      m_ranges.erase (first + 1, last);
+    }
+  return merged;
+}
+
 uint32_t
 TcpRxBuffer::GetSackListSize () const
 {
@@ -360,6 +422,17 @@ TcpRxBuffer::GetSackList () const
   return m_sackList;
 }
 
+void
+TcpRxBuffer::AddSackBlocks (Ptr<TcpOptionSack> option, uint32_t maxBlocks) const
+{
+  TcpOptionSack::SackList::const_iterator it;
+  for (it = m_sackList.begin (); maxBlocks > 0 && it != m_sackList.end (); ++it)
+    {
+      option->AddSackBlock (*it);
+      --maxBlocks;
+    }
+}
+
 Ptr<Packet>
 TcpRxBuffer::Extract (uint32_t maxSize)
 {
@@ -370,26 +443,32 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   if (extractSize == 0) return nullptr;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
   Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
+  // The extracted data is all at the beginning of the first range
+  NS_ASSERT (m_ranges.front ().second - m_ranges.front ().first >= static_cast<int32_t> (extractSize));
+  m_ranges.front ().first = m_ranges.front ().first + SequenceNumber32 (extractSize);
+  if (m_ranges.front ().first == m_ranges.front ().second)
+    {
+      m_ranges.pop_front ();
+    }
   while (extractSize)
     { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+      Segment &front = m_data.front ();
+      NS_ASSERT (front.first <= m_nextRxSeq); // in-sequence data expected
       // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
+      uint32_t pktSize = front.second->GetSize ();
       if (pktSize <= extractSize)
         { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
+          outPkt->AddAtEnd (front.second);
+          m_data.pop_front ();
           m_size -= pktSize;
           m_availBytes -= pktSize;
           extractSize -= pktSize;
         }
       else
         { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
+          outPkt->AddAtEnd (front.second->CreateFragment (0, extractSize));
+          front.second = front.second->CreateFragment (extractSize, pktSize - extractSize);
+          front.first = front.first + SequenceNumber32 (extractSize);
           m_size -= extractSize;
           m_availBytes -= extractSize;
           extractSize = 0;
@@ -21,7 +21,7 @@
 #ifndef TCP_RX_BUFFER_H
 #define TCP_RX_BUFFER_H
 
-#include <map>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
@@ -53,6 +53,13 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * The segments are kept in a deque sorted by sequence number, next to the
+ * ranges of contiguous data they cover, so that a segment is placed, and
+ * the data it makes available found, with binary searches instead of a
+ * walk over the whole out-of-order window.  The segments are never merged:
+ * adjacent ones are only joined in the ranges, and the data is copied once,
+ * by Extract.
+ *
  * SACK list
  * ---------
  *
@@ -181,6 +188,16 @@ public:
    */
   bool GotFin () const { return m_gotFin; }
 
+  /**
+   * \brief Add the first blocks of the sack list to a SACK option
+   *
+   * Equivalent to adding the blocks of GetSackList, without copying the list.
+   *
+   * \param option the SACK option
+   * \param maxBlocks the maximum number of blocks to add
+   */
+  void AddSackBlocks (Ptr<TcpOptionSack> option, uint32_t maxBlocks) const;
+
 private:
   /**
    * \brief Update the sack list, with the block seq starting at the beginning
@@ -215,17 +232,35 @@ private:
    */
   void ClearSackList (const SequenceNumber32 &seq);
 
+  /**
+   * \brief Find the first buffered segment ending after a sequence number
+   *
+   * \param seq the sequence number
+   * \return the index of the segment in m_data, or its size if none
+   */
+  uint32_t FindSegment (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Add new data to the ranges of contiguous data
+   *
+   * \param head sequence number of the first byte of the data
+   * \param tail sequence number following the last byte of the data
+   * \return the range now containing the data
+   */
+  TcpOptionSack::SackBlock AddRange (const SequenceNumber32 &head, const SequenceNumber32 &tail);
+
   TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
-  /// container for data stored in the buffer
-  typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  /// A buffered segment: its first sequence number and its data
+  typedef std::pair<SequenceNumber32, Ptr<Packet> > Segment;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  std::deque<Segment> m_data;                //!< Buffered segments, sorted and not overlapping
+  std::deque<TcpOptionSack::SackBlock> m_ranges; //!< Ranges of contiguous data in m_data, sorted
 };
 
 } //namespace ns3
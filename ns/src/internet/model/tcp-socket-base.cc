@@ -4197,8 +4197,7 @@ TcpSocketBase::AddOptionSack (TcpHeader& header)
   uint8_t optionLenAvail = header.GetMaxOptionLength () - header.GetOptionLength ();
   uint8_t allowedSackBlocks = (optionLenAvail - 2) / 8;
 
-  TcpOptionSack::SackList sackList = m_tcb->m_rxBuffer->GetSackList ();
-  if (allowedSackBlocks == 0 || sackList.empty ())
+  if (allowedSackBlocks == 0 || m_tcb->m_rxBuffer->GetSackListSize () == 0)
     {
       NS_LOG_LOGIC ("No space available or sack list empty, not adding sack blocks");
       return;
@@ -4206,12 +4205,7 @@ TcpSocketBase::AddOptionSack (TcpHeader& header)
 
   // Append the allowed number of SACK blocks
   Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
-  TcpOptionSack::SackList::iterator i;
-  for (i = sackList.begin (); allowedSackBlocks > 0 && i != sackList.end (); ++i)
-    {
-      option->AddSackBlock (*i);
-      allowedSackBlocks--;
-    }
+  m_tcb->m_rxBuffer->AddSackBlocks (option, allowedSackBlocks);
 
   header.AppendOption (option);
   NS_LOG_INFO (m_node->GetId () << " Add option SACK " << *option);
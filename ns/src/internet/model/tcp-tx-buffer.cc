@@ -58,28 +58,14 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n)
+  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n),
+    m_highestSack (false, SequenceNumber32 (0))
 {
   m_rWndCallback = MakeNullCallback<uint32_t> ();
 }
 
 TcpTxBuffer::~TcpTxBuffer (void)
 {
-  PacketList::iterator it;
-
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
-    {
-      TcpTxItem *item = *it;
-      m_sentSize -= item->m_packet->GetSize ();
-      delete item;
-    }
-
-  for (it = m_appList.begin (); it != m_appList.end (); ++it)
-    {
-      TcpTxItem *item = *it;
-      m_size -= item->m_packet->GetSize ();
-      delete item;
-    }
 }
 
 SequenceNumber32
@@ -166,14 +152,14 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
   NS_LOG_FUNCTION (this << seq);
   m_firstByteSeq = seq;
 
-  if (m_sentList.size () > 0)
+  if (!m_sentList.IsEmpty ())
     {
-      m_sentList.front ()->m_startSeq = seq;
+      m_sentList.Front ().m_startSeq = seq;
     }
 
   // if you change the head with data already sent, something bad will happen
-  NS_ASSERT (m_sentList.size () == 0);
-  m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  NS_ASSERT (m_sentList.IsEmpty ());
+  m_highestSack = std::make_pair (false, SequenceNumber32 (0));
 }
 
 bool
@@ -186,9 +172,9 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          TcpTxItem *item = new TcpTxItem ();
-          item->m_packet = p->Copy ();
-          m_appList.insert (m_appList.end (), item);
+          TcpTxItem item;
+          item.m_packet = p->Copy ();
+          m_appList.PushBack (item);
           m_size += p->GetSize ();
 
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" <<
@@ -291,12 +277,12 @@ TcpTxBuffer::GetNewSegment (uint32_t numBytes)
                                        numBytes, startOfAppList);
   item->m_startSeq = startOfAppList;
 
-  // Move item from AppList to SentList (should be the first, not too complex)
-  auto it = std::find (m_appList.begin (), m_appList.end (), item);
-  NS_ASSERT (it != m_appList.end ());
+  // Move item from AppList to SentList (it is always the first)
+  NS_ASSERT (item == &m_appList.Front ());
 
-  m_appList.erase (it);
-  m_sentList.insert (m_sentList.end (), item);
+  m_sentList.PushBack (*item);
+  m_appList.PopFront ();
+  item = &m_sentList.Back ();
   m_sentSize += item->m_packet->GetSize ();
 
   return item;
@@ -308,38 +294,34 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
   NS_LOG_FUNCTION (this << numBytes << seq);
   NS_ASSERT (seq >= m_firstByteSeq);
   NS_ASSERT (numBytes <= m_sentSize);
-  NS_ASSERT (m_sentList.size () >= 1);
+  NS_ASSERT (m_sentList.Size () >= 1);
 
-  auto it = m_sentList.begin ();
+  uint32_t i = FindSentItem (seq);
   bool listEdited = false;
   uint32_t s = numBytes;
 
   // Avoid to merge different packet for this retransmission if flags are
   // different.
-  for (; it != m_sentList.end(); ++it)
+  if (m_sentList[i].m_startSeq == seq)
     {
-      if ((*it)->m_startSeq == seq)
+      const TcpTxItem &item = m_sentList[i];
+      if (i + 1 < m_sentList.Size ())
         {
-          auto next = it;
-          next++;
-          if (next != m_sentList.end ())
+          const TcpTxItem &next = m_sentList[i + 1];
+          // Next is not sacked and have the same value for m_lost ... there is the possibility to merge
+          if ((! next.m_sacked) && (item.m_lost == next.m_lost))
             {
-              // Next is not sacked and have the same value for m_lost ... there is the possibility to merge
-              if ((! (*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                  s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
-                }
-              else
-                {
-                  // Next is sacked... better to retransmit only the first segment
-                  s = std::min(s, (*it)->m_packet->GetSize ());
-                }
+              s = std::min(s, item.m_packet->GetSize () + next.m_packet->GetSize ());
             }
           else
             {
-              s = std::min(s, (*it)->m_packet->GetSize ());
+              // Next is sacked... better to retransmit only the first segment
+              s = std::min(s, item.m_packet->GetSize ());
             }
-          break;
+        }
+      else
+        {
+          s = std::min(s, item.m_packet->GetSize ());
         }
     }
 
@@ -354,26 +336,25 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
   return item;
 }
 
-std::pair <TcpTxBuffer::PacketList::const_iterator, SequenceNumber32>
-TcpTxBuffer::FindHighestSacked () const
+uint32_t
+TcpTxBuffer::FindSentItem (const SequenceNumber32 &seq) const
 {
-  NS_LOG_FUNCTION (this);
-
-  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
-  auto ret = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
-
-  for (auto it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // The items are contiguous: look for the last one starting at or before seq
+  uint32_t low = 0;
+  uint32_t high = m_sentList.Size ();
+  while (low < high)
     {
-      const TcpTxItem *item = *it;
-      if (item->m_sacked)
+      uint32_t mid = low + (high - low) / 2;
+      if (m_sentList[mid].m_startSeq <= seq)
+        {
+          low = mid + 1;
+        }
+      else
         {
-          ret = std::make_pair (it, beginOfCurrentPacket);
+          high = mid;
         }
-      beginOfCurrentPacket += item->m_packet->GetSize ();
     }
-
-  return ret;
+  return low > 0 ? low - 1 : 0;
 }
 
 
@@ -434,14 +415,21 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
   Ptr<Packet> currentPacket = nullptr;
   TcpTxItem *currentItem = nullptr;
   TcpTxItem *outItem = nullptr;
-  PacketList::iterator it = list.begin ();
+  uint32_t it = 0;
   SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
-  while (it != list.end ())
+  if (&list == &m_sentList && !list.IsEmpty ())
     {
-      currentItem = *it;
+      // The sent items know their sequence number: skip to the one holding seq
+      it = FindSentItem (seq);
+      beginOfCurrentPacket = list[it].m_startSeq;
+    }
+
+  while (it != list.Size ())
+    {
+      currentItem = &list[it];
       currentPacket = currentItem->m_packet;
-      NS_ASSERT_MSG (list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+      NS_ASSERT_MSG (&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                      "start: " << m_firstByteSeq << " currentItem start: " <<
                      currentItem->m_startSeq);
 
@@ -467,11 +455,11 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
                            " searching for " << seq <<
                            " and now we recurse because packet ends at "
                                         << beginOfCurrentPacket + currentPacket->GetSize ());
-              TcpTxItem *firstPart = new TcpTxItem ();
-              SplitItems (firstPart, currentItem, seq - beginOfCurrentPacket);
+              TcpTxItem firstPart;
+              SplitItems (&firstPart, currentItem, seq - beginOfCurrentPacket);
 
               // insert firstPart before currentItem
-              list.insert (it, firstPart);
+              list.Insert (it, firstPart);
               if (listEdited)
                 {
                   *listEdited = true;
@@ -514,13 +502,11 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
                   // the end is exactly the end of current packet, but
                   // current > outPacket in the list. Merge current with the
                   // previous, and recurse.
-                  NS_ASSERT (it != list.begin ());
-                  TcpTxItem *previous = *(--it);
-
-                  list.erase (it);
+                  NS_ASSERT (it != 0);
+                  TcpTxItem *previous = &list[it - 1];
 
                   MergeItems (previous, currentItem);
-                  delete currentItem;
+                  list.Erase (it);
                   if (listEdited)
                     {
                       *listEdited = true;
@@ -533,24 +519,24 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
             {
               // the end is inside the current packet, but it isn't exactly
               // the packet end. Just fragment, fix the list, and return.
-              TcpTxItem *firstPart = new TcpTxItem ();
-              SplitItems (firstPart, currentItem, numBytes);
+              TcpTxItem firstPart;
+              SplitItems (&firstPart, currentItem, numBytes);
 
               // insert firstPart before currentItem
-              list.insert (it, firstPart);
+              list.Insert (it, firstPart);
               if (listEdited)
                 {
                   *listEdited = true;
                 }
 
-              return firstPart;
+              return &list[it];
             }
         }
       else
         {
           // The end isn't inside current packet, but there is an exception for
           // the merge and recurse strategy...
-          if (++it == list.end ())
+          if (++it == list.Size ())
             {
               // ...current is the last packet we sent. We have not more data;
               // Go for this one.
@@ -562,13 +548,11 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
 
           // The current packet does not contain the requested end. Merge current
           // with the packet that follows, and recurse
-          TcpTxItem *next = (*it); // Please remember we have incremented it
-                                   // in the previous if
+          TcpTxItem *next = &list[it]; // Please remember we have incremented it
+                                       // in the previous if
 
           MergeItems (currentItem, next);
-          list.erase (it);
-
-          delete next;
+          list.Erase (it);
 
           if (listEdited)
             {
@@ -650,16 +634,13 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked (const SequenceNumber32& ack) const
 {
   NS_LOG_FUNCTION (this);
-  for (const auto &it : m_sentList)
-     {
-       TcpTxItem *item = it;
-       Ptr<Packet> p = item->m_packet;
-       if (item->m_startSeq + p->GetSize () == ack && !item->m_sacked && item->m_retrans)
-         {
-           return true;
-         }
-     }
-  return false;
+  if (m_sentList.IsEmpty () || ack <= m_firstByteSeq)
+    {
+      return false;
+    }
+  // Only the item holding the byte before ack can end at ack
+  const TcpTxItem &item = m_sentList[FindSentItem (ack - 1)];
+  return item.m_startSeq + item.m_packet->GetSize () == ack && !item.m_sacked && item.m_retrans;
 }
 
 void
@@ -680,19 +661,17 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
   // Scan the buffer and discard packets
   uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
   uint32_t pktSize;
-  PacketList::iterator i = m_sentList.begin ();
   while (m_size > 0 && offset > 0)
     {
-      if (i == m_sentList.end ())
+      if (m_sentList.IsEmpty ())
         {
           // Move data from app list to sent list, so we can delete the item
           Ptr<Packet> p = CopyFromSequence (offset, m_firstByteSeq)->GetPacketCopy ();
           NS_ASSERT (p != nullptr);
           NS_UNUSED (p);
-          i = m_sentList.begin ();
-          NS_ASSERT (i != m_sentList.end ());
+          NS_ASSERT (!m_sentList.IsEmpty ());
         }
-      TcpTxItem *item = *i;
+      TcpTxItem *item = &m_sentList.Front ();
       Ptr<Packet> p = item->m_packet;
       pktSize = p->GetSize ();
       NS_ASSERT_MSG (item->m_startSeq == m_firstByteSeq,
@@ -708,7 +687,6 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
 
           RemoveFromCounts (item, pktSize);
 
-          i = m_sentList.erase (i);
           NS_LOG_INFO ("Removed " << *item << " lost: " << m_lostOut <<
                        " retrans: " << m_retrans << " sacked: " << m_sackedOut <<
                        ". Remaining data " << m_size);
@@ -719,7 +697,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
               beforeDelCb (item);
             }
 
-          delete item;
+          m_sentList.PopFront ();
         }
       else if (offset > 0)
         { // Part of the packet is behind the seqnum. Fragment
@@ -746,9 +724,9 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
       m_firstByteSeq = seq;
     }
 
-  if (!m_sentList.empty ())
+  if (!m_sentList.IsEmpty ())
     {
-      TcpTxItem *head = m_sentList.front ();
+      TcpTxItem *head = &m_sentList.Front ();
       if (head->m_sacked)
         {
           NS_ASSERT (!head->m_lost);
@@ -769,7 +747,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
 
   if (m_highestSack.second <= m_firstByteSeq)
     {
-      m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+      m_highestSack = std::make_pair (false, SequenceNumber32 (0));
     }
 
   NS_LOG_DEBUG ("Discarded up to " << seq << " lost: " << m_lostOut <<
@@ -791,18 +769,24 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
 
   for (auto option_it = list.begin (); option_it != list.end (); ++option_it)
     {
-      PacketList::iterator item_it = m_sentList.begin ();
-      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
       if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
           NS_LOG_INFO ("Not updating scoreboard, the option block is outside the sent list");
           return bytesSacked;
         }
 
-      while (item_it != m_sentList.end ())
+      // Start from the item holding the beginning of the block
+      uint32_t i = FindSentItem ((*option_it).first);
+      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
+      if (!m_sentList.IsEmpty ())
+        {
+          beginOfCurrentPacket = m_sentList[i].m_startSeq;
+        }
+
+      while (i < m_sentList.Size ())
         {
-          uint32_t pktSize = (*item_it)->m_packet->GetSize ();
+          TcpTxItem *item = &m_sentList[i];
+          uint32_t pktSize = item->m_packet->GetSize ();
 
           // Check the boundary of this packet ... only mark as sacked if
           // it is precisely mapped over the option. It means that if the receiver
@@ -812,39 +796,39 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
           if (beginOfCurrentPacket >= (*option_it).first
               && beginOfCurrentPacket + pktSize <= (*option_it).second)
             {
-              if ((*item_it)->m_sacked)
+              if (item->m_sacked)
                 {
-                  NS_ASSERT (!(*item_it)->m_lost);
+                  NS_ASSERT (!item->m_lost);
                   NS_LOG_INFO ("Received block " << *option_it <<
-                               ", checking sentList for block " << *(*item_it) <<
+                               ", checking sentList for block " << *item <<
                                ", found in the sackboard already sacked");
                 }
               else
                 {
-                  if ((*item_it)->m_lost)
+                  if (item->m_lost)
                     {
-                      (*item_it)->m_lost = false;
-                      m_lostOut -= (*item_it)->m_packet->GetSize ();
+                      item->m_lost = false;
+                      m_lostOut -= item->m_packet->GetSize ();
                     }
 
-                  (*item_it)->m_sacked = true;
-                  m_sackedOut += (*item_it)->m_packet->GetSize ();
-                  bytesSacked += (*item_it)->m_packet->GetSize ();
+                  item->m_sacked = true;
+                  m_sackedOut += item->m_packet->GetSize ();
+                  bytesSacked += item->m_packet->GetSize ();
 
-                  if (m_highestSack.first == m_sentList.end()
+                  if (!m_highestSack.first
                       || m_highestSack.second <= beginOfCurrentPacket + pktSize)
                     {
-                      m_highestSack = std::make_pair (item_it, beginOfCurrentPacket);
+                      m_highestSack = std::make_pair (true, beginOfCurrentPacket);
                     }
 
                   NS_LOG_INFO ("Received block " << *option_it <<
-                               ", checking sentList for block " << *(*item_it) <<
+                               ", checking sentList for block " << *item <<
                                ", found in the sackboard, sacking, current highSack: " <<
                                m_highestSack.second);
 
                   if (!sackedCb.IsNull ())
                     {
-                      sackedCb (*item_it);
+                      sackedCb (item);
                     }
                 }
             }
@@ -852,23 +836,23 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
             {
               // We already passed the received block end. Exit from the loop
               NS_LOG_INFO ("Received block [" << *option_it <<
-                           ", checking sentList for block " << *(*item_it) <<
+                           ", checking sentList for block " << *item <<
                            "], not found, breaking loop");
               break;
             }
 
           beginOfCurrentPacket += pktSize;
-          ++item_it;
+          ++i;
         }
     }
 
   if (bytesSacked > 0)
     {
-      NS_ASSERT_MSG (m_highestSack.first != m_sentList.end(), "Buffer status: " << *this);
+      NS_ASSERT_MSG (m_highestSack.first, "Buffer status: " << *this);
       UpdateLostCount ();
     }
 
-  NS_ASSERT ((*(m_sentList.begin ()))->m_sacked == false);
+  NS_ASSERT (m_sentList.Front ().m_sacked == false);
   NS_ASSERT_MSG (m_sentSize >= m_sackedOut + m_lostOut, *this);
   //NS_ASSERT (list.size () == 0 || modified);   // Assert for duplicated SACK or
                                                  // impossiblity to map the option into the sent blocks
@@ -882,20 +866,13 @@ TcpTxBuffer::UpdateLostCount ()
   NS_LOG_FUNCTION (this);
   uint32_t sacked = 0;
   SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
-  if (m_highestSack.first == m_sentList.end ())
-    {
-      NS_LOG_INFO ("Status before the update: " << *this <<
-                   ", will start from the latest sent item");
-    }
-  else
-    {
-      NS_LOG_INFO ("Status before the update: " << *this <<
-                   ", will start from item " << *(*m_highestSack.first));
-    }
+  uint32_t highestSack = FindSentItem (m_highestSack.second);
+  NS_LOG_INFO ("Status before the update: " << *this <<
+               ", will start from item " << m_sentList[highestSack]);
 
-  for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+  for (uint32_t i = highestSack; i != 0; --i)
     {
-      TcpTxItem *item = *it;
+      TcpTxItem *item = &m_sentList[i];
       if (item->m_sacked)
         {
           sacked++;
@@ -914,7 +891,7 @@ TcpTxBuffer::UpdateLostCount ()
 
   if (sacked >= m_dupAckThresh)
     {
-      TcpTxItem *item = *m_sentList.begin ();
+      TcpTxItem *item = &m_sentList.Front ();
       if (!item->m_lost)
         {
           item->m_lost = true;
@@ -930,35 +907,32 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
 {
   NS_LOG_FUNCTION (this << seq);
 
-  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-  PacketList::const_iterator it;
-
-  if (seq >= m_highestSack.second)
+  if (seq >= m_highestSack.second || m_sentList.IsEmpty ())
     {
       return false;
     }
 
-  // In theory, using a map and hints when inserting elements can improve
-  // performance
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // Start from the first item beginning at or after seq
+  uint32_t i = FindSentItem (seq);
+  if (m_sentList[i].m_startSeq < seq)
     {
-      // Search for the right iterator before calling IsLost()
-      if (beginOfCurrentPacket >= seq)
-        {
-          if ((*it)->m_lost == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
-              return true;
-            }
+      ++i;
+    }
 
-          if ((*it)->m_sacked == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
-              return false;
-            }
+  for (; i < m_sentList.Size (); ++i)
+    {
+      const TcpTxItem &item = m_sentList[i];
+      if (item.m_lost == true)
+        {
+          NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
+          return true;
         }
 
-      beginOfCurrentPacket += (*it)->m_packet->GetSize ();
+      if (item.m_sacked == true)
+        {
+          NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
+          return false;
+        }
     }
 
   return false;
@@ -982,15 +956,14 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, SequenceNumber32 *seqHigh, bool isR
    *
    *     (1.c) IsLost (S2) returns true.
    */
-  PacketList::const_iterator it;
-  TcpTxItem *item;
+  const TcpTxItem *item;
   SequenceNumber32 seqPerRule3;
   bool isSeqPerRule3Valid = false;
   SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
 
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  for (uint32_t i = 0; i < m_sentList.Size (); ++i)
     {
-      item = *it;
+      item = &m_sentList[i];
 
       // Condition 1.a , 1.b , and 1.c
       if (item->m_retrans == false && item->m_sacked == false)
@@ -1095,8 +1068,7 @@ TcpTxBuffer::BytesInFlight () const
 uint32_t
 TcpTxBuffer::BytesInFlightRFC () const
 {
-  PacketList::const_iterator it;
-  TcpTxItem *item;
+  const TcpTxItem *item;
   uint32_t size = 0; // "pipe" in RFC
   SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
   uint32_t sackedOut = 0;
@@ -1107,13 +1079,13 @@ TcpTxBuffer::BytesInFlightRFC () const
   // After initializing pipe to zero, the following steps are taken for each
   // octet 'S1' in the sequence space between HighACK and HighData that has not
   // been SACKed:
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  for (uint32_t i = 0; i < m_sentList.Size (); ++i)
     {
-      item = *it;
+      item = &m_sentList[i];
       totalSize += item->m_packet->GetSize();
       if (!item->m_sacked)
         {
-          bool isLost = IsLostRFC (beginOfCurrentPkt, it);
+          bool isLost = IsLostRFC (beginOfCurrentPkt, i);
           // (a) If IsLost (S1) returns false: Pipe is incremented by 1 octet.
           if (!isLost)
             {
@@ -1157,17 +1129,17 @@ TcpTxBuffer::BytesInFlightRFC () const
 }
 
 bool
-TcpTxBuffer::IsLostRFC (const SequenceNumber32 &seq, const PacketList::const_iterator &segment) const
+TcpTxBuffer::IsLostRFC (const SequenceNumber32 &seq, uint32_t segment) const
 {
   NS_LOG_FUNCTION (this << seq);
   uint32_t count = 0;
   uint32_t bytes = 0;
-  PacketList::const_iterator it;
-  TcpTxItem *item;
+  uint32_t it;
+  const TcpTxItem *item;
   Ptr<const Packet> current;
   SequenceNumber32 beginOfCurrentPacket = seq;
 
-  if ((*segment)->m_sacked == true)
+  if (m_sentList[segment].m_sacked == true)
     {
       return false;
     }
@@ -1177,9 +1149,9 @@ TcpTxBuffer::IsLostRFC (const SequenceNumber32 &seq, const PacketList::const_ite
   // > sequences have arrived above 'seq' or more than (dupThresh - 1) * SMSS bytes
   // > with sequence numbers greater than 'SeqNum' have been SACKed.  Otherwise, the
   // > routine returns false.
-  for (it = segment; it != m_sentList.end (); ++it)
+  for (it = segment; it != m_sentList.Size (); ++it)
     {
-      item = *it;
+      item = &m_sentList[it];
       current = item->m_packet;
 
       if (item->m_sacked)
@@ -1206,7 +1178,7 @@ TcpTxBuffer::IsLostRFC (const SequenceNumber32 &seq, const PacketList::const_ite
 
       beginOfCurrentPacket += current->GetSize ();
     }
-  if (it == m_highestSack.first)
+  if (!m_highestSack.first)
     {
       NS_LOG_INFO ("seq=" << seq << " is not lost because there are no sacked segment ahead " << m_highestSack.second);
     }
@@ -1219,12 +1191,12 @@ TcpTxBuffer::ResetRenoSack ()
   NS_LOG_FUNCTION (this);
 
   m_sackedOut = 0;
-  for (auto it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  for (uint32_t i = 0; i < m_sentList.Size (); ++i)
     {
-      (*it)->m_sacked = false;
+      m_sentList[i].m_sacked = false;
     }
 
-  m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_highestSack = std::make_pair (false, SequenceNumber32 (0));
 }
 
 void
@@ -1241,36 +1213,36 @@ TcpTxBuffer::ResetSentList ()
   TcpTxItem *item;
 
   // Keep the head items; they will then marked as lost
-  while (m_sentList.size () > 0)
+  while (!m_sentList.IsEmpty ())
     {
-      item = m_sentList.back ();
+      item = &m_sentList.Back ();
       item->m_retrans = item->m_sacked = item->m_lost = false;
-      m_appList.push_front (item);
-      m_sentList.pop_back ();
+      m_appList.PushFront (*item);
+      m_sentList.PopBack ();
     }
 
   m_sentSize = 0;
   m_lostOut = 0;
   m_retrans = 0;
   m_sackedOut = 0;
-  m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_highestSack = std::make_pair (false, SequenceNumber32 (0));
 }
 
 void
 TcpTxBuffer::ResetLastSegmentSent ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_sentList.empty ())
+  if (!m_sentList.IsEmpty ())
     {
-      TcpTxItem *item = m_sentList.back ();
+      TcpTxItem *item = &m_sentList.Back ();
 
-      m_sentList.pop_back ();
       m_sentSize -= item->m_packet->GetSize ();
       if (item->m_retrans)
         {
           m_retrans -= item->m_packet->GetSize ();
         }
-      m_appList.insert (m_appList.begin (), item);
+      m_appList.PushFront (*item);
+      m_sentList.PopBack ();
     }
   ConsistencyCheck ();
 }
@@ -1285,36 +1257,37 @@ TcpTxBuffer::SetSentListLost (bool resetSack)
     {
       m_sackedOut = 0;
       m_lostOut = m_sentSize;
-      m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+      m_highestSack = std::make_pair (false, SequenceNumber32 (0));
     }
   else
     {
       m_lostOut = 0;
     }
 
-  for (auto it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  for (uint32_t i = 0; i < m_sentList.Size (); ++i)
     {
+      TcpTxItem *item = &m_sentList[i];
       if (resetSack)
         {
-          (*it)->m_sacked = false;
-          (*it)->m_lost = true;
+          item->m_sacked = false;
+          item->m_lost = true;
         }
       else
         {
-          if ((*it)->m_lost)
+          if (item->m_lost)
             {
               // Have to increment it because we set it to 0 at line 1133
-              m_lostOut += (*it)->m_packet->GetSize ();
+              m_lostOut += item->m_packet->GetSize ();
             }
-          else if (!(*it)->m_sacked)
+          else if (!item->m_sacked)
             {
               // Packet is not marked lost, nor is sacked. Then it becomes lost.
-              (*it)->m_lost = true;
-              m_lostOut += (*it)->m_packet->GetSize ();
+              item->m_lost = true;
+              m_lostOut += item->m_packet->GetSize ();
             }
         }
 
-      (*it)->m_retrans = false;
+      item->m_retrans = false;
     }
 
   NS_LOG_INFO ("Set sent list lost, status: " << *this);
@@ -1332,7 +1305,7 @@ TcpTxBuffer::IsHeadRetransmitted () const
       return false;
     }
 
-  return m_sentList.front ()->m_retrans;
+  return m_sentList[0].m_retrans;
 }
 
 void
@@ -1345,10 +1318,11 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead ()
       return;
     }
 
-  if (m_sentList.front ()->m_retrans)
+  TcpTxItem *head = &m_sentList.Front ();
+  if (head->m_retrans)
     {
-      m_sentList.front ()->m_retrans = false;
-      m_retrans -= m_sentList.front ()->m_packet->GetSize ();
+      head->m_retrans = false;
+      m_retrans -= head->m_packet->GetSize ();
     }
   ConsistencyCheck ();
 }
@@ -1356,27 +1330,28 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead ()
 void
 TcpTxBuffer::MarkHeadAsLost ()
 {
-  if (m_sentList.size () > 0)
+  if (!m_sentList.IsEmpty ())
     {
+      TcpTxItem *head = &m_sentList.Front ();
       // If the head is sacked (reneging by the receiver the previously sent
       // information) we revert the sacked flag.
       // A sacked head means that we should advance SND.UNA.. so it's an error.
-      if (m_sentList.front ()->m_sacked)
+      if (head->m_sacked)
         {
-          m_sentList.front ()->m_sacked = false;
-          m_sackedOut -= m_sentList.front ()->m_packet->GetSize ();
+          head->m_sacked = false;
+          m_sackedOut -= head->m_packet->GetSize ();
         }
 
-      if (m_sentList.front ()->m_retrans)
+      if (head->m_retrans)
         {
-          m_sentList.front ()->m_retrans = false;
-          m_retrans -= m_sentList.front ()->m_packet->GetSize ();
+          head->m_retrans = false;
+          m_retrans -= head->m_packet->GetSize ();
         }
 
-      if (! m_sentList.front()->m_lost)
+      if (! head->m_lost)
         {
-          m_sentList.front()->m_lost = true;
-          m_lostOut += m_sentList.front ()->m_packet->GetSize ();
+          head->m_lost = true;
+          m_lostOut += head->m_packet->GetSize ();
         }
     }
   ConsistencyCheck ();
@@ -1389,30 +1364,31 @@ TcpTxBuffer::AddRenoSack (void)
 
   if (m_sackEnabled)
     {
-      NS_ASSERT (m_sentList.size () > 1);
+      NS_ASSERT (m_sentList.Size () > 1);
     }
   else
     {
-      NS_ASSERT (m_sentList.size () > 0);
+      NS_ASSERT (m_sentList.Size () > 0);
     }
 
   m_renoSack = true;
 
   // We can _never_ SACK the head, so start from the second segment sent
-  auto it = ++m_sentList.begin ();
+  uint32_t i = 1;
 
   // Find the "highest sacked" point, that is SND.UNA + m_sackedOut
-  while (it != m_sentList.end () && (*it)->m_sacked)
+  while (i < m_sentList.Size () && m_sentList[i].m_sacked)
     {
-      ++it;
+      ++i;
     }
 
   // Add to the sacked size the size of the first "not sacked" segment
-  if (it != m_sentList.end ())
+  if (i < m_sentList.Size ())
     {
-      (*it)->m_sacked = true;
-      m_sackedOut += (*it)->m_packet->GetSize ();
-      m_highestSack = std::make_pair (it, (*it)->m_startSeq);
+      TcpTxItem *item = &m_sentList[i];
+      item->m_sacked = true;
+      m_sackedOut += item->m_packet->GetSize ();
+      m_highestSack = std::make_pair (true, item->m_startSeq);
       NS_LOG_INFO ("Added a Reno SACK, status: " << *this);
     }
   else
@@ -1438,19 +1414,20 @@ TcpTxBuffer::ConsistencyCheck () const
   uint32_t lost = 0;
   uint32_t retrans = 0;
 
-  for (auto it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  for (uint32_t i = 0; i < m_sentList.Size (); ++i)
     {
-      if ((*it)->m_sacked)
+      const TcpTxItem &item = m_sentList[i];
+      if (item.m_sacked)
         {
-          sacked += (*it)->m_packet->GetSize ();
+          sacked += item.m_packet->GetSize ();
         }
-      if ((*it)->m_lost)
+      if (item.m_lost)
         {
-          lost += (*it)->m_packet->GetSize ();
+          lost += item.m_packet->GetSize ();
         }
-      if ((*it)->m_retrans)
+      if (item.m_retrans)
         {
-          retrans += (*it)->m_packet->GetSize ();
+          retrans += item.m_packet->GetSize ();
         }
     }
 
@@ -1462,6 +1439,164 @@ TcpTxBuffer::ConsistencyCheck () const
                  " stored retrans: " << m_retrans);
 }
 
+TcpTxBuffer::ItemRing::ItemRing ()
+  : m_head (0), m_size (0)
+{
+}
+
+uint32_t
+TcpTxBuffer::ItemRing::Slot (uint32_t i) const
+{
+  return (m_head + i) & (m_items.size () - 1);
+}
+
+uint32_t
+TcpTxBuffer::ItemRing::Size (void) const
+{
+  return m_size;
+}
+
+bool
+TcpTxBuffer::ItemRing::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+
+TcpTxItem &
+TcpTxBuffer::ItemRing::operator[] (uint32_t i)
+{
+  NS_ASSERT (i < m_size);
+  return m_items[Slot (i)];
+}
+
+const TcpTxItem &
+TcpTxBuffer::ItemRing::operator[] (uint32_t i) const
+{
+  NS_ASSERT (i < m_size);
+  return m_items[Slot (i)];
+}
+
+TcpTxItem &
+TcpTxBuffer::ItemRing::Front (void)
+{
+  return (*this)[0];
+}
+
+TcpTxItem &
+TcpTxBuffer::ItemRing::Back (void)
+{
+  return (*this)[m_size - 1];
+}
+
+void
+TcpTxBuffer::ItemRing::Grow (void)
+{
+  std::vector<TcpTxItem> items (std::max<std::size_t> (16, 2 * m_items.size ()));
+  for (uint32_t i = 0; i < m_size; ++i)
+    {
+      items[i] = m_items[Slot (i)];
+    }
+  m_items.swap (items);
+  m_head = 0;
+}
+
+void
+TcpTxBuffer::ItemRing::PushBack (const TcpTxItem &item)
+{
+  if (m_size == m_items.size ())
+    {
+      Grow ();
+    }
+  m_items[Slot (m_size)] = item;
+  ++m_size;
+}
+
+void
+TcpTxBuffer::ItemRing::PushFront (const TcpTxItem &item)
+{
+  if (m_size == m_items.size ())
+    {
+      Grow ();
+    }
+  m_head = (m_head - 1) & (m_items.size () - 1);
+  m_items[m_head] = item;
+  ++m_size;
+}
+
+void
+TcpTxBuffer::ItemRing::PopFront (void)
+{
+  NS_ASSERT (m_size > 0);
+  // Release the packet now rather than when the slot is reused
+  m_items[m_head].m_packet = nullptr;
+  m_head = Slot (1);
+  --m_size;
+}
+
+void
+TcpTxBuffer::ItemRing::PopBack (void)
+{
+  NS_ASSERT (m_size > 0);
+  m_items[Slot (m_size - 1)].m_packet = nullptr;
+  --m_size;
+}
+
+void
+TcpTxBuffer::ItemRing::Insert (uint32_t i, const TcpTxItem &item)
+{
+  NS_ASSERT (i <= m_size);
+  if (i < m_size / 2)
+    {
+      // Move the items before i one slot towards the front
+      if (m_size == m_items.size ())
+        {
+          Grow ();
+        }
+      m_head = (m_head - 1) & (m_items.size () - 1);
+      ++m_size;
+      for (uint32_t j = 0; j < i; ++j)
+        {
+          m_items[Slot (j)] = m_items[Slot (j + 1)];
+        }
+    }
+  else
+    {
+      // Move the items from i one slot towards the back
+      if (m_size == m_items.size ())
+        {
+          Grow ();
+        }
+      for (uint32_t j = m_size; j > i; --j)
+        {
+          m_items[Slot (j)] = m_items[Slot (j - 1)];
+        }
+      ++m_size;
+    }
+  m_items[Slot (i)] = item;
+}
+
+void
+TcpTxBuffer::ItemRing::Erase (uint32_t i)
+{
+  NS_ASSERT (i < m_size);
+  if (i < m_size / 2)
+    {
+      for (uint32_t j = i; j > 0; --j)
+        {
+          m_items[Slot (j)] = m_items[Slot (j - 1)];
+        }
+      PopFront ();
+    }
+  else
+    {
+      for (uint32_t j = i; j + 1 < m_size; ++j)
+        {
+          m_items[Slot (j)] = m_items[Slot (j + 1)];
+        }
+      PopBack ();
+    }
+}
+
 std::ostream &
 operator<< (std::ostream & os, TcpTxItem const & item)
 {
@@ -1472,28 +1607,27 @@ operator<< (std::ostream & os, TcpTxItem const & item)
 std::ostream &
 operator<< (std::ostream & os, TcpTxBuffer const & tcpTxBuf)
 {
-  TcpTxBuffer::PacketList::const_iterator it;
   std::stringstream ss;
   SequenceNumber32 beginOfCurrentPacket = tcpTxBuf.m_firstByteSeq;
   uint32_t sentSize = 0, appSize = 0;
 
   Ptr<const Packet> p;
-  for (it = tcpTxBuf.m_sentList.begin (); it != tcpTxBuf.m_sentList.end (); ++it)
+  for (uint32_t i = 0; i < tcpTxBuf.m_sentList.Size (); ++i)
     {
-      p = (*it)->GetPacket ();
+      p = tcpTxBuf.m_sentList[i].GetPacket ();
       ss << "{";
-      (*it)->Print (ss);
+      tcpTxBuf.m_sentList[i].Print (ss);
       ss << "}";
       sentSize += p->GetSize ();
       beginOfCurrentPacket += p->GetSize ();
     }
 
-  for (it = tcpTxBuf.m_appList.begin (); it != tcpTxBuf.m_appList.end (); ++it)
+  for (uint32_t i = 0; i < tcpTxBuf.m_appList.Size (); ++i)
     {
-      appSize += (*it)->GetPacket ()->GetSize ();
+      appSize += tcpTxBuf.m_appList[i].GetPacket ()->GetSize ();
     }
 
-  os << "Sent list: " << ss.str () << ", size = " << tcpTxBuf.m_sentList.size () <<
+  os << "Sent list: " << ss.str () << ", size = " << tcpTxBuf.m_sentList.Size () <<
     " Total size: " << tcpTxBuf.m_size <<
     " m_firstByteSeq = " << tcpTxBuf.m_firstByteSeq <<
     " m_sentSize = " << tcpTxBuf.m_sentSize <<
@@ -28,6 +28,8 @@
 #include "ns3/tcp-option-sack.h"
 #include "ns3/tcp-tx-item.h"
 
+#include <vector>
+
 namespace ns3 {
 class Packet;
 
@@ -55,6 +57,15 @@ class Packet;
  * are not transmitted yet as segments. To discover how the chunks are managed
  * and retrieved from these lists, check CopyFromSequence documentation.
  *
+ * Both lists are rings of TcpTxItem stored by value in one array (see
+ * ItemRing), so that moving a segment from the AppList to the SentList, or
+ * discarding the acknowledged head, does not allocate. Since the items of
+ * the SentList are contiguous in the sequence number space, and each one
+ * knows its starting sequence number, the item holding a given sequence
+ * number is found by a binary search (FindSentItem) rather than by walking
+ * the list; this is how the SACK blocks are mapped onto the scoreboard, and
+ * how the retransmitted segments are located.
+ *
  * The head of the data is represented by m_firstByteSeq, and it is returned by
  * HeadSequence(). The last byte is returned by TailSequence(). In this class,
  * we also store the size (in bytes) of the packets inside the SentList in the
@@ -257,6 +268,7 @@ public:
    * \param seq start sequence number to extract
    * \returns a pointer to the TcpTxItem that corresponds to what requested.
    * Please do not delete the pointer, nor modify Packet data or sequence numbers.
+   * The pointer is valid until the next call that modifies the buffer.
    */
   TcpTxItem* CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq);
 
@@ -410,7 +422,107 @@ public:
 private:
   friend std::ostream & operator<< (std::ostream & os, TcpTxBuffer const & tcpTxBuf);
 
-  typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+  /**
+   * \brief Container for data stored in the buffer
+   *
+   * A double-ended queue of TcpTxItem, kept in a circular array whose
+   * capacity is doubled when full. Inserting or erasing an item in the
+   * middle moves the items on the shorter side. References to the items
+   * are invalidated by any insertion or removal.
+   */
+  class ItemRing
+  {
+  public:
+    ItemRing ();
+    /**
+     * \brief Get the number of items
+     * \return the number of items
+     */
+    uint32_t Size (void) const;
+    /**
+     * \brief Check if there are no items
+     * \return true if there are no items
+     */
+    bool IsEmpty (void) const;
+    /**
+     * \brief Get an item
+     * \param i index of the item, from the front
+     * \return a reference to the item
+     */
+    TcpTxItem & operator[] (uint32_t i);
+    /**
+     * \brief Get an item
+     * \param i index of the item, from the front
+     * \return a const reference to the item
+     */
+    const TcpTxItem & operator[] (uint32_t i) const;
+    /**
+     * \brief Get the first item
+     * \return a reference to the first item
+     */
+    TcpTxItem & Front (void);
+    /**
+     * \brief Get the last item
+     * \return a reference to the last item
+     */
+    TcpTxItem & Back (void);
+    /**
+     * \brief Append a copy of an item
+     * \param item the item, which must not be stored in this ring
+     */
+    void PushBack (const TcpTxItem &item);
+    /**
+     * \brief Prepend a copy of an item
+     * \param item the item, which must not be stored in this ring
+     */
+    void PushFront (const TcpTxItem &item);
+    /**
+     * \brief Remove the first item
+     */
+    void PopFront (void);
+    /**
+     * \brief Remove the last item
+     */
+    void PopBack (void);
+    /**
+     * \brief Insert a copy of an item before the i-th one
+     * \param i index of the position
+     * \param item the item, which must not be stored in this ring
+     */
+    void Insert (uint32_t i, const TcpTxItem &item);
+    /**
+     * \brief Remove the i-th item
+     * \param i index of the item
+     */
+    void Erase (uint32_t i);
+
+  private:
+    /**
+     * \brief Get the slot of an item in the array
+     * \param i index of the item, from the front
+     * \return the index in m_items
+     */
+    uint32_t Slot (uint32_t i) const;
+    /**
+     * \brief Double the capacity
+     */
+    void Grow (void);
+
+    std::vector<TcpTxItem> m_items; //!< Circular array, its size is a power of two
+    uint32_t m_head;                //!< Slot of the first item
+    uint32_t m_size;                //!< Number of items
+  };
+
+  typedef ItemRing PacketList; //!< container for data stored in the buffer
+
+  /**
+   * \brief Find the item of the SentList which holds a sequence number
+   *
+   * \param seq the sequence number
+   * \return the index of the last item starting at or before seq, 0 if there
+   * is none
+   */
+  uint32_t FindSentItem (const SequenceNumber32 &seq) const;
 
   /**
    * \brief Update the lost count
@@ -446,10 +558,10 @@ private:
   /**
    * \brief Decide if a segment is lost based on RFC 6675 algorithm.
    * \param seq Sequence
-   * \param segment Iterator to the sequence
+   * \param segment Index of the item of the sequence in the SentList
    * \return true if seq is lost per RFC 6675, false otherwise
    */
-  bool IsLostRFC (const SequenceNumber32 &seq, const PacketList::const_iterator &segment) const;
+  bool IsLostRFC (const SequenceNumber32 &seq, uint32_t segment) const;
 
   /**
    * \brief Calculate the number of bytes in flight per RFC 6675
@@ -593,13 +705,6 @@ private:
    */
   void ConsistencyCheck () const;
 
-  /**
-   * \brief Find the highest SACK byte
-   * \return a pair with the highest byte and an iterator inside m_sentList
-   */
-  std::pair <TcpTxBuffer::PacketList::const_iterator, SequenceNumber32>
-  FindHighestSacked () const;
-
   PacketList m_appList;  //!< Buffer for application data
   PacketList m_sentList; //!< Buffer for sent (but not acked) data
   uint32_t m_maxBuffer;  //!< Max number of data bytes in buffer (SND.WND)
@@ -608,7 +713,7 @@ private:
   Callback<uint32_t> m_rWndCallback; //!< Callback to obtain RCV.WND value
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
-  std::pair <PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+  std::pair <bool, SequenceNumber32> m_highestSack; //!< Whether an item is sacked, and the start of the highest one
 
   uint32_t m_lostOut   {0}; //!< Number of lost bytes
   uint32_t m_sackedOut {0}; //!< Number of sacked bytes
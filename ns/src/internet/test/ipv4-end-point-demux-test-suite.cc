@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the Ipv4EndPointDemux lookups on a node with many connections.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Look up the single endpoint receiving a packet.
+   * \param demux The demux.
+   * \param daddr Destination address.
+   * \param dport Destination port.
+   * \param saddr Source address.
+   * \param sport Source port.
+   * \returns The endpoint, 0 if none.
+   */
+  Ipv4EndPoint *LookupOne (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                           Ipv4Address saddr, uint16_t sport);
+
+  Ptr<Ipv4Interface> m_interface; //!< Incoming interface
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookups by local port and peer")
+{}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::LookupOne (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                                      Ipv4Address saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, m_interface);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  m_interface = CreateObject<Ipv4Interface> ();
+  Ipv4EndPointDemux demux;
+  Ipv4Address local ("10.0.0.1");
+
+  Ipv4EndPoint *listener = demux.Allocate (0, 8080);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Listener not allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, 8080), 0, "Duplicated listener allocated");
+
+  // One connection per peer on the listening port, as forked by TCP
+  std::vector<Ipv4EndPoint *> connections;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      Ipv4Address peer (Ipv4Address ("10.1.0.0").Get () + i / 10);
+      Ipv4EndPoint *endPoint = demux.Allocate (0, local, 8080, peer, 49152 + i % 10);
+      NS_TEST_ASSERT_MSG_NE (endPoint, 0, "Connection " << i << " not allocated");
+      connections.push_back (endPoint);
+    }
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 8080, Ipv4Address ("10.1.0.0"), 49152), 0,
+                         "Duplicated connection allocated");
+
+  for (uint32_t i = 0; i < 1000; i += 7)
+    {
+      Ipv4Address peer (Ipv4Address ("10.1.0.0").Get () + i / 10);
+      Ipv4EndPoint *found = LookupOne (demux, local, 8080, peer, 49152 + i % 10);
+      NS_TEST_EXPECT_MSG_EQ (found, connections[i], "Wrong endpoint for connection " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 8080, Ipv4Address ("10.2.0.1"), 1234), listener,
+                         "A new peer should reach the listener");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 8081, Ipv4Address ("10.1.0.0"), 49152), 0,
+                         "Nothing listens on this port");
+
+  // The connections use the local address on the listening port
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 8080), 0, "Listener on a used address allocated");
+
+  // A listener bound to the local address has priority over the wildcard one
+  Ipv4EndPoint *anyListener = demux.Allocate (0, 9090);
+  Ipv4EndPoint *boundListener = demux.Allocate (0, local, 9090);
+  NS_TEST_ASSERT_MSG_NE (boundListener, 0, "Bound listener not allocated");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 9090, Ipv4Address ("10.2.0.1"), 1234), boundListener,
+                         "The bound listener should have priority");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, Ipv4Address ("10.0.0.2"), 9090, Ipv4Address ("10.2.0.1"), 1234), anyListener,
+                         "Other local addresses should reach the wildcard listener");
+
+  // A client endpoint is found once its peer is set, and no longer matches
+  // as a wildcard
+  Ipv4EndPoint *client = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (client, 0, "Client not allocated");
+  uint16_t clientPort = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (clientPort), true, "Ephemeral port not in use");
+  client->SetPeer (Ipv4Address ("10.3.0.1"), 80);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, clientPort, Ipv4Address ("10.3.0.1"), 80), client,
+                         "Client not found by its peer");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, clientPort, Ipv4Address ("10.3.0.2"), 80), 0,
+                         "Client found from another peer");
+  client->SetRxEnabled (false);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, clientPort, Ipv4Address ("10.3.0.1"), 80), 0,
+                         "Client with disabled Rx found");
+
+  demux.DeAllocate (client);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (clientPort), false, "Ephemeral port still in use");
+  demux.DeAllocate (connections[0]);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 8080, Ipv4Address ("10.1.0.0"), 49152), listener,
+                         "Closed connection still found");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 1002, "Wrong number of endpoints");
+
+  m_interface = 0;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux TestSuite
+ */
+class Ipv4EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  Ipv4EndPointDemuxTestSuite ()
+    : TestSuite ("ipv4-end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static Ipv4EndPointDemuxTestSuite g_ipv4EndPointDemuxTestSuite; //!< Static variable for test initialization
@@ -14,6 +14,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <sstream>
 #include <vector>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
@@ -42,6 +43,9 @@
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/bridge-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/socket.h"
 
 using namespace ns3;
 
@@ -1244,6 +1248,294 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the routes of the GlobalRouteBuilder against those of the
+ * GlobalRouteManager, and after a link failure against a full rebuild.
+ *
+ * A ring of five routers, each with a stub host, the ring links having
+ * the metrics 1, 2, 4, 8 and 16 so that every shortest path is unique.
+ * A last node has two links to the first router, so that it is not a stub
+ * node although it reaches everything through the same neighbor.  Only the
+ * stub hosts forward an address assigned to no node, with either, and the
+ * last node too once it may compact its routes into a default route.
+ */
+class Ipv4GlobalRouteBuilderTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRouteBuilderTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \returns The next hop of every node towards every address of the
+   * other nodes, as "gateway/interface".
+   */
+  std::vector<std::string> GetNextHops (void) const;
+  /**
+   * \param [in] n The node index.
+   * \param [in] address The destination address.
+   * \returns The next hop of a node towards an address, as
+   * "gateway/interface", or "none".
+   */
+  std::string GetNextHop (uint32_t n, Ipv4Address address) const;
+  /** Record the next hops after the failure. */
+  void RecordNextHops (void);
+
+  NodeContainer m_nodes;                 //!< Routers, then hosts, then the dual-homed node
+  std::vector<Ipv4Address> m_addresses;  //!< Every interface address
+  std::vector<std::string> m_nextHops;   //!< Next hops recorded during the simulation
+};
+
+Ipv4GlobalRouteBuilderTestCase::Ipv4GlobalRouteBuilderTestCase ()
+  : TestCase ("Global routes computed by the GlobalRouteBuilder")
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRouteBuilderTestCase::GetNextHops (void) const
+{
+  std::vector<std::string> nextHops;
+  for (uint32_t n = 0; n < m_nodes.GetN (); ++n)
+    {
+      Ptr<Ipv4> ipv4 = m_nodes.Get (n)->GetObject<Ipv4> ();
+      for (uint32_t a = 0; a < m_addresses.size (); ++a)
+        {
+          if (ipv4->GetInterfaceForAddress (m_addresses[a]) >= 0)
+            {
+              continue;
+            }
+          nextHops.push_back (GetNextHop (n, m_addresses[a]));
+        }
+    }
+  return nextHops;
+}
+
+std::string
+Ipv4GlobalRouteBuilderTestCase::GetNextHop (uint32_t n, Ipv4Address address) const
+{
+  Ptr<Ipv4> ipv4 = m_nodes.Get (n)->GetObject<Ipv4> ();
+  Ipv4Header header;
+  header.SetDestination (address);
+  Socket::SocketErrno error;
+  Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (0, header, 0, error);
+  std::ostringstream oss;
+  if (route == 0)
+    {
+      oss << "none";
+    }
+  else
+    {
+      oss << route->GetGateway () << "/" << ipv4->GetInterfaceForDevice (route->GetOutputDevice ());
+    }
+  return oss.str ();
+}
+
+void
+Ipv4GlobalRouteBuilderTestCase::RecordNextHops (void)
+{
+  m_nextHops = GetNextHops ();
+}
+
+void
+Ipv4GlobalRouteBuilderTestCase::DoRun (void)
+{
+  const uint32_t nRouters = 5;
+  m_nodes.Create (2 * nRouters + 1);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (m_nodes);
+
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  for (uint32_t i = 0; i < 2 * nRouters + 2; ++i)
+    {
+      // Ring links first, then a host on each router, then two links from
+      // the first router to the last node
+      Ptr<Node> a = m_nodes.Get (i < 2 * nRouters ? i % nRouters : 0);
+      Ptr<Node> b = i < nRouters ? m_nodes.Get ((i + 1) % nRouters) : m_nodes.Get (std::min (i, 2 * nRouters));
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      NetDeviceContainer net = simpleHelper.Install (a, channel);
+      net.Add (simpleHelper.Install (b, channel));
+      std::ostringstream base;
+      base << "10." << 1 + i / nRouters << "." << i % nRouters << ".0";
+      ipv4.SetBase (base.str ().c_str (), "255.255.255.252");
+      Ipv4InterfaceContainer interfaces = ipv4.Assign (net);
+      for (uint32_t j = 0; j < 2; ++j)
+        {
+          m_addresses.push_back (interfaces.GetAddress (j));
+          if (i < nRouters)
+            {
+              interfaces.Get (j).first->SetMetric (interfaces.Get (j).second, 1 << i);
+            }
+        }
+    }
+
+  Ipv4Address unknown ("10.99.0.1");
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> managerNextHops = GetNextHops ();
+  std::vector<std::string> managerUnknownNextHops;
+  for (uint32_t n = 0; n < m_nodes.GetN (); ++n)
+    {
+      managerUnknownNextHops.push_back (GetNextHop (n, unknown));
+    }
+  Ipv4GlobalRoutingHelper::BuildRoutingTables (2);
+  std::vector<std::string> builderNextHops = GetNextHops ();
+  NS_TEST_ASSERT_MSG_EQ (builderNextHops.size (), managerNextHops.size (), "Wrong number of next hops");
+  for (uint32_t k = 0; k < managerNextHops.size (); ++k)
+    {
+      NS_TEST_EXPECT_MSG_EQ (builderNextHops[k], managerNextHops[k], "Different next hop " << k);
+    }
+  for (uint32_t n = 0; n < m_nodes.GetN (); ++n)
+    {
+      NS_TEST_EXPECT_MSG_EQ (GetNextHop (n, unknown), managerUnknownNextHops[n], "Different next hop of node " << n << " to an unknown address");
+      bool stub = n >= nRouters && n < 2 * nRouters;
+      bool routed = managerUnknownNextHops[n] != "none";
+      NS_TEST_EXPECT_MSG_EQ (routed, stub, "Node " << n << " routes an unknown address");
+    }
+  for (uint32_t i = nRouters; i < 2 * nRouters; ++i)
+    {
+      Ptr<Ipv4GlobalRouting> routing = DynamicCast<Ipv4GlobalRouting> (m_nodes.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+      NS_TEST_EXPECT_MSG_EQ (routing->GetNRoutes (), 1, "A stub host should only have a default route");
+    }
+
+  // The dual-homed node compacts its routes once allowed to
+  Ptr<Node> dual = m_nodes.Get (2 * nRouters);
+  dual->GetObject<Ipv4> ()->GetRoutingProtocol ()->SetAttribute ("CompactDefaultRoute", BooleanValue (true));
+  Ipv4GlobalRoutingHelper::BuildRoutingTables (2);
+  builderNextHops = GetNextHops ();
+  for (uint32_t k = 0; k < managerNextHops.size (); ++k)
+    {
+      NS_TEST_EXPECT_MSG_EQ (builderNextHops[k], managerNextHops[k], "Different next hop " << k << " with a compacted default route");
+    }
+  NS_TEST_EXPECT_MSG_NE (GetNextHop (2 * nRouters, unknown), "none", "The dual-homed node does not forward an unknown address");
+  dual->GetObject<Ipv4> ()->GetRoutingProtocol ()->SetAttribute ("CompactDefaultRoute", BooleanValue (false));
+
+  // Fail the link between routers 0 and 1, from router 0 only
+  for (uint32_t n = 0; n < m_nodes.GetN (); ++n)
+    {
+      m_nodes.Get (n)->GetObject<Ipv4> ()->GetRoutingProtocol ()->SetAttribute ("RespondToInterfaceEvents", BooleanValue (true));
+    }
+  Ptr<Ipv4> ipv4Router0 = m_nodes.Get (0)->GetObject<Ipv4> ();
+  Simulator::Schedule (Seconds (1), &Ipv4::SetDown, ipv4Router0, 1);
+  Simulator::Schedule (Seconds (2), &Ipv4GlobalRouteBuilderTestCase::RecordNextHops, this);
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+
+  Ipv4GlobalRoutingHelper::BuildRoutingTables ();
+  std::vector<std::string> rebuiltNextHops = GetNextHops ();
+  NS_TEST_ASSERT_MSG_EQ (m_nextHops.size (), rebuiltNextHops.size (), "Wrong number of next hops");
+  for (uint32_t k = 0; k < rebuiltNextHops.size (); ++k)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_nextHops[k], rebuiltNextHops[k], "Different next hop " << k << " after the failure");
+    }
+
+  // Router 0 now reaches the host of router 1 the long way round
+  Ipv4Header header;
+  header.SetDestination (m_addresses[2 * nRouters + 3]);
+  Socket::SocketErrno error;
+  Ptr<Ipv4Route> route = ipv4Router0->GetRoutingProtocol ()->RouteOutput (0, header, 0, error);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route after the failure");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), m_addresses[2 * (nRouters - 1)], "Wrong gateway after the failure");
+
+  // With RandomEcmpRouting, the dual-homed node keeps both of its links to
+  // the host of router 1
+  Ptr<Ipv4GlobalRouting> dualRouting = DynamicCast<Ipv4GlobalRouting> (dual->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  dualRouting->SetAttribute ("RandomEcmpRouting", BooleanValue (true));
+  Ipv4GlobalRoutingHelper::BuildRoutingTables (2);
+  uint32_t nHostRoutes = 0;
+  for (uint32_t i = 0; i < dualRouting->GetNRoutes (); ++i)
+    {
+      if (dualRouting->GetRoute (i)->GetDest () == m_addresses[2 * nRouters + 3])
+        {
+          nHostRoutes++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (nHostRoutes, 2, "Equal cost next hops not installed with RandomEcmpRouting");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the routes are looked up by longest prefix, whatever
+ * their order in the table, and that removing a route takes effect.
+ */
+class Ipv4GlobalRoutingLongestPrefixTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingLongestPrefixTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param [in] routing The routing protocol.
+   * \param [in] dest The destination.
+   * \returns The gateway of the route to the destination, 255.255.255.255
+   *          if there is none.
+   */
+  Ipv4Address GetGateway (Ptr<Ipv4GlobalRouting> routing, Ipv4Address dest) const;
+};
+
+Ipv4GlobalRoutingLongestPrefixTestCase::Ipv4GlobalRoutingLongestPrefixTestCase ()
+  : TestCase ("Global routing lookups by longest prefix")
+{
+}
+
+Ipv4Address
+Ipv4GlobalRoutingLongestPrefixTestCase::GetGateway (Ptr<Ipv4GlobalRouting> routing, Ipv4Address dest) const
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  Ptr<Ipv4Route> route = routing->RouteOutput (0, header, 0, error);
+  return route == 0 ? Ipv4Address::GetBroadcast () : route->GetGateway ();
+}
+
+void
+Ipv4GlobalRoutingLongestPrefixTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (nodes);
+  SimpleNetDeviceHelper simpleHelper;
+  NetDeviceContainer net = simpleHelper.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("192.168.0.0", "255.255.255.0");
+  ipv4.Assign (net);
+
+  Ptr<Ipv4GlobalRouting> routing = DynamicCast<Ipv4GlobalRouting> (nodes.Get (0)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  routing->AddNetworkRouteTo ("0.0.0.0", "0.0.0.0", "192.168.0.100", 1);
+  routing->AddNetworkRouteTo ("10.0.0.0", "255.0.0.0", "192.168.0.8", 1);
+  routing->AddNetworkRouteTo ("10.1.2.0", "255.255.255.0", "192.168.0.24", 1);
+  routing->AddNetworkRouteTo ("10.1.0.0", "255.255.0.0", "192.168.0.16", 1);
+  routing->AddHostRouteTo ("10.1.2.3", "192.168.0.32", 1);
+
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (routing, "10.1.2.3"), Ipv4Address ("192.168.0.32"), "Host route not preferred");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (routing, "10.1.2.4"), Ipv4Address ("192.168.0.24"), "/24 route not preferred");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (routing, "10.1.3.4"), Ipv4Address ("192.168.0.16"), "/16 route not preferred");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (routing, "10.2.3.4"), Ipv4Address ("192.168.0.8"), "/8 route not preferred");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (routing, "11.2.3.4"), Ipv4Address ("192.168.0.100"), "Default route not used");
+
+  // Routes 0 and 3 are the host route and the /24 route
+  routing->RemoveRoute (3);
+  routing->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (routing, "10.1.2.3"), Ipv4Address ("192.168.0.16"), "Removed routes still used");
+  routing->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (routing, "11.2.3.4"), Ipv4Address::GetBroadcast (), "Removed default route still used");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -1267,6 +1559,8 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRouteBuilderTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingLongestPrefixTestCase, TestCase::QUICK);
   }
 
 static Ipv4GlobalRoutingTestSuite g_globalRoutingTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/hash.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-queue-disc-item.h"
+#include "ns3/tcp-header.h"
+#include "ns3/udp-header.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4QueueDiscItem and Ipv6QueueDiscItem flow hash Test
+ */
+class QueueDiscItemHashTest : public TestCase
+{
+public:
+  QueueDiscItemHashTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Create an item carrying an IPv4 TCP segment.
+   * \param src The source address.
+   * \param srcPort The source port.
+   * \param dstPort The destination port.
+   * \returns The item.
+   */
+  Ptr<Ipv4QueueDiscItem> CreateIpv4Item (const char *src, uint16_t srcPort, uint16_t dstPort);
+  /**
+   * \brief Create an item carrying an IPv6 UDP datagram.
+   * \param srcPort The source port.
+   * \param dstPort The destination port.
+   * \returns The item.
+   */
+  Ptr<Ipv6QueueDiscItem> CreateIpv6Item (uint16_t srcPort, uint16_t dstPort);
+};
+
+QueueDiscItemHashTest::QueueDiscItemHashTest ()
+  : TestCase ("Flow hash of the IPv4 and IPv6 queue disc items")
+{
+}
+
+Ptr<Ipv4QueueDiscItem>
+QueueDiscItemHashTest::CreateIpv4Item (const char *src, uint16_t srcPort, uint16_t dstPort)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  TcpHeader tcpHdr;
+  tcpHdr.SetSourcePort (srcPort);
+  tcpHdr.SetDestinationPort (dstPort);
+  p->AddHeader (tcpHdr);
+
+  Ipv4Header ipHdr;
+  ipHdr.SetSource (Ipv4Address (src));
+  ipHdr.SetDestination (Ipv4Address ("10.0.1.1"));
+  ipHdr.SetProtocol (6);
+  ipHdr.SetPayloadSize (p->GetSize ());
+  return Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipHdr);
+}
+
+Ptr<Ipv6QueueDiscItem>
+QueueDiscItemHashTest::CreateIpv6Item (uint16_t srcPort, uint16_t dstPort)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udpHdr;
+  udpHdr.SetSourcePort (srcPort);
+  udpHdr.SetDestinationPort (dstPort);
+  p->AddHeader (udpHdr);
+
+  Ipv6Header ipHdr;
+  ipHdr.SetSource (Ipv6Address ("2001:db8::1"));
+  ipHdr.SetDestination (Ipv6Address ("2001:db8::2"));
+  ipHdr.SetNextHeader (17);
+  ipHdr.SetPayloadLength (p->GetSize ());
+  return Create<Ipv6QueueDiscItem> (p, Address (), 0x86DD, ipHdr);
+}
+
+void
+QueueDiscItemHashTest::DoRun (void)
+{
+  Ptr<Ipv4QueueDiscItem> a = CreateIpv4Item ("10.0.0.1", 1000, 80);
+  Ptr<Ipv4QueueDiscItem> b = CreateIpv4Item ("10.0.0.1", 1000, 80);
+
+  NS_TEST_EXPECT_MSG_EQ (a->Hash (0), b->Hash (0), "Same 5-tuple, different hash");
+  NS_TEST_EXPECT_MSG_EQ (a->Hash (7), b->Hash (7), "Same 5-tuple, different hash");
+  NS_TEST_EXPECT_MSG_NE (a->Hash (0), a->Hash (7), "Perturbation ignored");
+  NS_TEST_EXPECT_MSG_NE (a->Hash (7), a->Hash (8), "Perturbation ignored");
+  NS_TEST_EXPECT_MSG_NE (a->Hash (0), CreateIpv4Item ("10.0.0.1", 1001, 80)->Hash (0),
+                         "Source port ignored");
+  NS_TEST_EXPECT_MSG_NE (a->Hash (0), CreateIpv4Item ("10.0.0.1", 1000, 81)->Hash (0),
+                         "Destination port ignored");
+  NS_TEST_EXPECT_MSG_NE (a->Hash (0), CreateIpv4Item ("10.0.0.2", 1000, 80)->Hash (0),
+                         "Source address ignored");
+
+  // Perturbation 0 keeps the Murmur3 hash of the 5-tuple and the perturbation,
+  // whether or not the 64-bit hash of the 5-tuple is already known
+  uint8_t buf[17] = { 10, 0, 0, 1, 10, 0, 1, 1, 6, 3, 232, 0, 80, 0, 0, 0, 0 };
+  NS_TEST_EXPECT_MSG_EQ (a->Hash (0), Hash32 ((char*) buf, 17), "Hash of perturbation 0 changed");
+  NS_TEST_EXPECT_MSG_EQ (CreateIpv4Item ("10.0.0.1", 1000, 80)->Hash (0), Hash32 ((char*) buf, 17),
+                         "Hash of perturbation 0 changed");
+
+  // The hash must not depend on the IP header having been added to the packet
+  uint32_t hash = b->Hash (3);
+  b->AddHeader ();
+  NS_TEST_EXPECT_MSG_EQ (b->Hash (3), hash, "Hash changed by AddHeader");
+  Ptr<Ipv4QueueDiscItem> c = CreateIpv4Item ("10.0.0.1", 1000, 80);
+  NS_TEST_EXPECT_MSG_EQ (c->Hash (3), hash, "Memoized hash differs from a fresh one");
+
+  Ptr<Ipv6QueueDiscItem> d = CreateIpv6Item (5000, 53);
+  Ptr<Ipv6QueueDiscItem> e = CreateIpv6Item (5000, 53);
+  NS_TEST_EXPECT_MSG_EQ (d->Hash (1), e->Hash (1), "Same 5-tuple, different hash");
+  NS_TEST_EXPECT_MSG_NE (d->Hash (1), d->Hash (2), "Perturbation ignored");
+  NS_TEST_EXPECT_MSG_NE (d->Hash (1), CreateIpv6Item (5001, 53)->Hash (1),
+                         "Source port ignored");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4QueueDiscItem and Ipv6QueueDiscItem TestSuite
+ */
+class QueueDiscItemTestSuite : public TestSuite
+{
+public:
+  QueueDiscItemTestSuite ()
+    : TestSuite ("ip-queue-disc-item", UNIT)
+  {
+    AddTestCase (new QueueDiscItemHashTest (), TestCase::QUICK);
+  }
+};
+
+static QueueDiscItemTestSuite g_queueDiscItemTestSuite; //!< Static variable for test initialization
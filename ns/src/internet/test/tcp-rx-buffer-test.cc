@@ -44,6 +44,17 @@ private:
    * \brief Test the SACK list update.
    */
   void TestUpdateSACKList ();
+  /**
+   * \brief Test the reassembly of a long out-of-order window.
+   */
+  void TestLongWindow ();
+  /**
+   * \brief Create a segment whose bytes are the low bits of their sequence number.
+   * \param seq the sequence number of the first byte
+   * \param size the segment size
+   * \return the segment
+   */
+  static Ptr<Packet> CreateSegment (uint32_t seq, uint32_t size);
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase ()
@@ -55,6 +66,92 @@ void
 TcpRxBufferTestCase::DoRun ()
 {
   TestUpdateSACKList ();
+  TestLongWindow ();
+}
+
+Ptr<Packet>
+TcpRxBufferTestCase::CreateSegment (uint32_t seq, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = static_cast<uint8_t> (seq + i);
+    }
+  return Create<Packet> (data.data (), size);
+}
+
+void
+TcpRxBufferTestCase::TestLongWindow ()
+{
+  const uint32_t segments = 500;
+  const uint32_t segSize = 100;
+  TcpRxBuffer rxBuf;
+  rxBuf.SetMaxBufferSize (segments * segSize);
+  rxBuf.SetNextRxSequence (SequenceNumber32 (1));
+  TcpHeader h;
+
+  // Every other segment is lost
+  for (uint32_t k = 1; k < segments; k += 2)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (1 + k * segSize));
+      rxBuf.Add (CreateSegment (1 + k * segSize, segSize), h);
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (1), "Hole at the head not detected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 0, "Data available beyond a hole");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), segments / 2 * segSize, "Wrong occupancy");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackListSize (), 4, "The SACK list should be full");
+
+  // A retransmission covering two holes replaces the segment between them
+  h.SetSequenceNumber (SequenceNumber32 (1 + 2 * segSize));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreateSegment (1 + 2 * segSize, 3 * segSize), h), true,
+                         "Retransmission not buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), (segments / 2 + 2) * segSize, "Wrong occupancy");
+  TcpOptionSack::SackList sackList = rxBuf.GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (sackList.front ().first, SequenceNumber32 (1 + 2 * segSize), "Wrong first SACK block");
+  NS_TEST_ASSERT_MSG_EQ (sackList.front ().second, SequenceNumber32 (1 + 5 * segSize), "Wrong first SACK block");
+
+  // The other holes are filled from the tail, by segments overlapping
+  // the following one
+  for (uint32_t k = segments - 2; k > 2; k -= 2)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (1 + k * segSize));
+      rxBuf.Add (CreateSegment (1 + k * segSize, 2 * segSize), h);
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (1), "Hole at the head filled");
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), (segments - 1) * segSize, "Wrong occupancy");
+
+  h.SetSequenceNumber (SequenceNumber32 (1));
+  rxBuf.Add (CreateSegment (1, segSize), h);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (1 + segments * segSize),
+                         "The whole window should be in order");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), segments * segSize, "The whole window should be available");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackListSize (), 0, "SACK list should be empty");
+
+  // A duplicate is discarded
+  h.SetSequenceNumber (SequenceNumber32 (1 + segSize));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreateSegment (1 + segSize, segSize), h), false, "Duplicate buffered");
+
+  // The data comes out in order, whatever the extracted sizes
+  uint32_t seq = 1;
+  while (rxBuf.Available () > 0)
+    {
+      Ptr<Packet> p = rxBuf.Extract (777);
+      std::vector<uint8_t> data (p->GetSize ());
+      p->CopyData (data.data (), p->GetSize ());
+      for (uint32_t i = 0; i < data.size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (data[i]), ((seq + i) & 0xff),
+                                 "Wrong byte at sequence " << seq + i);
+        }
+      seq += p->GetSize ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (seq, 1 + segments * segSize, "Wrong amount of data extracted");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0, "Data left in the buffer");
+
+  // And the buffer is usable again
+  h.SetSequenceNumber (SequenceNumber32 (seq));
+  rxBuf.Add (CreateSegment (seq, segSize), h);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), segSize, "In order data not available");
 }
 
 void
@@ -53,6 +53,8 @@ private:
   /** \brief Test the logic of merging items in GetTransmittedSegment()
    * which is triggered by CopyFromSequence()*/
   void TestMergeItemsWhenGetTransmittedSegment ();
+  /** \brief Test the scoreboard and the retransmissions on a long sent list */
+  void TestLongSentList ();
   /**
    * \brief Callback to provide a value of receiver window
    * \returns the receiver window size
@@ -101,6 +103,14 @@ TcpTxBufferTestCase::DoRun ()
   Simulator::Schedule (Seconds (0.0),
                          &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment, this);
 
+  /*
+   * Cases for a sent list of many items:
+   *  -> a SACK block in the middle marks the items below it as lost
+   *  -> retransmissions split items close to the head and close to the tail
+   */
+  Simulator::Schedule (Seconds (0.0),
+                       &TcpTxBufferTestCase::TestLongSentList, this);
+
   Simulator::Run ();
   Simulator::Destroy ();
 }
@@ -385,6 +395,50 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment ()
   txBuf.CopyFromSequence (2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLongSentList ()
+{
+  TcpTxBuffer txBuf;
+  txBuf.SetHeadSequence (SequenceNumber32 (1));
+  txBuf.SetMaxBufferSize (1 << 20);
+  txBuf.SetSegmentSize (1000);
+  txBuf.SetDupAckThresh (3);
+
+  txBuf.Add (Create<Packet> (200000));
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      txBuf.CopyFromSequence (1000, SequenceNumber32 ((i * 1000) + 1));
+    }
+
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+  sack->AddSackBlock (TcpOptionSack::SackBlock (SequenceNumber32 (50001), SequenceNumber32 (60001)));
+  uint32_t sacked = txBuf.Update (sack->GetSackList ());
+  NS_TEST_ASSERT_MSG_EQ (sacked, 10000, "Wrong number of bytes sacked");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetSacked (), 10000, "Wrong sacked count");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetLost (), 50000, "The segments below the block are not lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (SequenceNumber32 (10001)), true, "Segment should be lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (SequenceNumber32 (70001)), false, "Segment should not be lost");
+
+  // Close to the head: split one item
+  TcpTxItem *item = txBuf.CopyFromSequence (500, SequenceNumber32 (10001));
+  NS_TEST_ASSERT_MSG_EQ (item->GetPacket ()->GetSize (), 500, "Wrong retransmitted size");
+  NS_TEST_ASSERT_MSG_EQ (item->IsRetrans (), true, "Item should be retransmitted");
+
+  // Close to the tail: split one item twice
+  item = txBuf.CopyFromSequence (300, SequenceNumber32 (180501));
+  NS_TEST_ASSERT_MSG_EQ (item->GetPacket ()->GetSize (), 300, "Wrong retransmitted size");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetRetransmitsCount (), 800, "Wrong retransmitted count");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), 200000 - 60000 + 800, "Wrong bytes in flight");
+
+  txBuf.DiscardUpTo (SequenceNumber32 (100001));
+  NS_TEST_ASSERT_MSG_EQ (txBuf.Size (), 100000, "Size is different than expected");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetSacked (), 0, "Sacked segments were discarded");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetLost (), 0, "Lost segments were discarded");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetRetransmitsCount (), 300, "Wrong retransmitted count");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsRetransmittedDataAcked (SequenceNumber32 (180801)), true,
+                         "The retransmitted segment ends at 180801");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock ()
 {
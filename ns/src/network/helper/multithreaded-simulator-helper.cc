@@ -0,0 +1,574 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorHelper");
+
+namespace {
+
+/**
+ * \param [in] channel A channel.
+ * \param [in] partitionOfNode The partition of each node.
+ * \returns \c true if the devices of the channel are in different partitions.
+ */
+bool
+IsCrossing (Ptr<Channel> channel, const std::vector<uint32_t> &partitionOfNode)
+{
+  uint32_t first = 0;
+  for (std::size_t i = 0; i < channel->GetNDevices (); ++i)
+    {
+      uint32_t id = channel->GetDevice (i)->GetNode ()->GetId ();
+      uint32_t partition = id < partitionOfNode.size () ? partitionOfNode[id] : 0;
+      if (i == 0)
+        {
+          first = partition;
+        }
+      else if (partition != first)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/** Allowed excess of a partition load over its share of the total. */
+const double BALANCE_TOLERANCE = 0.1;
+/** Maximum number of Fiduccia-Mattheyses passes per bisection. */
+const uint32_t REFINEMENT_PASSES = 8;
+
+/** Graph to partition: groups of nodes and the channels between them. */
+struct Graph
+{
+  std::vector<double> load;                                     //!< Vertex load
+  std::vector<std::vector<std::pair<uint32_t, double> > > adj;  //!< Neighbours and rates of the edges
+};
+
+/**
+ * \param [in,out] parent The union-find forest.
+ * \param [in] v A vertex.
+ * \returns The root of the vertex.
+ */
+uint32_t
+Find (std::vector<uint32_t> &parent, uint32_t v)
+{
+  while (parent[v] != v)
+    {
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+    }
+  return v;
+}
+
+/**
+ * Split a set of vertices in two, cutting as little rate as possible.
+ *
+ * Side 0 is grown greedily from a vertex far from the first one, until
+ * it carries about \p fraction of the load, then refined with
+ * Fiduccia-Mattheyses passes which keep the two loads within the
+ * tolerance, or at least do not unbalance them further.
+ *
+ * \param [in] g The graph.
+ * \param [in] vertices The vertices to split.
+ * \param [in] fraction The share of the load of side 0.
+ * \returns The side of each vertex, in the order of \p vertices.
+ */
+std::vector<uint8_t>
+Bisect (const Graph &g, const std::vector<uint32_t> &vertices, double fraction)
+{
+  uint32_t n = vertices.size ();
+  std::vector<uint8_t> side (n, 1);
+  std::vector<int64_t> local (g.load.size (), -1);
+  std::vector<double> load (n);
+  double total = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      local[vertices[i]] = i;
+      load[i] = g.load[vertices[i]];
+      total += load[i];
+    }
+  if (total <= 0)
+    {
+      // Nothing to balance, split by count
+      std::fill (load.begin (), load.end (), 1);
+      total = n;
+    }
+  std::vector<std::vector<std::pair<uint32_t, double> > > adj (n);
+  std::vector<double> degree (n, 0);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      for (const std::pair<uint32_t, double> &e : g.adj[vertices[i]])
+        {
+          if (local[e.first] >= 0 && local[e.first] != i)
+            {
+              adj[i].push_back (std::make_pair (local[e.first], e.second));
+              degree[i] += e.second;
+            }
+        }
+    }
+  const double target[2] = {fraction * total, (1 - fraction) * total};
+
+  // Rate from each vertex to side 0, the gain of a move follows from it
+  std::vector<double> toZero (n, 0);
+  std::vector<uint32_t> neighboursInZero (n, 0);
+  double load0 = 0;
+  double cut = 0;
+  auto gain = [&] (uint32_t v) {
+      double external = side[v] == 0 ? degree[v] - toZero[v] : toZero[v];
+      return 2 * external - degree[v];
+    };
+  auto move = [&] (uint32_t v) {
+      cut -= gain (v);
+      double sign = side[v] == 0 ? -1 : 1;
+      side[v] = 1 - side[v];
+      load0 += sign * load[v];
+      for (const std::pair<uint32_t, double> &e : adj[v])
+        {
+          toZero[e.first] += sign * e.second;
+          if (side[v] == 0)
+            {
+              ++neighboursInZero[e.first];
+            }
+          else
+            {
+              --neighboursInZero[e.first];
+            }
+        }
+    };
+  auto imbalance = [&] (double l0) {
+      return std::max (l0 / target[0], (total - l0) / target[1]);
+    };
+
+  // Growing, from the last vertex reached by a breadth-first search
+  uint32_t seed = 0;
+  {
+    std::vector<bool> seen (n, false);
+    std::deque<uint32_t> queue (1, 0);
+    seen[0] = true;
+    while (!queue.empty ())
+      {
+        seed = queue.front ();
+        queue.pop_front ();
+        for (const std::pair<uint32_t, double> &e : adj[seed])
+          {
+            if (!seen[e.first])
+              {
+                seen[e.first] = true;
+                queue.push_back (e.first);
+              }
+          }
+      }
+  }
+  move (seed);
+  while (load0 < target[0])
+    {
+      // Best vertex on the boundary of side 0, any vertex if there is none
+      int64_t best = -1;
+      bool bestBoundary = false;
+      for (uint32_t v = 0; v < n; ++v)
+        {
+          if (side[v] == 0)
+            {
+              continue;
+            }
+          bool boundary = neighboursInZero[v] > 0;
+          if (best < 0 || (boundary && !bestBoundary)
+              || (boundary == bestBoundary && gain (v) > gain (best)))
+            {
+              best = v;
+              bestBoundary = boundary;
+            }
+        }
+      if (best < 0 || load0 + load[best] - target[0] > target[0] - load0)
+        {
+          break;
+        }
+      move (best);
+    }
+
+  // Refinement: each pass moves every vertex at most once, best move
+  // first, then rolls back to the best state it went through
+  const double maxImbalance = 1 + BALANCE_TOLERANCE;
+  for (uint32_t pass = 0; pass < REFINEMENT_PASSES; ++pass)
+    {
+      auto better = [&] (double cutA, double imbA, double cutB, double imbB) {
+          bool feasibleA = imbA <= maxImbalance;
+          bool feasibleB = imbB <= maxImbalance;
+          if (feasibleA != feasibleB)
+            {
+              return feasibleA;
+            }
+          if (cutA != cutB)
+            {
+              return cutA < cutB;
+            }
+          return imbA < imbB;
+        };
+      std::vector<bool> locked (n, false);
+      std::vector<uint32_t> moves;
+      double bestCut = cut;
+      double bestImbalance = imbalance (load0);
+      std::size_t bestMoves = 0;
+      for (uint32_t step = 0; step < n; ++step)
+        {
+          double current = imbalance (load0);
+          int64_t best = -1;
+          for (uint32_t v = 0; v < n; ++v)
+            {
+              if (locked[v])
+                {
+                  continue;
+                }
+              double after = imbalance (load0 + (side[v] == 0 ? -load[v] : load[v]));
+              if (after > maxImbalance && after >= current)
+                {
+                  continue;
+                }
+              if (best < 0 || gain (v) > gain (best))
+                {
+                  best = v;
+                }
+            }
+          if (best < 0)
+            {
+              break;
+            }
+          move (best);
+          locked[best] = true;
+          moves.push_back (best);
+          if (better (cut, imbalance (load0), bestCut, bestImbalance))
+            {
+              bestCut = cut;
+              bestImbalance = imbalance (load0);
+              bestMoves = moves.size ();
+            }
+        }
+      while (moves.size () > bestMoves)
+        {
+          move (moves.back ());
+          moves.pop_back ();
+        }
+      if (bestMoves == 0)
+        {
+          break;
+        }
+    }
+  return side;
+}
+
+/**
+ * Split a set of vertices into partitions by recursive bisection.
+ *
+ * \param [in] g The graph.
+ * \param [in] vertices The vertices to split.
+ * \param [in] first The first partition to use.
+ * \param [in] nPartitions The number of partitions to use.
+ * \param [out] partitionOf The partition of each vertex.
+ */
+void
+Split (const Graph &g, const std::vector<uint32_t> &vertices, uint32_t first, uint32_t nPartitions,
+       std::vector<uint32_t> &partitionOf)
+{
+  if (nPartitions == 1 || vertices.size () <= 1)
+    {
+      for (uint32_t v : vertices)
+        {
+          partitionOf[v] = first;
+        }
+      return;
+    }
+  uint32_t nFirst = nPartitions / 2;
+  std::vector<uint8_t> side = Bisect (g, vertices, static_cast<double> (nFirst) / nPartitions);
+  std::vector<uint32_t> halves[2];
+  for (uint32_t i = 0; i < vertices.size (); ++i)
+    {
+      halves[side[i]].push_back (vertices[i]);
+    }
+  Split (g, halves[0], first, nFirst, partitionOf);
+  Split (g, halves[1], first + nFirst, nPartitions - nFirst, partitionOf);
+}
+
+} // unnamed namespace
+
+void
+MultithreadedSimulatorHelper::Enable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+}
+
+bool
+MultithreadedSimulatorHelper::IsEnabled (void)
+{
+  return DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ()) != 0;
+}
+
+Time
+MultithreadedSimulatorHelper::Partition (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::vector<uint32_t> partitionOfNode (NodeList::GetNNodes ());
+  for (uint32_t i = 0; i < partitionOfNode.size (); ++i)
+    {
+      partitionOfNode[i] = NodeList::GetNode (i)->GetSystemId ();
+    }
+  return Partition (partitionOfNode);
+}
+
+Time
+MultithreadedSimulatorHelper::GetLookahead (const std::vector<uint32_t> &partitionOfNode)
+{
+  NS_LOG_FUNCTION (partitionOfNode.size ());
+  Time lookahead = Simulator::GetMaximumSimulationTime ();
+  for (ChannelList::Iterator c = ChannelList::Begin (); c != ChannelList::End (); ++c)
+    {
+      Ptr<Channel> channel = *c;
+      if (!IsCrossing (channel, partitionOfNode))
+        {
+          continue;
+        }
+      TimeValue delay;
+      if (!channel->GetAttributeFailSafe ("Delay", delay))
+        {
+          NS_FATAL_ERROR ("Channel " << channel->GetId () << " (" << channel->GetInstanceTypeId ().GetName ()
+                          << ") joins two partitions but has no Delay to derive the lookahead from");
+        }
+      lookahead = std::min (lookahead, delay.Get ());
+    }
+  return lookahead;
+}
+
+Time
+MultithreadedSimulatorHelper::Partition (const std::vector<uint32_t> &partitionOfNode)
+{
+  NS_LOG_FUNCTION (partitionOfNode.size ());
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl == 0)
+    {
+      return Simulator::GetMaximumSimulationTime ();
+    }
+
+  Time lookahead = GetLookahead (partitionOfNode);
+  NS_ABORT_MSG_IF (!lookahead.IsStrictlyPositive (),
+                   "A channel without propagation delay joins two partitions");
+  for (ChannelList::Iterator c = ChannelList::Begin (); c != ChannelList::End (); ++c)
+    {
+      Ptr<Channel> channel = *c;
+      if (IsCrossing (channel, partitionOfNode)
+          && !channel->SetAttributeFailSafe ("CrossPartition", BooleanValue (true)))
+        {
+          NS_FATAL_ERROR ("Channel " << channel->GetId () << " (" << channel->GetInstanceTypeId ().GetName ()
+                          << ") joins two partitions but cannot hand packets over between threads");
+        }
+    }
+  impl->SetPartitions (partitionOfNode, lookahead);
+  NS_LOG_INFO (impl->GetNPartitions () << " partitions, lookahead " << lookahead.As (Time::US));
+  return lookahead;
+}
+
+std::vector<uint32_t>
+MultithreadedSimulatorHelper::ComputePartitions (uint32_t nPartitions)
+{
+  NS_LOG_FUNCTION (nPartitions);
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<uint32_t> partitionOfNode (nNodes, 0);
+  if (nPartitions <= 1 || nNodes <= 1)
+    {
+      return partitionOfNode;
+    }
+
+  /** A channel, as a star from its first device. */
+  struct Link
+  {
+    uint32_t from;  //!< Node of the first device
+    uint32_t to;    //!< Node of another device
+    double rate;    //!< Data rate
+    Time delay;     //!< Delay, zero if the channel cannot join two partitions
+  };
+  std::vector<Link> links;
+  std::vector<double> load (nNodes, 0);
+  for (ChannelList::Iterator c = ChannelList::Begin (); c != ChannelList::End (); ++c)
+    {
+      Ptr<Channel> channel = *c;
+      if (channel->GetNDevices () < 2)
+        {
+          continue;
+        }
+      TimeValue delay;
+      struct TypeId::AttributeInformation info;
+      if (!channel->GetInstanceTypeId ().LookupAttributeByName ("CrossPartition", &info)
+          || !channel->GetAttributeFailSafe ("Delay", delay))
+        {
+          delay.Set (Time (0));
+        }
+      double rate = 0;
+      for (std::size_t i = 0; i < channel->GetNDevices (); ++i)
+        {
+          DataRateValue dataRate;
+          if (channel->GetDevice (i)->GetAttributeFailSafe ("DataRate", dataRate))
+            {
+              rate = std::max (rate, static_cast<double> (dataRate.Get ().GetBitRate ()));
+            }
+        }
+      rate = std::max (rate, 1.0);
+      uint32_t from = channel->GetDevice (0)->GetNode ()->GetId ();
+      for (std::size_t i = 1; i < channel->GetNDevices (); ++i)
+        {
+          Link link = {from, channel->GetDevice (i)->GetNode ()->GetId (), rate, delay.Get ()};
+          links.push_back (link);
+          load[link.from] += rate;
+          load[link.to] += rate;
+        }
+    }
+
+  // The lookahead: the largest delay whose shorter links leave groups
+  // of nodes small enough to balance, or as small as they get
+  std::vector<Time> delays;
+  for (const Link &link : links)
+    {
+      if (link.delay.IsStrictlyPositive ())
+        {
+          delays.push_back (link.delay);
+        }
+    }
+  if (delays.empty ())
+    {
+      return partitionOfNode;
+    }
+  std::sort (delays.begin (), delays.end (), std::greater<Time> ());
+  delays.erase (std::unique (delays.begin (), delays.end ()), delays.end ());
+  double total = 0;
+  for (double l : load)
+    {
+      total += l;
+    }
+  std::vector<double> heaviest (delays.size (), 0);
+  std::vector<std::vector<uint32_t> > groups (delays.size ());
+  for (std::size_t d = 0; d < delays.size (); ++d)
+    {
+      std::vector<uint32_t> parent (nNodes);
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          parent[i] = i;
+        }
+      for (const Link &link : links)
+        {
+          if (link.delay < delays[d])
+            {
+              parent[Find (parent, link.from)] = Find (parent, link.to);
+            }
+        }
+      std::vector<double> groupLoad (nNodes, 0);
+      groups[d].resize (nNodes);
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          groups[d][i] = Find (parent, i);
+          groupLoad[groups[d][i]] += load[i];
+          heaviest[d] = std::max (heaviest[d], groupLoad[groups[d][i]]);
+        }
+    }
+  double bound = std::max ((1 + BALANCE_TOLERANCE) * total / nPartitions,
+                           *std::min_element (heaviest.begin (), heaviest.end ()));
+  std::size_t chosen = 0;
+  while (heaviest[chosen] > bound)
+    {
+      ++chosen;
+    }
+
+  // Graph of the groups, joined by the links not shorter than delays[chosen]
+  std::map<uint32_t, uint32_t> vertexOfRoot;
+  std::vector<uint32_t> vertexOfNode (nNodes);
+  Graph g;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t root = groups[chosen][i];
+      std::map<uint32_t, uint32_t>::iterator it = vertexOfRoot.find (root);
+      if (it == vertexOfRoot.end ())
+        {
+          it = vertexOfRoot.insert (std::make_pair (root, g.load.size ())).first;
+          g.load.push_back (0);
+        }
+      vertexOfNode[i] = it->second;
+      g.load[it->second] += load[i];
+    }
+  g.adj.resize (g.load.size ());
+  for (const Link &link : links)
+    {
+      uint32_t a = vertexOfNode[link.from];
+      uint32_t b = vertexOfNode[link.to];
+      if (a != b)
+        {
+          g.adj[a].push_back (std::make_pair (b, link.rate));
+          g.adj[b].push_back (std::make_pair (a, link.rate));
+        }
+    }
+
+  std::vector<uint32_t> vertices (g.load.size ());
+  for (uint32_t v = 0; v < vertices.size (); ++v)
+    {
+      vertices[v] = v;
+    }
+  std::vector<uint32_t> partitionOfVertex (vertices.size (), 0);
+  Split (g, vertices, 0, nPartitions, partitionOfVertex);
+
+  // Number the partitions in the order of their first node, without gaps
+  std::map<uint32_t, uint32_t> renumber;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t partition = partitionOfVertex[vertexOfNode[i]];
+      std::map<uint32_t, uint32_t>::iterator it = renumber.find (partition);
+      if (it == renumber.end ())
+        {
+          it = renumber.insert (std::make_pair (partition, renumber.size ())).first;
+        }
+      partitionOfNode[i] = it->second;
+    }
+  NS_LOG_INFO (renumber.size () << " partitions of " << g.load.size () << " node groups, lookahead "
+               << GetLookahead (partitionOfNode).As (Time::US));
+  return partitionOfNode;
+}
+
+Time
+MultithreadedSimulatorHelper::AutoPartition (uint32_t nPartitions)
+{
+  NS_LOG_FUNCTION (nPartitions);
+  if (!IsEnabled ())
+    {
+      return Simulator::GetMaximumSimulationTime ();
+    }
+  return Partition (ComputePartitions (nPartitions));
+}
+
+} // namespace ns3
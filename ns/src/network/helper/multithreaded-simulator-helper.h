@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MULTITHREADED_SIMULATOR_HELPER_H
+#define MULTITHREADED_SIMULATOR_HELPER_H
+
+#include "ns3/nstime.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Set up a MultithreadedSimulatorImpl for the built topology.
+ *
+ * Typical use:
+ * \code
+ *   MultithreadedSimulatorHelper::Enable ();   // before any Simulator call
+ *   ... create the nodes, with a system id per partition, and the links ...
+ *   MultithreadedSimulatorHelper::Partition ();
+ *   Simulator::Run ();
+ * \endcode
+ *
+ * Partition derives the lookahead from the \c Delay attribute of the
+ * channels joining two partitions and sets their \c CrossPartition
+ * attribute, so that they hand over private packet copies.  A channel
+ * joining two partitions without both attributes (currently only the
+ * PointToPointChannel has them) is a fatal error.
+ *
+ * Instead of assigning system ids by hand, AutoPartition splits the
+ * built topology into a given number of partitions:
+ * \code
+ *   MultithreadedSimulatorHelper::Enable ();
+ *   ... create the nodes and the links ...
+ *   MultithreadedSimulatorHelper::AutoPartition (4);
+ *   Simulator::Run ();
+ * \endcode
+ *
+ * ComputePartitions first picks the lookahead: the largest channel delay
+ * such that the groups of nodes tied together by the shorter channels
+ * can still be spread over the partitions with balanced loads.  It then
+ * splits these groups by recursive bisection, each bisection grown
+ * greedily from a peripheral group and refined with Fiduccia-Mattheyses
+ * passes, so as to cut as little data rate as possible.  The load of a
+ * node, and the cost of cutting a channel, are estimated from the
+ * \c DataRate attribute of the devices, as a proxy for their packet rate.
+ */
+class MultithreadedSimulatorHelper
+{
+public:
+  /**
+   * Select the MultithreadedSimulatorImpl.  Must be called before the
+   * simulator is first used, like the other SimulatorImplementationType.
+   */
+  static void Enable (void);
+  /**
+   * \returns \c true if the simulator is a MultithreadedSimulatorImpl.
+   */
+  static bool IsEnabled (void);
+  /**
+   * Use the system id of each node as its partition.
+   *
+   * Does nothing if the simulator is not a MultithreadedSimulatorImpl.
+   *
+   * \returns The lookahead.
+   */
+  static Time Partition (void);
+  /**
+   * Set the partitions.
+   *
+   * Does nothing if the simulator is not a MultithreadedSimulatorImpl.
+   *
+   * \param [in] partitionOfNode The partition of each node, indexed by node id.
+   * \returns The lookahead.
+   */
+  static Time Partition (const std::vector<uint32_t> &partitionOfNode);
+  /**
+   * Compute the lookahead of a partitioning.
+   *
+   * \param [in] partitionOfNode The partition of each node, indexed by node id.
+   * \returns The smallest delay of the channels joining two partitions,
+   *          Simulator::GetMaximumSimulationTime if there is none.
+   */
+  static Time GetLookahead (const std::vector<uint32_t> &partitionOfNode);
+  /**
+   * Split the nodes into partitions.
+   *
+   * Only the channels with both a \c Delay and a \c CrossPartition
+   * attribute, and a positive delay, can join two partitions.  Fewer
+   * partitions are returned when the topology cannot use them all.
+   *
+   * \param [in] nPartitions The number of partitions wanted.
+   * \returns The partition of each node, indexed by node id, node 0
+   *          being in partition 0.
+   */
+  static std::vector<uint32_t> ComputePartitions (uint32_t nPartitions);
+  /**
+   * Split the nodes into partitions with ComputePartitions, and set them.
+   *
+   * Does nothing if the simulator is not a MultithreadedSimulatorImpl.
+   *
+   * \param [in] nPartitions The number of partitions wanted.
+   * \returns The lookahead.
+   */
+  static Time AutoPartition (uint32_t nPartitions);
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_HELPER_H */
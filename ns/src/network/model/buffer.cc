@@ -50,7 +50,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+NS_THREAD_LOCAL uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -68,6 +68,15 @@ uint32_t Buffer::g_recommendedStart = 0;
  * which the compiler assigns to zero-memory which is initialized to _zero_
  * before the constructors run so this ensures perfect handling of crazy 
  * constructor orderings.
+ * The free lists and the heuristics are per thread, so that the threads
+ * of a MultithreadedSimulatorImpl do not share them.  The free lists of
+ * a thread are released by a thread-local destructor registered when
+ * the lists are created.
+ *
+ * There is one free list per size class, the storage of the buffers of
+ * a class being rounded up to the size of the class, so that a recycled
+ * buffer serves any later request of its class whatever the other sizes
+ * in use.  Larger buffers are not pooled.
  */
 #define MAGIC_DESTROYED (~(long) 0)
 #define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
@@ -75,43 +84,70 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+NS_THREAD_LOCAL Buffer::FreeList *Buffer::g_freeList = 0;
+const uint32_t Buffer::FREE_LIST_MIN_SIZE;
+const uint32_t Buffer::FREE_LIST_CLASSES;
+
+/** Total storage kept by the free list of a size class [bytes]. */
+static const uint32_t FREE_LIST_MAX_BYTES = 1 << 20;
+/** Buffers kept by the free list of a size class. */
+static const uint32_t FREE_LIST_MAX_LENGTH = 1000;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
   NS_LOG_FUNCTION (this);
   if (IS_INITIALIZED (g_freeList))
     {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
+      for (uint32_t c = 0; c < FREE_LIST_CLASSES; c++)
         {
-          Buffer::Deallocate (*i);
+          for (Buffer::FreeList::iterator i = g_freeList[c].begin ();
+               i != g_freeList[c].end (); i++)
+            {
+              Buffer::Deallocate (*i);
+            }
         }
-      delete g_freeList;
+      delete [] g_freeList;
       g_freeList = DESTROYED;
     }
 }
 
+uint32_t
+Buffer::GetSizeClass (uint32_t size)
+{
+  uint32_t c = 0;
+  uint32_t classSize = FREE_LIST_MIN_SIZE;
+  while (classSize < size && c < FREE_LIST_CLASSES)
+    {
+      classSize <<= 1;
+      c++;
+    }
+  return c;
+}
+
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
+  uint32_t c = GetSizeClass (data->m_size);
+  if (c == FREE_LIST_CLASSES)
+    {
+      /* too large to be pooled */
+      Buffer::Deallocate (data);
+      return;
+    }
   NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
+  NS_ASSERT (data->m_size == FREE_LIST_MIN_SIZE << c);
+  /* feed into the free list of its size class */
+  if (IS_DESTROYED (g_freeList) ||
+      g_freeList[c].size () >= std::min (FREE_LIST_MAX_LENGTH, FREE_LIST_MAX_BYTES / data->m_size))
     {
       Buffer::Deallocate (data);
     }
   else
     {
       NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
+      g_freeList[c].push_back (data);
     }
 }
 
@@ -119,26 +155,26 @@ Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
+  uint32_t c = GetSizeClass (dataSize);
+  if (c == FREE_LIST_CLASSES)
+    {
+      return Buffer::Allocate (dataSize);
+    }
+  /* try to reuse a buffer of the size class. */
   if (IS_UNINITIALIZED (g_freeList))
     {
-      g_freeList = new Buffer::FreeList ();
+      g_freeList = new Buffer::FreeList [FREE_LIST_CLASSES];
+      static thread_local struct LocalStaticDestructor localStaticDestructor;
+      (void)localStaticDestructor;
     }
-  else if (IS_INITIALIZED (g_freeList))
+  else if (IS_INITIALIZED (g_freeList) && !g_freeList[c].empty ())
     {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
+      struct Buffer::Data *data = g_freeList[c].back ();
+      g_freeList[c].pop_back ();
+      data->m_count = 1;
+      return data;
     }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
+  struct Buffer::Data *data = Buffer::Allocate (FREE_LIST_MIN_SIZE << c);
   NS_ASSERT (data->m_count == 1);
   return data;
 }
@@ -244,7 +280,8 @@ void
 Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
-  m_data = Buffer::Create (0);
+  // Leave room for the headers usually added in front of the data
+  m_data = Buffer::Create (g_recommendedStart);
   m_start = std::min (m_data->m_size, g_recommendedStart);
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
@@ -401,9 +438,7 @@ Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
 
-  if (m_data->m_count == 1 &&
-      (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-      m_end == m_data->m_dirtyEnd &&
+  if ((m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
       o.m_start == o.m_zeroAreaStart &&
       o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
     {
@@ -412,6 +447,30 @@ Buffer::AddAtEnd (const Buffer &o)
        * we attempt to aggregate two buffers which contain
        * adjacent zero areas.
        */
+      if (m_data->m_count > 1 || m_end != m_data->m_dirtyEnd)
+        {
+          /* The data is shared, typically by the fragments of a packet:
+           * take a private copy of the bytes outside of the zero area
+           * only, so that the zero area stays virtual.
+           */
+          uint32_t internalSize = GetInternalSize ();
+          struct Buffer::Data *newData = Buffer::Create (internalSize);
+          memcpy (newData->m_data, m_data->m_data + m_start, internalSize);
+          m_data->m_count--;
+          if (m_data->m_count == 0)
+            {
+              Buffer::Recycle (m_data);
+            }
+          m_data = newData;
+
+          int32_t delta = -m_start;
+          m_zeroAreaStart += delta;
+          m_zeroAreaEnd += delta;
+          m_end += delta;
+          m_start += delta;
+          m_data->m_dirtyStart = m_start;
+          m_data->m_dirtyEnd = m_end;
+        }
       if (m_zeroAreaStart == m_zeroAreaEnd)
         {
           m_zeroAreaStart = m_end;
@@ -844,25 +903,36 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // the destination may be after our own zero area
+  uint8_t *to;
+  if (m_current <= m_zeroStart)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
   m_current += toCopy;
 }
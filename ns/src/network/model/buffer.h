@@ -24,6 +24,7 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#include "ns3/thread-local.h"
 
 #define BUFFER_FREE_LIST 1
 
@@ -767,7 +768,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static NS_THREAD_LOCAL uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -791,16 +792,24 @@ private:
   uint32_t m_end;
 
 #ifdef BUFFER_FREE_LIST
+  /**
+   * \brief Get the size class of a buffer data storage size
+   * \param size the storage size
+   * \returns the smallest size class whose storage is large enough,
+   *          FREE_LIST_CLASSES if the size is too large to be pooled
+   */
+  static uint32_t GetSizeClass (uint32_t size);
+
   /// Container for buffer data
   typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
+  /// Local static destructor structure, releases the free lists of a thread
   struct LocalStaticDestructor 
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  static const uint32_t FREE_LIST_MIN_SIZE = 64; //!< Storage size of the smallest size class
+  static const uint32_t FREE_LIST_CLASSES = 11;  //!< Number of size classes, doubling in size
+  static NS_THREAD_LOCAL FreeList *g_freeList; //!< Buffer data containers, one per size class and per thread
 #endif
 };
 
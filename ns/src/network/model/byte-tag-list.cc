@@ -19,6 +19,7 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
+#include "ns3/thread-local.h"
 #include <vector>
 #include <cstring>
 #include <limits>
@@ -53,12 +54,14 @@ struct ByteTagListData {
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
+class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
 {
 public:
   ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+};
+static NS_THREAD_LOCAL ByteTagListDataFreeList g_freeList; //!< Container for struct ByteTagListData, one per thread
+static NS_THREAD_LOCAL bool g_freeListDestroyed = false; //!< Has the free list of this thread been destroyed
+static NS_THREAD_LOCAL uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList ()
 {
@@ -69,6 +72,7 @@ ByteTagListDataFreeList::~ByteTagListDataFreeList ()
       uint8_t *buffer = (uint8_t *)(*i);
       delete [] buffer;
     }
+  g_freeListDestroyed = true;
 }
 #endif /* USE_FREE_LIST */
 
@@ -159,6 +163,10 @@ ByteTagList::ByteTagList (const ByteTagList &o)
     {
       m_data->count++;
     }
+  else
+    {
+      std::memcpy (m_inline, o.m_inline, m_used);
+    }
 }
 ByteTagList &
 ByteTagList::operator = (const ByteTagList &o)
@@ -178,6 +186,10 @@ ByteTagList::operator = (const ByteTagList &o)
     {
       m_data->count++;
     }
+  else
+    {
+      std::memcpy (m_inline, o.m_inline, m_used);
+    }
   return *this;
 }
 ByteTagList::~ByteTagList ()
@@ -196,9 +208,12 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
   NS_ASSERT (m_used <= spaceNeeded);
   if (m_data == 0)
     {
-      m_data = Allocate (spaceNeeded);
-      m_used = 0;
-    } 
+      if (spaceNeeded > INLINE_SIZE)
+        {
+          m_data = Allocate (spaceNeeded);
+          std::memcpy (&m_data->data, m_inline, m_used);
+        }
+    }
   else if (m_data->size < spaceNeeded ||
            (m_data->count != 1 && m_data->dirty != m_used))
     {
@@ -207,8 +222,8 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       Deallocate (m_data);
       m_data = newData;
     }
-  TagBuffer tag = TagBuffer (&m_data->data[m_used], 
-                             &m_data->data[spaceNeeded]);
+  uint8_t *storage = GetStorage ();
+  TagBuffer tag = TagBuffer (&storage[m_used], &storage[spaceNeeded]);
   tag.WriteU32 (tid.GetUid ());
   tag.WriteU32 (bufferSize);
   tag.WriteU32 (start - m_adjustment);
@@ -222,7 +237,10 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       m_maxEnd = end - m_adjustment;
     }
   m_used = spaceNeeded;
-  m_data->dirty = m_used;
+  if (m_data != 0)
+    {
+      m_data->dirty = m_used;
+    }
   return tag;
 }
 
@@ -264,14 +282,51 @@ ByteTagList::Iterator
 ByteTagList::Begin (int32_t offsetStart, int32_t offsetEnd) const
 {
   NS_LOG_FUNCTION (this << offsetStart << offsetEnd);
-  if (m_data == 0)
+  uint8_t *storage = GetStorage ();
+  return Iterator (storage, &storage[m_used], offsetStart, offsetEnd, m_adjustment);
+}
+
+bool
+ByteTagList::FindFirst (TypeId tid, int32_t offsetStart, int32_t offsetEnd,
+                        ByteTagList::Iterator::Item &item) const
+{
+  NS_LOG_FUNCTION (this << tid << offsetStart << offsetEnd);
+  uint8_t *current = GetStorage ();
+  uint8_t *end = &current[m_used];
+  uint32_t uid = tid.GetUid ();
+  while (current < end)
     {
-      return Iterator (0, 0, offsetStart, offsetEnd, 0);
+      TagBuffer buf = TagBuffer (current, end);
+      uint32_t nextTid = buf.ReadU32 ();
+      uint32_t nextSize = buf.ReadU32 ();
+      uint8_t *next = current + 4 + 4 + 4 + 4 + nextSize;
+      if (nextTid == uid)
+        {
+          int32_t nextStart = buf.ReadU32 () + m_adjustment;
+          int32_t nextEnd = buf.ReadU32 () + m_adjustment;
+          if (nextStart < offsetEnd && nextEnd > offsetStart)
+            {
+              item.tid = tid;
+              item.size = nextSize;
+              item.start = std::max (nextStart, offsetStart);
+              item.end = std::min (nextEnd, offsetEnd);
+              item.buf = TagBuffer (current + 16, next);
+              return true;
+            }
+        }
+      current = next;
     }
-  else
+  return false;
+}
+
+uint8_t *
+ByteTagList::GetStorage (void) const
+{
+  if (m_data != 0)
     {
-      return Iterator (m_data->data, &m_data->data[m_used], offsetStart, offsetEnd, m_adjustment);
+      return m_data->data;
     }
+  return const_cast<uint8_t *> (m_inline);
 }
 
 void 
@@ -345,7 +400,7 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  while (!g_freeListDestroyed && !g_freeList.empty ())
     {
       struct ByteTagListData *data = g_freeList.back ();
       g_freeList.pop_back ();
@@ -379,7 +434,8 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
+      if (g_freeListDestroyed ||
+          g_freeList.size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
           uint8_t *buffer = (uint8_t *)data;
@@ -45,9 +45,11 @@ struct ByteTagListData;
  *     as 4 32bit integers (TypeId, tag data size, start, end) followed 
  *     by the tag data as generated by Tag::Serialize.
  *
- *   - The struct ByteTagListData structure which contains the tag byte buffer
- *     is shared and, thus, reference-counted. This data structure is unshared
- *     as-needed to emulate COW semantics.
+ *   - Up to INLINE_SIZE bytes of tags, typically one or two small tags,
+ *     are stored in the ByteTagList itself, and copied with it.  Larger
+ *     lists move to a struct ByteTagListData, which contains the tag byte
+ *     buffer and is shared and, thus, reference-counted. This data
+ *     structure is unshared as-needed to emulate COW semantics.
  *
  *   - Each tag tags a unique set of bytes identified by the pair of offsets
  *     (start,end). These offsets are relative to the start of the packet
@@ -203,9 +205,25 @@ private:
    * The returned iterator will allow you to loop through the set of tags present
    * in this list: the boundaries of each tag as reported by their start and
    * end offsets will be included within the input offsetStart and offsetEnd.
+   * The iterator must not be used after the list is modified or destroyed.
    */
   ByteTagList::Iterator Begin (int32_t offsetStart, int32_t offsetEnd) const;
 
+  /**
+   * \brief Find the first tag of a type within a byte range.
+   *
+   * Equivalent to looping with Begin until an item of type \p tid, but
+   * only the tags of that type are decoded.
+   *
+   * \param [in] tid The type of the tag.
+   * \param [in] offsetStart The offset of the first byte of the range.
+   * \param [in] offsetEnd The offset of the end of the range.
+   * \param [out] item The tag found, with its boundaries within the range.
+   * \returns \c true if a tag was found.
+   */
+  bool FindFirst (TypeId tid, int32_t offsetStart, int32_t offsetEnd,
+                  ByteTagList::Iterator::Item &item) const;
+
   /**
    * Adjust the offsets stored internally by the adjustment delta.
    *
@@ -275,11 +293,20 @@ private:
    */
   void Deallocate (struct ByteTagListData *data);
 
+  /**
+   * \returns The tag byte buffer, inline or in m_data.
+   */
+  uint8_t *GetStorage (void) const;
+
+  /** Bytes of tags stored without a ByteTagListData: two 4 byte tags. */
+  static const uint32_t INLINE_SIZE = 2 * (4 + 4 + 4 + 4 + 4);
+
   int32_t m_minStart; //!< minimal start offset
   int32_t m_maxEnd; //!< maximal end offset
   int32_t m_adjustment; //!< adjustment to byte tag offsets
   uint32_t m_used; //!< the number of used bytes in the buffer
-  struct ByteTagListData *m_data; //!< the ByteTagListData structure
+  struct ByteTagListData *m_data; //!< the ByteTagListData structure, 0 if the tags are inline
+  uint8_t m_inline[INLINE_SIZE]; //!< the tags, if they fit and m_data is 0
 };
 
 void
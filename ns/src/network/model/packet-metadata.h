@@ -26,6 +26,7 @@
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
+#include "ns3/thread-local.h"
 #include "buffer.h"
 
 namespace ns3 {
@@ -661,7 +662,8 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
+  static NS_THREAD_LOCAL DataFreeList m_freeList; //!< the metadata data storage, one per thread
+  static NS_THREAD_LOCAL bool m_freeListDestroyed; //!< Has the free list of this thread been destroyed
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -672,8 +674,8 @@ public:
    */
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+  static NS_THREAD_LOCAL uint32_t m_maxSize; //!< maximum metadata size
+  static NS_THREAD_LOCAL uint16_t m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
   /*
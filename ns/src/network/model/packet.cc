@@ -28,7 +28,7 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+NS_THREAD_LOCAL uint32_t Packet::m_globalUid = 0;
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -134,7 +134,9 @@ Packet::Packet ()
      * metadata is for the system id. For non-
      * distributed simulations, this is simply 
      * zero.  The lower 32 bits are for the 
-     * global UID
+     * global UID, counted per thread: each
+     * thread of a multithreaded simulation has
+     * its own system id.
      */
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
     m_nixVector (0)
@@ -938,16 +940,11 @@ Packet::GetByteTagIterator (void) const
 bool 
 Packet::FindFirstMatchingByteTag (Tag &tag) const
 {
-  TypeId tid = tag.GetInstanceTypeId ();
-  ByteTagIterator i = GetByteTagIterator ();
-  while (i.HasNext ())
+  ByteTagList::Iterator::Item item = ByteTagList::Iterator::Item (TagBuffer (0, 0));
+  if (m_byteTagList.FindFirst (tag.GetInstanceTypeId (), 0, GetSize (), item))
     {
-      ByteTagIterator::Item item = i.Next ();
-      if (tid == item.GetTypeId ())
-        {
-          item.GetTag (tag);
-          return true;
-        }
+      tag.Deserialize (item.buf);
+      return true;
     }
   return false;
 }
@@ -387,6 +387,39 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // Merging fragments which share their data must not materialize the
+  // zero area.
+  buffer = Buffer (1000);
+  buffer.AddAtStart (2);
+  i = buffer.Begin ();
+  i.WriteU8 (0x55);
+  i.WriteU8 (0x66);
+  Buffer trailer = Buffer (100);
+  trailer.AddAtEnd (1);
+  i = trailer.End ();
+  i.Prev ();
+  i.WriteU8 (0x77);
+  Buffer merged = buffer.CreateFragment (0, 600);
+  merged.AddAtEnd (buffer.CreateFragment (600, 402));
+  merged.AddAtEnd (trailer.CreateFragment (0, 101));
+  NS_TEST_ASSERT_MSG_EQ (merged.GetSize (), 1103, "Bad size of the merged fragments");
+  NS_TEST_ASSERT_MSG_EQ (merged.GetSerializedSize (), 20, "Zero area of the merged fragments materialized");
+  i = merged.Begin ();
+  uint16_t first = i.ReadNtohU16 ();
+  NS_TEST_ASSERT_MSG_EQ (first, 0x5566, "Bad first bytes of the merged fragments");
+  uint32_t nonZero = 0;
+  for (uint32_t k = 2; k < 1102; ++k)
+    {
+      nonZero += i.ReadU8 () != 0;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nonZero, 0, "Bad zero area of the merged fragments");
+  uint8_t last = i.ReadU8 ();
+  NS_TEST_ASSERT_MSG_EQ (last, 0x77, "Bad last byte of the merged fragments");
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 1002, "Merging changed the original buffer");
+  i = buffer.Begin ();
+  first = i.ReadNtohU16 ();
+  NS_TEST_ASSERT_MSG_EQ (first, 0x5566, "Merging changed the original buffer");
 }
 
 /**
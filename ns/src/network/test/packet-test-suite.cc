@@ -858,7 +858,58 @@ PacketTest::DoRun (void)
   {
     Ptr<Packet> tmp = Create<Packet> (0);
     ALargeTestTag a;
-    tmp->AddPacketTag (a); 
+    tmp->AddPacketTag (a);
+  }
+
+  /* Test byte ranges of small tags, stored inline, and of the
+   * lists they spill to, across CreateFragment and AddAtEnd.
+   */
+  {
+    Ptr<Packet> write1 = Create<Packet> (1440);
+    write1->AddByteTag (ATestTag<3> (1));
+    Ptr<Packet> write2 = Create<Packet> (1440);
+    write2->AddByteTag (ATestTag<3> (2));
+
+    // A segment joining the end of a write to the start of the next one
+    Ptr<Packet> segment = write1->CreateFragment (1000, 440);
+    CHECK_DATA (segment, 1, E_DATA (3, 0, 440, 1));
+    segment->AddAtEnd (write2->CreateFragment (0, 1008));
+    CHECK_DATA (segment, 2, E_DATA (3, 0, 440, 1), E_DATA (3, 440, 1448, 2));
+    CHECK_DATA (write1, 1, E_DATA (3, 0, 1440, 1));
+    CHECK_DATA (write2, 1, E_DATA (3, 0, 1440, 2));
+
+    // The third tag spills the list, the copies stay independent
+    Ptr<Packet> copy = segment->Copy ();
+    copy->AddByteTag (ATestTag<4> (3));
+    CHECK_DATA (copy, 3, E_DATA (3, 0, 440, 1), E_DATA (3, 440, 1448, 2), E_DATA (4, 0, 1448, 3));
+    CHECK_DATA (segment, 2, E_DATA (3, 0, 440, 1), E_DATA (3, 440, 1448, 2));
+
+    Ptr<Packet> frag = copy->CreateFragment (400, 100);
+    CHECK_DATA (frag, 3, E_DATA (3, 0, 40, 1), E_DATA (3, 40, 100, 2), E_DATA (4, 0, 100, 3));
+    frag->AddAtEnd (segment->CreateFragment (0, 10));
+    CHECK_DATA (frag, 4, E_DATA (3, 0, 40, 1), E_DATA (3, 40, 100, 2), E_DATA (4, 0, 100, 3),
+                E_DATA (3, 100, 110, 1));
+
+    segment->AddHeader (ATestHeader<20> ());
+    CHECK_DATA (segment, 2, E_DATA (3, 20, 460, 1), E_DATA (3, 460, 1468, 2));
+
+    // The lookup by type only sees the tags within the packet
+    ATestTag<3> tag;
+    NS_TEST_EXPECT_MSG_EQ (segment->FindFirstMatchingByteTag (tag), true, "tag not found");
+    NS_TEST_EXPECT_MSG_EQ (tag.GetData (), 1, "wrong tag found");
+    Ptr<Packet> tail = segment->CreateFragment (460, 100);
+    NS_TEST_EXPECT_MSG_EQ (tail->FindFirstMatchingByteTag (tag), true, "tag not found");
+    NS_TEST_EXPECT_MSG_EQ (tag.GetData (), 2, "wrong tag found");
+    NS_TEST_EXPECT_MSG_EQ (tag.m_error, false, "wrong tag data");
+    ATestTag<4> other;
+    NS_TEST_EXPECT_MSG_EQ (tail->FindFirstMatchingByteTag (other), false, "unexpected tag");
+    NS_TEST_EXPECT_MSG_EQ (frag->FindFirstMatchingByteTag (other), true, "tag not found");
+    NS_TEST_EXPECT_MSG_EQ (other.GetData (), 3, "wrong tag found");
+
+    segment->RemoveAllByteTags ();
+    CHECK (segment, 0, E (0, 0, 0));
+    segment->AddByteTag (ATestTag<3> (4));
+    CHECK_DATA (segment, 1, E_DATA (3, 0, 1468, 4));
   }
 }
 
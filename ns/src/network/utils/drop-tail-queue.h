@@ -105,7 +105,7 @@ DropTailQueue<Item>::Enqueue (Ptr<Item> item)
 {
   NS_LOG_FUNCTION (this << item);
 
-  return DoEnqueue (end (), item);
+  return DoEnqueue (end (), std::move (item));
 }
 
 template <typename Item>
@@ -29,7 +29,7 @@ NS_LOG_COMPONENT_DEFINE ("QueueItem");
 QueueItem::QueueItem (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
-  m_packet = p;
+  m_packet = std::move (p);
 }
 
 QueueItem::~QueueItem ()
@@ -38,7 +38,7 @@ QueueItem::~QueueItem ()
   m_packet = 0;
 }
 
-Ptr<Packet>
+const Ptr<Packet> &
 QueueItem::GetPacket (void) const
 {
   NS_LOG_FUNCTION (this);
@@ -74,7 +74,7 @@ std::ostream & operator << (std::ostream &os, const QueueItem &item)
 
 
 QueueDiscItem::QueueDiscItem (Ptr<Packet> p, const Address& addr, uint16_t protocol)
-  : QueueItem (p),
+  : QueueItem (std::move (p)),
     m_address (addr),
     m_protocol (protocol),
     m_txq (0)
@@ -146,4 +146,15 @@ QueueDiscItem::Hash (uint32_t perturbation) const
   return 0;
 }
 
+uint32_t
+QueueDiscItem::PerturbHash (uint64_t flowHash, uint32_t perturbation)
+{
+  // Spread the perturbation into a multiplier with the splitmix64 finalizer
+  uint64_t a = (perturbation + UINT64_C (1)) * UINT64_C (0x9e3779b97f4a7c15);
+  a = (a ^ (a >> 30)) * UINT64_C (0xbf58476d1ce4e5b9);
+  a = (a ^ (a >> 27)) * UINT64_C (0x94d049bb133111eb);
+  a ^= a >> 31;
+  return static_cast<uint32_t> (((a | 1) * flowHash) >> 32);
+}
+
 } // namespace ns3
@@ -55,9 +55,9 @@ public:
   virtual ~QueueItem ();
 
   /**
-   * \return the packet included in this item.
+   * \return the packet included in this item, valid as long as the item.
    */
-  Ptr<Packet> GetPacket (void) const;
+  const Ptr<Packet> &GetPacket (void) const;
 
   /**
    * \brief Use this method (instead of GetPacket ()->GetSize ()) to get the packet size
@@ -226,6 +226,21 @@ public:
    */
   virtual uint32_t Hash (uint32_t perturbation = 0) const;
 
+protected:
+  /**
+   * \brief Derive the hash of a perturbation from the hash of a flow
+   *
+   * Subclasses can hash the fields of a flow once, in 64 bits, and derive
+   * the hashes of the different perturbations from it by multiply-shift:
+   * each perturbation selects an odd multiplier, and the hash is the high
+   * half of the product.
+   *
+   * \param flowHash the 64-bit hash of the flow
+   * \param perturbation hash perturbation value
+   * \return the 32-bit hash of the flow for this perturbation
+   */
+  static uint32_t PerturbHash (uint64_t flowHash, uint32_t perturbation);
+
 private:
   /**
    * \brief Default constructor
@@ -34,6 +34,7 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <utility>
 
 namespace ns3 {
 
@@ -297,6 +298,11 @@ public:
    */
   void Flush (void);
 
+  /**
+   * \return true if a sink is connected to the Dequeue trace source
+   */
+  bool IsDequeueTraced (void) const;
+
   /// Define ItemType as the type of the stored elements
   typedef Item ItemType;
 
@@ -495,7 +501,7 @@ bool
 Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item)
 {
   Iterator ret;
-  return DoEnqueue (pos, item, ret);
+  return DoEnqueue (pos, std::move (item), ret);
 }
 
 template <typename Item>
@@ -511,9 +517,9 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item, Iterator& ret)
       return false;
     }
 
-  ret = m_packets.insert (pos, item);
-
   uint32_t size = item->GetSize ();
+  ret = m_packets.insert (pos, std::move (item));
+
   m_nBytes += size;
   m_nTotalReceivedBytes += size;
 
@@ -521,7 +527,7 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item, Iterator& ret)
   m_nTotalReceivedPackets++;
 
   NS_LOG_LOGIC ("m_traceEnqueue (p)");
-  m_traceEnqueue (item);
+  m_traceEnqueue (*ret);
 
   return true;
 }
@@ -538,8 +544,10 @@ Queue<Item>::DoDequeue (ConstIterator pos)
       return 0;
     }
 
-  Ptr<Item> item = *pos;
-  m_packets.erase (pos);
+  // Empty range erase to get a mutable iterator, and take over the item
+  Iterator it = m_packets.erase (pos, pos);
+  Ptr<Item> item = std::move (*it);
+  m_packets.erase (it);
 
   if (item != 0)
     {
@@ -567,8 +575,10 @@ Queue<Item>::DoRemove (ConstIterator pos)
       return 0;
     }
 
-  Ptr<Item> item = *pos;
-  m_packets.erase (pos);
+  // Empty range erase to get a mutable iterator, and take over the item
+  Iterator it = m_packets.erase (pos, pos);
+  Ptr<Item> item = std::move (*it);
+  m_packets.erase (it);
 
   if (item != 0)
     {
@@ -598,6 +608,13 @@ Queue<Item>::Flush (void)
     }
 }
 
+template <typename Item>
+bool
+Queue<Item>::IsDequeueTraced (void) const
+{
+  return !m_traceDequeue.IsEmpty ();
+}
+
 template <typename Item>
 void
 Queue<Item>::DoDispose (void)
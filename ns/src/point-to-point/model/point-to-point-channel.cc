@@ -19,10 +19,14 @@
 #include "point-to-point-channel.h"
 #include "point-to-point-net-device.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/boolean.h"
+#include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PointToPointChannel");
@@ -40,6 +44,22 @@ PointToPointChannel::GetTypeId (void)
                    TimeValue (Seconds (0)),
                    MakeTimeAccessor (&PointToPointChannel::m_delay),
                    MakeTimeChecker ())
+    .AddAttribute ("CrossPartition",
+                   "Whether the two devices are run by different partitions of a "
+                   "MultithreadedSimulatorImpl.  The receiving side then gets a "
+                   "private copy of each packet, which shares no data with the sender. "
+                   "Set by MultithreadedSimulatorHelper.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointChannel::m_crossPartition),
+                   MakeBooleanChecker ())
+    .AddAttribute ("InFlightQueue",
+                   "If true, the packets in flight on each wire are kept in a FIFO "
+                   "queue with their arrival times, and only the next arrival on "
+                   "each wire is scheduled, instead of one event per packet.  The "
+                   "packets arrive at the same times.  Ignored between partitions.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointChannel::m_inFlightQueue),
+                   MakeBooleanChecker ())
     .AddTraceSource ("TxRxPointToPoint",
                      "Trace source indicating transmission of packet "
                      "from the PointToPointChannel, used by the Animation "
@@ -57,11 +77,26 @@ PointToPointChannel::PointToPointChannel()
   :
     Channel (),
     m_delay (Seconds (0.)),
-    m_nDevices (0)
+    m_nDevices (0),
+    m_crossPartition (false),
+    m_inFlightQueue (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+PointToPointChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  for (std::size_t i = 0; i < N_DEVICES; ++i)
+    {
+      m_link[i].m_inFlight.clear ();
+      m_link[i].m_inFlightHead = 0;
+      m_link[i].m_inFlightSize = 0;
+    }
+  Channel::DoDispose ();
+}
+
 void
 PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
 {
@@ -78,6 +113,14 @@ PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
     {
       m_link[0].m_dst = m_link[1].m_src;
       m_link[1].m_dst = m_link[0].m_src;
+      for (std::size_t i = 0; i < N_DEVICES; ++i)
+        {
+          Ptr<Node> node = m_link[i].m_dst->GetNode ();
+          if (node != 0)
+            {
+              m_link[i].m_dstNodeId = node->GetId ();
+            }
+        }
       m_link[0].m_state = IDLE;
       m_link[1].m_state = IDLE;
     }
@@ -96,16 +139,100 @@ PointToPointChannel::TransmitStart (
   NS_ASSERT (m_link[1].m_state != INITIALIZING);
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+  if (m_link[wire].m_dstNodeId == 0xffffffff)
+    {
+      // The device was attached before it was added to its node
+      m_link[wire].m_dstNodeId = m_link[wire].m_dst->GetNode ()->GetId ();
+    }
 
-  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
-                                  txTime + m_delay, &PointToPointNetDevice::Receive,
-                                  m_link[wire].m_dst, p->Copy ());
+  if (m_crossPartition)
+    {
+      // The receiver runs in another thread: hand over a packet built
+      // from the serialized one, which shares no buffer or tag data
+      // with this side, and do not touch the reference count of the
+      // receiving device.
+      std::vector<uint8_t> buffer (p->GetSerializedSize ());
+      p->Serialize (&buffer[0], buffer.size ());
+      Simulator::ScheduleWithContext (m_link[wire].m_dstNodeId,
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      PeekPointer (m_link[wire].m_dst),
+                                      Create<Packet> (&buffer[0], buffer.size (), true));
+    }
+  else if (m_inFlightQueue && !OvertakesInFlight (wire, Simulator::Now () + txTime + m_delay))
+    {
+      // The packets arrive in the order they are sent: append this one to
+      // the ring of the wire, growing it when full
+      Link &link = m_link[wire];
+      if (link.m_inFlightSize == link.m_inFlight.size ())
+        {
+          std::vector<InFlight> ring (std::max<std::size_t> (16, 2 * link.m_inFlight.size ()));
+          for (std::size_t i = 0; i < link.m_inFlightSize; ++i)
+            {
+              ring[i] = std::move (link.m_inFlight[(link.m_inFlightHead + i) % link.m_inFlight.size ()]);
+            }
+          link.m_inFlight.swap (ring);
+          link.m_inFlightHead = 0;
+        }
+      InFlight &tail = link.m_inFlight[(link.m_inFlightHead + link.m_inFlightSize) % link.m_inFlight.size ()];
+      tail.m_arrival = Simulator::Now () + txTime + m_delay;
+      tail.m_packet = p->Copy ();
+      if (link.m_inFlightSize++ == 0)
+        {
+          Simulator::ScheduleWithContext (link.m_dstNodeId, txTime + m_delay,
+                                          &PointToPointChannel::ReceiveInFlight,
+                                          Ptr<PointToPointChannel> (this), wire);
+        }
+    }
+  else
+    {
+      Simulator::ScheduleWithContext (m_link[wire].m_dstNodeId,
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      m_link[wire].m_dst, p->Copy ());
+    }
 
   // Call the tx anim callback on the net device
-  m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+  if (!m_txrxPointToPoint.IsEmpty ())
+    {
+      m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+    }
   return true;
 }
 
+void
+PointToPointChannel::ReceiveInFlight (uint32_t wire)
+{
+  NS_LOG_FUNCTION (this << wire);
+
+  Link &link = m_link[wire];
+  if (link.m_inFlightSize == 0)
+    {
+      // The channel was disposed of
+      return;
+    }
+  Ptr<Packet> p = std::move (link.m_inFlight[link.m_inFlightHead].m_packet);
+  link.m_inFlightHead = (link.m_inFlightHead + 1) % link.m_inFlight.size ();
+  link.m_inFlightSize--;
+
+  // Schedule the next arrival before the receiving side schedules anything,
+  // as close as possible to the order of the events of one per packet
+  if (link.m_inFlightSize > 0)
+    {
+      Time next = link.m_inFlight[link.m_inFlightHead].m_arrival;
+      Simulator::Schedule (next - Simulator::Now (),
+                           &PointToPointChannel::ReceiveInFlight, Ptr<PointToPointChannel> (this), wire);
+    }
+  link.m_dst->Receive (std::move (p));
+}
+
+bool
+PointToPointChannel::OvertakesInFlight (uint32_t wire, Time arrival) const
+{
+  // Only when the Delay was lowered with packets still in flight
+  const Link &link = m_link[wire];
+  return link.m_inFlightSize > 0
+         && arrival < link.m_inFlight[(link.m_inFlightHead + link.m_inFlightSize - 1) % link.m_inFlight.size ()].m_arrival;
+}
+
 std::size_t
 PointToPointChannel::GetNDevices (void) const
 {
@@ -134,6 +261,12 @@ PointToPointChannel::GetDelay (void) const
   return m_delay;
 }
 
+Time
+PointToPointChannel::GetTransmitSlack (void) const
+{
+  return m_crossPartition ? Time (0) : m_delay;
+}
+
 Ptr<PointToPointNetDevice>
 PointToPointChannel::GetSource (uint32_t i) const
 {
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_CHANNEL_H
 
 #include <list>
+#include <vector>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
@@ -44,6 +45,13 @@ class Packet;
  * [0] wire to transmit on.  The second device gets the [1] wire.  There is a
  * state (IDLE, TRANSMITTING) associated with each wire.
  *
+ * By default, each packet in flight on a wire is a Receive event of the
+ * simulator.  With the InFlightQueue attribute set, the packets in flight
+ * on each wire are kept in a FIFO queue with their arrival times instead,
+ * and only the next arrival on each wire is a pending event.  A packet
+ * which would arrive before the last one in the queue, after the Delay was
+ * lowered, is scheduled on its own.
+ *
  * \see Attach
  * \see TransmitStart
  */
@@ -100,7 +108,24 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \brief Get how late a packet may be handed to the channel
+   *
+   * A device may call TransmitStart after the transmission of a packet
+   * started, with a negative transmit time if the transmission is already
+   * complete, as long as the packet arrives at the peer no earlier than
+   * this long after the call.  This is the delay of the channel, unless the
+   * peer is run by another simulation thread or process, which must learn
+   * about a packet at least the channel delay before it arrives.
+   *
+   * \returns the time by which TransmitStart may follow the end of the
+   * transmission of a packet
+   */
+  virtual Time GetTransmitSlack (void) const;
+
 protected:
+  virtual void DoDispose (void);
+
   /**
    * \brief Get the delay associated with this channel
    * \returns Time delay
@@ -151,6 +176,23 @@ private:
 
   Time          m_delay;    //!< Propagation delay
   std::size_t        m_nDevices; //!< Devices of this channel
+  bool          m_crossPartition; //!< Are the devices run by different simulation threads
+  bool          m_inFlightQueue; //!< Are the packets in flight kept in a queue per wire
+
+  /**
+   * \brief Hand the packet at the head of the in-flight queue of a wire to
+   * its destination, and schedule the next arrival on the wire
+   * \param wire the wire
+   */
+  void ReceiveInFlight (uint32_t wire);
+
+  /**
+   * \brief Whether a packet would arrive before the last one in flight on a wire
+   * \param wire the wire
+   * \param arrival the arrival time of the packet
+   * \return true if the packet cannot be appended to the in-flight queue
+   */
+  bool OvertakesInFlight (uint32_t wire, Time arrival) const;
 
   /**
    * The trace source for the packet transmission animation events that the 
@@ -185,6 +227,15 @@ private:
     PROPAGATING
   };
 
+  /**
+   * \brief Packet in flight on a wire
+   */
+  struct InFlight
+  {
+    Time        m_arrival; //!< Arrival time at the destination
+    Ptr<Packet> m_packet;  //!< The packet
+  };
+
   /**
    * \brief Wire model for the PointToPointChannel
    */
@@ -194,11 +245,16 @@ public:
     /** \brief Create the link, it will be in INITIALIZING state
      *
      */
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstNodeId (0xffffffff),
+             m_inFlightHead (0), m_inFlightSize (0) {}
 
     WireState                  m_state; //!< State of the link
     Ptr<PointToPointNetDevice> m_src;   //!< First NetDevice
     Ptr<PointToPointNetDevice> m_dst;   //!< Second NetDevice
+    uint32_t                   m_dstNodeId; //!< Node id of the second NetDevice, once known
+    std::vector<InFlight>      m_inFlight;  //!< Ring of the packets in flight, in order of arrival
+    std::size_t                m_inFlightHead; //!< Index of the next arrival in m_inFlight
+    std::size_t                m_inFlightSize; //!< Number of packets in flight, the arrival of the first one is scheduled
   };
 
   Link    m_link[N_DEVICES]; //!< Link model
@@ -24,7 +24,10 @@
 #include "ns3/error-model.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/queue-limits.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -67,6 +70,17 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("TxTrain",
+                   "If true, the packets transmitted back to back are handed to "
+                   "the channel in trains, with one event per train instead of one "
+                   "per packet.  The packets start, end and arrive at the peer at "
+                   "the same times.  While the PhyTxBegin, PhyTxEnd, Sniffer or "
+                   "PromiscSniffer traces, or the Dequeue trace of the device queue, "
+                   "are connected, the packets are handled one at a time at their "
+                   "exact start times instead.  Set it before the simulation starts.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointNetDevice::m_txTrain),
+                   MakeBooleanChecker ())
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -177,7 +191,8 @@ PointToPointNetDevice::PointToPointNetDevice ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_txTrain (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -215,9 +230,22 @@ PointToPointNetDevice::DoDispose ()
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
   m_queue = 0;
+  m_trainEvent.Cancel ();
+  m_queueInterface = 0;
   NetDevice::DoDispose ();
 }
 
+void
+PointToPointNetDevice::NotifyNewAggregate (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_queueInterface == 0)
+    {
+      m_queueInterface = GetObject<NetDeviceQueueInterface> ();
+    }
+  NetDevice::NotifyNewAggregate ();
+}
+
 void
 PointToPointNetDevice::SetDataRate (DataRate bps)
 {
@@ -251,8 +279,15 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
   Time txCompleteTime = txTime + m_tInterframeGap;
 
-  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.As (Time::S));
-  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+  if (m_txTrain)
+    {
+      m_txEnd = Simulator::Now () + txCompleteTime;
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.As (Time::S));
+      Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+    }
 
   bool result = m_channel->TransmitStart (p, this, txTime);
   if (result == false)
@@ -293,7 +328,116 @@ PointToPointNetDevice::TransmitComplete (void)
   //
   m_snifferTrace (p);
   m_promiscSnifferTrace (p);
-  TransmitStart (p);
+  TransmitStart (std::move (p));
+}
+
+void
+PointToPointNetDevice::UpdateTrain (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time now = Simulator::Now ();
+  while (m_txMachineState == BUSY && m_txEnd <= now)
+    {
+      m_phyTxEndTrace (m_currentPkt);
+      m_currentPkt = 0;
+
+      Ptr<Packet> p = m_queue->Dequeue ();
+      if (p == 0)
+        {
+          NS_LOG_LOGIC ("No pending packets in device queue after tx complete");
+          m_txMachineState = READY;
+          return;
+        }
+
+      //
+      // The packet started when the previous one was complete, possibly in
+      // the past.  Tell the channel when it ends, counted from now.
+      //
+      m_snifferTrace (p);
+      m_promiscSnifferTrace (p);
+      m_currentPkt = p;
+      m_phyTxBeginTrace (m_currentPkt);
+
+      Time start = m_txEnd;
+      Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+      m_txEnd = start + txTime + m_tInterframeGap;
+      NS_LOG_LOGIC ("Packet " << p->GetUid () << " started at " << start.As (Time::S));
+
+      if (m_channel->TransmitStart (p, this, start + txTime - now) == false)
+        {
+          m_phyTxDropTrace (p);
+        }
+    }
+}
+
+bool
+PointToPointNetDevice::IsUpperLayerWaiting (void) const
+{
+  if (m_queueInterface == 0)
+    {
+      return false;
+    }
+  Ptr<NetDeviceQueue> txq = m_queueInterface->GetTxQueue (0);
+  return txq->IsStopped () || txq->GetQueueLimits () != 0;
+}
+
+bool
+PointToPointNetDevice::IsTxTraced (void) const
+{
+  return !m_phyTxBeginTrace.IsEmpty () || !m_phyTxEndTrace.IsEmpty ()
+         || !m_snifferTrace.IsEmpty () || !m_promiscSnifferTrace.IsEmpty ()
+         || m_queue->IsDequeueTraced ();
+}
+
+void
+PointToPointNetDevice::ScheduleTrain (bool waiting)
+{
+  NS_LOG_FUNCTION (this << waiting);
+
+  if (m_txMachineState == READY || m_queue->IsEmpty ())
+    {
+      // The next Send completes the current transmission, if any
+      m_trainEvent.Cancel ();
+      return;
+    }
+
+  //
+  // The next queued packet starts at m_txEnd.  If the upper layers wait for
+  // room in the device queue, or with byte queue limits, it must leave the
+  // queue at that time, and so it must if its transmission is traced.
+  // Otherwise it may be handed to the channel as late as the channel allows,
+  // together with the packets which follow it.
+  //
+  Time next = m_txEnd;
+  if (!waiting && !IsUpperLayerWaiting () && !IsTxTraced ())
+    {
+      next += m_bps.CalculateBytesTxTime (m_queue->Peek ()->GetSize ()) + m_channel->GetTransmitSlack ();
+    }
+
+  // An earlier event does no harm, it only takes a shorter train
+  if (!m_trainEvent.IsExpired () && m_trainEvent.GetTs () <= static_cast<uint64_t> (next.GetTimeStep ()))
+    {
+      return;
+    }
+  m_trainEvent.Cancel ();
+  NS_LOG_LOGIC ("Schedule the next train at " << next.As (Time::S));
+  m_trainEvent = Simulator::Schedule (next - Simulator::Now (), &PointToPointNetDevice::TransmitTrain, this);
+}
+
+void
+PointToPointNetDevice::TransmitTrain (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  //
+  // If the upper layers wait for room in the device queue, the packet which
+  // leaves it wakes them, and they will most likely fill it again: keep
+  // taking the packets one at a time rather than rescheduling each time.
+  //
+  bool waiting = IsUpperLayerWaiting ();
+  UpdateTrain ();
+  ScheduleTrain (waiting);
 }
 
 bool
@@ -374,7 +518,7 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
         }
 
       m_macRxTrace (originalPacket);
-      m_rxCallback (this, packet, protocol, GetRemote ());
+      m_rxCallback (this, std::move (packet), protocol, GetRemote ());
     }
 }
 
@@ -513,6 +657,15 @@ PointToPointNetDevice::Send (
   NS_LOG_LOGIC ("p=" << packet << ", dest=" << &dest);
   NS_LOG_LOGIC ("UID is " << packet->GetUid ());
 
+  //
+  // In train mode, complete the transmissions which ended by now first, so
+  // that the transmitter state and the device queue are up to date.
+  //
+  if (m_txTrain)
+    {
+      UpdateTrain ();
+    }
+
   //
   // If IsLinkUp() is false it means there is no channel to send any packet 
   // over so we just hit the drop trace on the packet and return an error.
@@ -544,9 +697,17 @@ PointToPointNetDevice::Send (
           packet = m_queue->Dequeue ();
           m_snifferTrace (packet);
           m_promiscSnifferTrace (packet);
-          bool ret = TransmitStart (packet);
+          bool ret = TransmitStart (std::move (packet));
+          if (m_txTrain)
+            {
+              ScheduleTrain (false);
+            }
           return ret;
         }
+      if (m_txTrain)
+        {
+          ScheduleTrain (false);
+        }
       return true;
     }
 
@@ -27,6 +27,7 @@
 #include "ns3/packet.h"
 #include "ns3/traced-callback.h"
 #include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "ns3/data-rate.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
@@ -36,6 +37,7 @@ namespace ns3 {
 template <typename Item> class Queue;
 class PointToPointChannel;
 class ErrorModel;
+class NetDeviceQueueInterface;
 
 /**
  * \defgroup point-to-point Point-To-Point Network Device
@@ -224,6 +226,12 @@ private:
    */
   virtual void DoDispose (void);
 
+  /**
+   * \brief Keep the NetDeviceQueueInterface aggregated to the device, which
+   * tells whether the transmit queue is stopped
+   */
+  virtual void NotifyNewAggregate (void);
+
 private:
 
   /**
@@ -275,6 +283,48 @@ private:
    */
   void TransmitComplete (void);
 
+  /**
+   * Bring the transmitter up to date in train mode.
+   *
+   * In train mode no event is scheduled at the end of each transmission.
+   * This method completes the transmissions which ended by now and hands
+   * to the channel the queued packets whose transmission started by now,
+   * each with its exact start time.
+   */
+  void UpdateTrain (void);
+
+  /**
+   * Schedule the next event of the train mode, if any.
+   *
+   * The event is at the start of the next queued packet when the upper
+   * layers wait for room in the device queue.  Otherwise it is as late as
+   * the channel allows (see PointToPointChannel::GetTransmitSlack), and it
+   * takes the whole train sent meanwhile.
+   *
+   * \param waiting true if the upper layers were waiting for room in the
+   * device queue when the last packet left it
+   */
+  void ScheduleTrain (bool waiting);
+
+  /**
+   * \returns true if the upper layers wait for room in the device queue,
+   * or if the device queue uses byte queue limits, in which cases the
+   * packets must leave the device queue at their exact start times
+   */
+  bool IsUpperLayerWaiting (void) const;
+
+  /**
+   * \returns true if a sink is connected to a trace source which fires when
+   * a packet leaves the device queue, starts or ends, in which case the
+   * packets must be handled at their exact start times
+   */
+  bool IsTxTraced (void) const;
+
+  /**
+   * Handle the event scheduled by ScheduleTrain.
+   */
+  void TransmitTrain (void);
+
   /**
    * \brief Make the link up and running
    *
@@ -457,6 +507,11 @@ private:
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
 
+  bool m_txTrain;           //!< True if the packets transmitted back to back are handed to the channel in trains
+  Time m_txEnd;             //!< End of the transmission of m_currentPkt, including the interframe gap (train mode)
+  EventId m_trainEvent;     //!< Next event of the train mode
+  Ptr<NetDeviceQueueInterface> m_queueInterface; //!< NetDeviceQueueInterface aggregated to this device
+
   /**
    * \brief PPP to Ethernet protocol number mapping
    * \param protocol A PPP protocol number
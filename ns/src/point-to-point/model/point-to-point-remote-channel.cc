@@ -73,4 +73,10 @@ PointToPointRemoteChannel::TransmitStart (
   return true;
 }
 
+Time
+PointToPointRemoteChannel::GetTransmitSlack (void) const
+{
+  return Time (0);
+}
+
 } // namespace ns3
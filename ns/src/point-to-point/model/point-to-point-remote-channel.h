@@ -68,6 +68,17 @@ public:
    */
   virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+  /**
+   * \brief Get how late a packet may be handed to the channel
+   *
+   * The remote peer must learn about a packet at least the channel delay
+   * before it arrives, so a packet may not be handed to this channel after
+   * the end of its transmission.
+   *
+   * \returns zero
+   */
+  virtual Time GetTransmitSlack (void) const;
 };
 
 } // namespace ns3
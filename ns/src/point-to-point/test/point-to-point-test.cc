@@ -24,8 +24,19 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/core-config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/map-scheduler.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/config.h"
+#include "ns3/multithreaded-simulator-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/node-container.h"
+#endif
 
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -130,6 +141,578 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Event scheduler which counts its pending events
+ */
+class PendingCountScheduler : public MapScheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  virtual void Insert (const Scheduler::Event &ev)
+  {
+    MapScheduler::Insert (ev);
+    s_pending++;
+  }
+  virtual Scheduler::Event RemoveNext (void)
+  {
+    s_pending--;
+    return MapScheduler::RemoveNext ();
+  }
+  virtual void Remove (const Scheduler::Event &ev)
+  {
+    s_pending--;
+    MapScheduler::Remove (ev);
+  }
+
+  static uint32_t s_pending; //!< Number of pending events
+};
+
+uint32_t PendingCountScheduler::s_pending = 0;
+
+TypeId
+PendingCountScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PendingCountScheduler")
+    .SetParent<MapScheduler> ()
+    .SetGroupName ("PointToPoint")
+    .AddConstructor<PendingCountScheduler> ()
+  ;
+  return tid;
+}
+
+/**
+ * \brief Test class for the train mode of the PointToPoint model
+ *
+ * It sends bursts of packets of various sizes, through a device queue
+ * which stops the upper layer when it is full, with and without trains,
+ * and checks that the packets arrive at the same times, with fewer
+ * events in train mode, and that a sniffer sees them at the same times.
+ * With the in-flight queue of the channel, it also checks that the wire
+ * holds a single pending event, and that lowering the Delay while
+ * packets are in flight keeps the packet timing.
+ */
+class PointToPointTrainTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointTrainTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Run one simulation
+   *
+   * \param train Whether the sending device uses trains.
+   * \param inFlightQueue Whether the channel keeps the packets in flight in a queue.
+   * \param rx Filled with the size and the reception time of the packets.
+   * \param sniffed If not null, filled with the size and the time the
+   * sending device sniffs the packets.
+   * \param lowerDelay Whether to lower the Delay of the channel during the
+   * first burst.
+   * \returns The number of events executed.
+   */
+  uint64_t RunOnce (bool train, bool inFlightQueue, std::vector<std::pair<uint32_t, Time> > &rx,
+                    std::vector<std::pair<uint32_t, Time> > *sniffed = 0, bool lowerDelay = false);
+  /**
+   * \brief Add packets to the backlog of the upper layer and send them
+   *
+   * \param n The number of packets.
+   */
+  void SendBurst (uint32_t n);
+  /**
+   * \brief Send packets of the backlog until the device queue is stopped
+   */
+  void Drain (void);
+  /**
+   * \brief Callback function which records the received packet
+   *
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol mode used.
+   * \param sender The sender address.
+   *
+   * \return A boolean indicating packet handled properly.
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+  /**
+   * \brief Trace sink which records the packet sniffed by the sending device
+   *
+   * \param pkt The sniffed packet.
+   */
+  void Sniff (Ptr<const Packet> pkt);
+  /**
+   * \brief Record the pending events and the packets in flight
+   */
+  void Probe (void);
+  /**
+   * \brief Lower the Delay of a channel
+   *
+   * \param channel The channel.
+   */
+  void LowerDelay (Ptr<PointToPointChannel> channel);
+
+  Ptr<PointToPointNetDevice> m_sender;             //!< sending device
+  Ptr<NetDeviceQueue> m_txq;                       //!< transmission queue of the sending device
+  uint32_t m_backlog;                              //!< packets waiting in the upper layer
+  uint32_t m_sent;                                 //!< packets sent so far
+  std::vector<std::pair<uint32_t, Time> > *m_rx;   //!< received packets
+  std::vector<std::pair<uint32_t, Time> > *m_sniffed; //!< sniffed packets
+  uint32_t m_probePending;                         //!< pending events at the probe
+  uint32_t m_probeInFlight;                        //!< packets in flight at the probe
+};
+
+PointToPointTrainTest::PointToPointTrainTest ()
+  : TestCase ("PointToPoint trains keep the packet timing"),
+    m_backlog (0),
+    m_sent (0),
+    m_rx (0),
+    m_sniffed (0),
+    m_probePending (0),
+    m_probeInFlight (0)
+{
+}
+
+void
+PointToPointTrainTest::SendBurst (uint32_t n)
+{
+  m_backlog += n;
+  Drain ();
+}
+
+void
+PointToPointTrainTest::Drain (void)
+{
+  while (m_backlog > 0 && !m_txq->IsStopped ())
+    {
+      Ptr<Packet> p = Create<Packet> (100 + 150 * (m_sent++ % 7));
+      m_sender->Send (p, m_sender->GetBroadcast (), 0x800);
+      m_backlog--;
+    }
+}
+
+bool
+PointToPointTrainTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_rx->push_back (std::make_pair (pkt->GetSize (), Simulator::Now ()));
+  return true;
+}
+
+void
+PointToPointTrainTest::Sniff (Ptr<const Packet> pkt)
+{
+  m_sniffed->push_back (std::make_pair (pkt->GetSize (), Simulator::Now ()));
+}
+
+void
+PointToPointTrainTest::Probe (void)
+{
+  // The device queue is empty by now: the packets not received are on the wire
+  m_probePending = PendingCountScheduler::s_pending;
+  m_probeInFlight = m_sent - m_rx->size ();
+}
+
+void
+PointToPointTrainTest::LowerDelay (Ptr<PointToPointChannel> channel)
+{
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+}
+
+uint64_t
+PointToPointTrainTest::RunOnce (bool train, bool inFlightQueue, std::vector<std::pair<uint32_t, Time> > &rx,
+                                std::vector<std::pair<uint32_t, Time> > *sniffed, bool lowerDelay)
+{
+  ObjectFactory scheduler;
+  scheduler.SetTypeId (PendingCountScheduler::GetTypeId ());
+  Simulator::SetScheduler (scheduler);
+  PendingCountScheduler::s_pending = 0;
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (50)));
+  channel->SetAttribute ("InFlightQueue", BooleanValue (inFlightQueue));
+  devA->SetAttribute ("DataRate", StringValue ("8Mbps"));
+  devA->SetAttribute ("InterframeGap", TimeValue (MicroSeconds (10)));
+  devA->SetAttribute ("TxTrain", BooleanValue (train));
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  Ptr<Queue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  queue->SetAttribute ("MaxSize", StringValue ("5p"));
+  devA->SetQueue (queue);
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  ndqi->GetTxQueue (0)->ConnectQueueTraces (queue);
+  devA->AggregateObject (ndqi);
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devB->SetReceiveCallback (MakeCallback (&PointToPointTrainTest::RxPacket, this));
+
+  m_sender = devA;
+  m_txq = ndqi->GetTxQueue (0);
+  m_txq->SetWakeCallback (MakeCallback (&PointToPointTrainTest::Drain, this));
+  m_backlog = 0;
+  m_sent = 0;
+  m_rx = &rx;
+  m_sniffed = sniffed;
+  if (sniffed != 0)
+    {
+      // As PointToPointHelper::EnablePcap does
+      devA->TraceConnectWithoutContext ("PromiscSniffer", MakeCallback (&PointToPointTrainTest::Sniff, this));
+    }
+
+  // A long burst which fills the device queue, a short one while it is
+  // being sent, isolated packets, then back to back packets again
+  Simulator::Schedule (Seconds (1.0), &PointToPointTrainTest::SendBurst, this, 20);
+  Simulator::Schedule (Seconds (1.0005), &PointToPointTrainTest::SendBurst, this, 3);
+  Simulator::Schedule (Seconds (1.1), &PointToPointTrainTest::SendBurst, this, 1);
+  Simulator::Schedule (Seconds (1.2), &PointToPointTrainTest::SendBurst, this, 1);
+  Simulator::Schedule (Seconds (1.3), &PointToPointTrainTest::SendBurst, this, 4);
+  Simulator::Schedule (Seconds (1.3001), &PointToPointTrainTest::SendBurst, this, 2);
+  // The first two bursts are on the wire, and none of them has arrived
+  Simulator::Schedule (Seconds (1.03), &PointToPointTrainTest::Probe, this);
+  if (lowerDelay)
+    {
+      Simulator::Schedule (Seconds (1.005), &PointToPointTrainTest::LowerDelay, this, channel);
+    }
+  Simulator::Run ();
+  uint64_t events = Simulator::GetEventCount ();
+
+  m_sender = 0;
+  m_txq = 0;
+  Simulator::Destroy ();
+  return events;
+}
+
+void
+PointToPointTrainTest::DoRun (void)
+{
+  std::vector<std::pair<uint32_t, Time> > packets;
+  uint64_t packetEvents = RunOnce (false, false, packets);
+  NS_TEST_ASSERT_MSG_EQ (packets.size (), 31, "Wrong number of packets received");
+  NS_TEST_ASSERT_MSG_EQ (m_probeInFlight, 23, "Wrong number of packets in flight");
+  uint32_t packetPending = m_probePending;
+
+  // Trains, and packets in flight kept in a queue by the channel, alone
+  // and together
+  for (uint32_t mode = 1; mode < 4; ++mode)
+    {
+      bool train = (mode & 1) != 0;
+      bool inFlightQueue = (mode & 2) != 0;
+      std::vector<std::pair<uint32_t, Time> > rx;
+      uint64_t events = RunOnce (train, inFlightQueue, rx);
+
+      NS_TEST_ASSERT_MSG_EQ (rx.size (), packets.size (), "Wrong number of packets received in mode " << mode);
+      for (uint32_t i = 0; i < packets.size (); ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (rx[i].first, packets[i].first, "Wrong size of packet " << i << " in mode " << mode);
+          NS_TEST_EXPECT_MSG_EQ (rx[i].second, packets[i].second, "Wrong reception time of packet " << i << " in mode " << mode);
+        }
+      if (train)
+        {
+          NS_TEST_EXPECT_MSG_LT (events, packetEvents, "Trains do not save events");
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ (events, packetEvents, "The in-flight queue changes the events");
+          // One Receive event per packet on the wire, or a single one for them all
+          NS_TEST_EXPECT_MSG_EQ (m_probeInFlight, 23, "Wrong number of packets in flight");
+          NS_TEST_EXPECT_MSG_EQ (m_probePending, packetPending - m_probeInFlight + 1,
+                                 "The in-flight queue does not keep one pending event per wire");
+        }
+    }
+
+  // Packets sent after the Delay is lowered overtake those on the wire
+  std::vector<std::pair<uint32_t, Time> > lowered;
+  RunOnce (false, false, lowered, 0, true);
+  for (uint32_t mode = 1; mode < 4; ++mode)
+    {
+      bool train = (mode & 1) != 0;
+      bool inFlightQueue = (mode & 2) != 0;
+      std::vector<std::pair<uint32_t, Time> > rx;
+      RunOnce (train, inFlightQueue, rx, 0, true);
+
+      NS_TEST_ASSERT_MSG_EQ (rx.size (), lowered.size (), "Wrong number of packets received in mode " << mode);
+      for (uint32_t i = 0; i < lowered.size (); ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (rx[i].first, lowered[i].first, "Wrong size of packet " << i << " in mode " << mode);
+          NS_TEST_EXPECT_MSG_EQ (rx[i].second, lowered[i].second, "Wrong reception time of packet " << i << " in mode " << mode);
+        }
+    }
+
+  // With a sniffer, as with pcap tracing, the packets are sniffed at their
+  // exact start times in train mode too
+  std::vector<std::pair<uint32_t, Time> > rx;
+  std::vector<std::pair<uint32_t, Time> > sniffed;
+  std::vector<std::pair<uint32_t, Time> > trainSniffed;
+  RunOnce (false, false, rx, &sniffed);
+  rx.clear ();
+  RunOnce (true, false, rx, &trainSniffed);
+  NS_TEST_ASSERT_MSG_EQ (sniffed.size (), packets.size (), "Wrong number of packets sniffed");
+  NS_TEST_ASSERT_MSG_EQ (trainSniffed.size (), sniffed.size (), "Wrong number of packets sniffed with trains");
+  for (uint32_t i = 0; i < sniffed.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (trainSniffed[i].first, sniffed[i].first, "Wrong size of sniffed packet " << i);
+      NS_TEST_EXPECT_MSG_EQ (trainSniffed[i].second, sniffed[i].second, "Wrong sniffing time of packet " << i);
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \brief Test class for PointToPoint model with a MultithreadedSimulatorImpl
+ *
+ * It sends one packet between two nodes run by different partitions, and
+ * checks that the packet arrives intact, in the receiving partition, one
+ * transmission time plus the channel delay later.
+ */
+class PointToPointCrossPartitionTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointCrossPartitionTest ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Send one packet to the device specified
+   *
+   * \param device NetDevice to send to.
+   * \param size Size of the payload.
+   */
+  void SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size);
+  /**
+   * \brief Callback function which records the received packet
+   *
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol mode used.
+   * \param sender The sender address.
+   *
+   * \return A boolean indicating packet handled properly.
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+
+  Ptr<const Packet> m_recvdPacket; //!< received packet
+  Time m_recvdTime;                //!< reception time
+  uint32_t m_recvdSystemId;        //!< partition of the reception
+};
+
+PointToPointCrossPartitionTest::PointToPointCrossPartitionTest ()
+  : TestCase ("PointToPoint between two partitions of a multithreaded simulation"),
+    m_recvdSystemId (0)
+{
+}
+
+void
+PointToPointCrossPartitionTest::SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size)
+{
+  std::vector<uint8_t> payload (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      payload[i] = static_cast<uint8_t> (i);
+    }
+  Ptr<Packet> p = Create<Packet> (&payload[0], size);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointCrossPartitionTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_recvdPacket = pkt;
+  m_recvdTime = Simulator::Now ();
+  m_recvdSystemId = Simulator::GetSystemId ();
+  return true;
+}
+
+void
+PointToPointCrossPartitionTest::DoRun (void)
+{
+  MultithreadedSimulatorHelper::Enable ();
+
+  Ptr<Node> a = CreateObject<Node> (0);
+  Ptr<Node> b = CreateObject<Node> (1);
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+  devA->SetAttribute ("DataRate", StringValue ("8Mbps"));
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devB->SetReceiveCallback (MakeCallback (&PointToPointCrossPartitionTest::RxPacket, this));
+
+  Time lookahead = MultithreadedSimulatorHelper::Partition ();
+  NS_TEST_ASSERT_MSG_EQ (MultithreadedSimulatorHelper::IsEnabled (), true, "Not a multithreaded simulation");
+  NS_TEST_EXPECT_MSG_EQ (lookahead, MilliSeconds (2), "The lookahead is not the channel delay");
+  BooleanValue cross;
+  channel->GetAttribute ("CrossPartition", cross);
+  NS_TEST_EXPECT_MSG_EQ (cross.Get (), true, "The channel is not marked as joining two partitions");
+
+  // 998 bytes + 2 bytes of PPP header take 1ms at 8Mbps
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (1.0),
+                                  &PointToPointCrossPartitionTest::SendOnePacket, this, devA, 998);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_NE (m_recvdPacket, 0, "No packet received");
+  NS_TEST_EXPECT_MSG_EQ (m_recvdPacket->GetSize (), 998, "Wrong packet size");
+  std::vector<uint8_t> rxBuffer (998);
+  m_recvdPacket->CopyData (&rxBuffer[0], rxBuffer.size ());
+  for (uint32_t i = 0; i < rxBuffer.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (rxBuffer[i], static_cast<uint8_t> (i), "Corrupted payload at byte " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_recvdTime, Seconds (1.0) + MilliSeconds (3), "Wrong reception time");
+  NS_TEST_EXPECT_MSG_EQ (m_recvdSystemId, 1, "Received by the wrong partition");
+
+  m_recvdPacket = 0;
+  Simulator::Destroy ();
+}
+
+void
+PointToPointCrossPartitionTest::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \brief Test class for the automatic partitioning of point-to-point topologies
+ *
+ * It checks that a dumbbell is cut at its bottleneck, also when the
+ * bottleneck is the longest link rather than the slowest one, and that
+ * a chain of routers is cut into runs of consecutive routers.
+ */
+class PointToPointAutoPartitionTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointAutoPartitionTest ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Check the partitions of a dumbbell with 3 hosts per side
+   *
+   * \param hostDelay Delay of the host links.
+   * \param bottleneckDelay Delay of the link between the routers.
+   */
+  void CheckDumbbell (Time hostDelay, Time bottleneckDelay);
+  /**
+   * \brief Check the partitions of a chain of 8 routers with a host each
+   */
+  void CheckChain (void);
+};
+
+PointToPointAutoPartitionTest::PointToPointAutoPartitionTest ()
+  : TestCase ("PointToPoint topologies split automatically into partitions")
+{
+}
+
+void
+PointToPointAutoPartitionTest::CheckDumbbell (Time hostDelay, Time bottleneckDelay)
+{
+  MultithreadedSimulatorHelper::Enable ();
+  NodeContainer routers;
+  routers.Create (2);
+  NodeContainer hosts;
+  hosts.Create (6);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", TimeValue (bottleneckDelay));
+  NetDeviceContainer bottleneck = p2p.Install (routers);
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", TimeValue (hostDelay));
+  for (uint32_t i = 0; i < hosts.GetN (); ++i)
+    {
+      p2p.Install (routers.Get (i / 3), hosts.Get (i));
+    }
+
+  std::vector<uint32_t> partitions = MultithreadedSimulatorHelper::ComputePartitions (2);
+  NS_TEST_ASSERT_MSG_EQ (partitions.size (), 8, "Wrong number of nodes");
+  NS_TEST_EXPECT_MSG_EQ (partitions[routers.Get (0)->GetId ()], 0, "Left router in the wrong partition");
+  NS_TEST_EXPECT_MSG_EQ (partitions[routers.Get (1)->GetId ()], 1, "Right router in the wrong partition");
+  for (uint32_t i = 0; i < hosts.GetN (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (partitions[hosts.Get (i)->GetId ()], i / 3, "Host " << i << " in the wrong partition");
+    }
+
+  Time lookahead = MultithreadedSimulatorHelper::AutoPartition (2);
+  NS_TEST_EXPECT_MSG_EQ (lookahead, bottleneckDelay, "The lookahead is not the bottleneck delay");
+  BooleanValue cross;
+  bottleneck.Get (0)->GetChannel ()->GetAttribute ("CrossPartition", cross);
+  NS_TEST_EXPECT_MSG_EQ (cross.Get (), true, "The bottleneck is not marked as joining two partitions");
+  Simulator::Destroy ();
+}
+
+void
+PointToPointAutoPartitionTest::CheckChain (void)
+{
+  NodeContainer routers;
+  routers.Create (8);
+  NodeContainer hosts;
+  hosts.Create (8);
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  for (uint32_t i = 0; i + 1 < routers.GetN (); ++i)
+    {
+      p2p.Install (routers.Get (i), routers.Get (i + 1));
+    }
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  for (uint32_t i = 0; i < hosts.GetN (); ++i)
+    {
+      p2p.Install (routers.Get (i), hosts.Get (i));
+    }
+
+  std::vector<uint32_t> partitions = MultithreadedSimulatorHelper::ComputePartitions (4);
+  for (uint32_t i = 0; i < routers.GetN (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (partitions[routers.Get (i)->GetId ()], i / 2, "Router " << i << " in the wrong partition");
+      NS_TEST_EXPECT_MSG_EQ (partitions[hosts.Get (i)->GetId ()], i / 2, "Host " << i << " in the wrong partition");
+    }
+  Simulator::Destroy ();
+}
+
+void
+PointToPointAutoPartitionTest::DoRun (void)
+{
+  CheckDumbbell (MilliSeconds (1), MilliSeconds (1));
+  CheckDumbbell (MicroSeconds (10), MilliSeconds (2));
+  CheckChain ();
+}
+
+void
+PointToPointAutoPartitionTest::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+#endif /* HAVE_PTHREAD_H */
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -146,6 +729,11 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointTrainTest, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new PointToPointCrossPartitionTest, TestCase::QUICK);
+  AddTestCase (new PointToPointAutoPartitionTest, TestCase::QUICK);
+#endif
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -951,6 +951,95 @@ FqCoDelQueueDiscSetLinearProbing::DoRun (void)
 }
 
 
+/**
+ * This class tests the lookup of the flow queues when there are many of
+ * them, with flow hashes spread over the whole 32 bit range as when the
+ * number of flow queues is the maximum value.
+ */
+class FqCoDelQueueDiscManyFlows : public TestCase
+{
+public:
+  FqCoDelQueueDiscManyFlows ();
+  virtual ~FqCoDelQueueDiscManyFlows ();
+private:
+  virtual void DoRun (void);
+  void AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr);
+};
+
+FqCoDelQueueDiscManyFlows::FqCoDelQueueDiscManyFlows ()
+  : TestCase ("Test many flow queues")
+{
+}
+
+FqCoDelQueueDiscManyFlows::~FqCoDelQueueDiscManyFlows ()
+{
+}
+
+void
+FqCoDelQueueDiscManyFlows::AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header hdr)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  Address dest;
+  Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, hdr);
+  queue->Enqueue (item);
+}
+
+void
+FqCoDelQueueDiscManyFlows::DoRun (void)
+{
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("Flows", UintegerValue (4294967295),
+                                                                                   "MaxSize", StringValue ("4000p"));
+  queueDisc->SetQuantum (90);
+  queueDisc->Initialize ();
+
+  Ptr<Ipv4TestPacketFilter> filter = CreateObject<Ipv4TestPacketFilter> ();
+  queueDisc->AddPacketFilter (filter);
+
+  Ipv4Header hdr;
+  hdr.SetPayloadSize (100);
+  hdr.SetSource (Ipv4Address ("10.10.1.1"));
+  hdr.SetDestination (Ipv4Address ("10.10.1.2"));
+  hdr.SetProtocol (7);
+
+  uint32_t nFlows = 1000;
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      for (uint32_t i = 0; i < nFlows; i++)
+        {
+          hash = i * 2147483;
+          AddPacket (queueDisc, hdr);
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNQueueDiscClasses (), nFlows,
+                         "unexpected number of flow queues");
+  for (uint32_t i = 0; i < nFlows; i++)
+    {
+      Ptr<FqCoDelFlow> flow = StaticCast<FqCoDelFlow> (queueDisc->GetQueueDiscClass (i));
+      NS_TEST_ASSERT_MSG_EQ (flow->GetIndex (), i * 2147483,
+                             "unexpected index of the flow queue");
+      NS_TEST_ASSERT_MSG_EQ (flow->GetQueueDisc ()->GetNPackets (), 2,
+                             "unexpected number of packets in the flow queue");
+    }
+
+  // The quantum is smaller than a packet, so the packets are dequeued in
+  // two rounds over the flows: first as new flows, then as old flows
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      for (uint32_t i = 0; i < nFlows; i++)
+        {
+          queueDisc->Dequeue ();
+          NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (i)->GetQueueDisc ()->GetNPackets (), 1 - round,
+                                 "unexpected number of packets in the flow queue");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNPackets (), 0, "the queue disc should be empty");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->Dequeue (), 0, "the queue disc should be empty");
+
+  Simulator::Destroy ();
+}
+
+
 /**
  * This class tests L4S mode
  * Any future classifier options (e.g. SetAssociativeHash) should be disabled to prevent a hash collision on this test case.
@@ -1122,6 +1211,7 @@ FqCoDelQueueDiscTestSuite::FqCoDelQueueDiscTestSuite ()
   AddTestCase (new FqCoDelQueueDiscUDPFlowsSeparation, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscECNMarking, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscSetLinearProbing, TestCase::QUICK);
+  AddTestCase (new FqCoDelQueueDiscManyFlows, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscL4sMode, TestCase::QUICK);
 }
 
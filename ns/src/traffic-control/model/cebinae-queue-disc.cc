@@ -160,7 +160,8 @@ void CebinaeQueueDisc::ReactionFSM() {
     NS_ASSERT (m_vb == (m_dt.GetNanoSeconds()/m_vdt.GetNanoSeconds()));
     NS_ASSERT (GetInternalQueue(0)->GetMaxSize().GetUnit() == GetMaxSize().GetUnit());
     NS_ASSERT (GetInternalQueue(1)->GetMaxSize().GetUnit() == GetMaxSize().GetUnit());    
-    NS_ASSERT ((GetInternalQueue(0)->GetMaxSize().GetValue()+GetInternalQueue(1)->GetMaxSize().GetValue()) == GetMaxSize().GetValue());
+    // With the shared (pooled) buffer, each InternalQueue may take the whole buffer
+    NS_ASSERT (m_pool || (GetInternalQueue(0)->GetMaxSize().GetValue()+GetInternalQueue(1)->GetMaxSize().GetValue()) == GetMaxSize().GetValue());
 
     NS_LOG_DEBUG("Advances to the time point of first ROTATE packet");
     m_state = ROTATE;
@@ -357,28 +358,18 @@ void CebinaeQueueDisc::ReactionFSM() {
 }
 
 bool
-CebinaeQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
-{   
-
-  // Process NORMAL packet; note that the processing of ROTATE is embedded in Reaction FSM
-  // Regardless of whether the port is saturated or not
+CebinaeQueueDisc::IsTopFlow (uint32_t sourceid) const
+{
+  auto got = std::find(m_bottlenecked_flows_set.begin(), m_bottlenecked_flows_set.end(), sourceid);
+  return got != m_bottlenecked_flows_set.end();
+}
 
-  // First check if the packet belongs to top or not
-  bool is_top = false;
-  MySourceIDTag tag;
-  bool has_tag = item->GetPacket()->FindFirstMatchingByteTag(tag);
-  if (has_tag) {
-    auto got = std::find(m_bottlenecked_flows_set.begin(), m_bottlenecked_flows_set.end(), tag.Get());
-    if (got != m_bottlenecked_flows_set.end()) {
-      is_top = true;
-    }
-  } else {
-    // Non-app traffic, considered non-top for simplicity of tracing, worst case false negative which is ok
-  }
-  
+void
+CebinaeQueueDisc::UpdateLbf (Time now, bool is_top, uint32_t size, uint64_t &past_head, uint64_t &past_tail)
+{
   // Update round time
-  if (Simulator::Now() - m_round_time >= m_vdt) {
-    m_round_time = Simulator::Now();
+  if (now - m_round_time >= m_vdt) {
+    m_round_time = now;
   }
 
   uint32_t relative_round = (m_round_time.GetNanoSeconds() - m_base_round_time.GetNanoSeconds())/m_vdt.GetNanoSeconds();
@@ -411,8 +402,8 @@ CebinaeQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   }
 
   // Now calculate the number of bytes passed
-  uint64_t past_head = 0;
-  uint64_t past_tail = 0;
+  past_head = 0;
+  past_tail = 0;
   uint64_t budget_headq = 0;
   uint64_t budget_neg_headq = 0;
   if (is_top) {
@@ -428,7 +419,7 @@ CebinaeQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
     if (m_bytes_top < aggregate_size) {
       m_bytes_top = aggregate_size;
     }    
-    m_bytes_top += item->GetSize();
+    m_bytes_top += size;
   } else {
     budget_headq = m_lbf_bps_bot[m_headq]*m_dt.GetSeconds()/8;
     budget_neg_headq = m_lbf_bps_bot[m_neg_headq]*m_dt.GetSeconds()/8;
@@ -441,9 +432,31 @@ CebinaeQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
     if (m_bytes_bot < aggregate_size) {
       m_bytes_bot = aggregate_size;
     }    
-    m_bytes_bot += item->GetSize();  
+    m_bytes_bot += size;  
+  }
+}
+
+bool
+CebinaeQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{   
+
+  // Process NORMAL packet; note that the processing of ROTATE is embedded in Reaction FSM
+  // Regardless of whether the port is saturated or not
+
+  // First check if the packet belongs to top or not
+  bool is_top = false;
+  MySourceIDTag tag;
+  bool has_tag = item->GetPacket()->FindFirstMatchingByteTag(tag);
+  if (has_tag) {
+    is_top = IsTopFlow(tag.Get());
+  } else {
+    // Non-app traffic, considered non-top for simplicity of tracing, worst case false negative which is ok
   }
 
+  uint64_t past_head = 0;
+  uint64_t past_tail = 0;
+  UpdateLbf(Simulator::Now(), is_top, item->GetSize(), past_head, past_tail);
+
   uint32_t total_qlen = GetInternalQueue (m_headq)->GetCurrentSize().GetValue() + GetInternalQueue (m_neg_headq)->GetCurrentSize().GetValue();
 
   // TODO Optional ECN bits marking
@@ -597,6 +610,45 @@ CebinaeQueueDisc::DumpDebugEvents() {
   return oss.str();
 }
 
+int32_t
+CebinaeQueueDisc::FluidEnqueue (uint32_t sourceid, uint32_t size, Time at)
+{
+  uint64_t past_head = 0;
+  uint64_t past_tail = 0;
+  UpdateLbf(at, IsTopFlow(sourceid), size, past_head, past_tail);
+
+  m_arrived_pkts += 1;
+  if (past_head == 0) {
+    m_lbf_past_head_pkts += 1;
+    return m_headq;
+  } else if (past_tail == 0) {
+    m_lbf_past_tail_pkts += 1;
+    return m_neg_headq;
+  }
+  m_lbf_drop_pkts += 1;
+  return -1;
+}
+
+void
+CebinaeQueueDisc::FluidDrop (uint32_t queue)
+{
+  m_enqueue_drop_pkts[queue] += 1;
+}
+
+void
+CebinaeQueueDisc::FluidDequeue (uint32_t sourceid, uint32_t h_5tuple, uint32_t h_5tuple2, uint32_t size)
+{
+  m_port_bytecounts += size;
+  m_fbd.UpdateCache(h_5tuple, h_5tuple2, sourceid, size);
+  m_cebinae_dequeued_succeeded += 1;
+}
+
+uint32_t
+CebinaeQueueDisc::GetHighPrioQueue (void) const
+{
+  return m_high_prio_queue;
+}
+
 Ptr<QueueDiscItem>
 CebinaeQueueDisc::DoDequeue (void)
 {
@@ -17,7 +17,7 @@ template <class K, class V>
 class FlowBottleneckDetector {
 public:
 
-  virtual void UpdateCache(Ptr<QueueDiscItem> qdi) = 0;
+  virtual void UpdateCache(const Ptr<QueueDiscItem> &qdi) = 0;
 
   virtual std::pair<std::vector<K>, V> GetTopFlows(double delta_f) = 0;
 
@@ -57,8 +57,8 @@ class MySourceIDTagFBD: public FlowBottleneckDetector<uint32_t, uint64_t>
 {
 public:
 
-  void UpdateCache(Ptr<QueueDiscItem> qdi) {
-    Ptr<Packet> p = qdi->GetPacket();
+  void UpdateCache(const Ptr<QueueDiscItem> &qdi) {
+    const Ptr<Packet> &p = qdi->GetPacket();
     MySourceIDTag tag;
     if (p->FindFirstMatchingByteTag(tag)) {
       auto got = m_mysourceid2bytecount.find(tag.Get());
@@ -131,12 +131,12 @@ public:
     m_hash2bytecount.resize(m_num_slot, 0);
   }
 
-  void UpdateCache(Ptr<QueueDiscItem> qdi) {
+  void UpdateCache(const Ptr<QueueDiscItem> &qdi) {
     // Get 5-tuple hash: an uncoorperative host my claim more BW by generating multiple flows, one could use alternative flow id (e.g., 2 tuple) to prevent this
     uint32_t h_5tuple = qdi->Hash();
     uint32_t h_slot = (h_5tuple % m_num_slot);
 
-    Ptr<Packet> p = qdi->GetPacket();
+    const Ptr<Packet> &p = qdi->GetPacket();
     MySourceIDTag tag;
     if (p->FindFirstMatchingByteTag(tag)) {
 
@@ -161,8 +161,8 @@ public:
       }
     } else {
       // Non-application traffic (ACKs), considered negligible size (i.e., non-top) for better simulation result tracing and interpretability
-      Ptr<const Ipv4QueueDiscItem> iqdi = Ptr<const Ipv4QueueDiscItem> (dynamic_cast<const Ipv4QueueDiscItem *> (PeekPointer (qdi)));
-      Ipv4Header ipv4_header = iqdi->GetHeader ();
+      const Ipv4QueueDiscItem *iqdi = dynamic_cast<const Ipv4QueueDiscItem *> (PeekPointer (qdi));
+      const Ipv4Header &ipv4_header = iqdi->GetHeader ();
       Ipv4Address ipv4_src = ipv4_header.GetSource ();
       Ipv4Address ipv4_dst = ipv4_header.GetDestination ();      
       NS_LOG_DEBUG("MySourceIDTag not found: " << ipv4_src << "->" << ipv4_dst);
@@ -244,12 +244,12 @@ public:
     m_hash2bytecount.resize(m_num_slot, 0);
   }
 
-  void UpdateCache(Ptr<QueueDiscItem> qdi) {
+  void UpdateCache(const Ptr<QueueDiscItem> &qdi) {
     // Get 5-tuple hash: an uncoorperative host my claim more BW by generating multiple flows, one could use alternative flow id (e.g., 2 tuple) to prevent this
     uint32_t h_5tuple = qdi->Hash();
     uint32_t h_slot = (h_5tuple % m_num_slot);
 
-    Ptr<Packet> p = qdi->GetPacket();
+    const Ptr<Packet> &p = qdi->GetPacket();
     MySourceIDTag tag;
     if (p->FindFirstMatchingByteTag(tag)) {
       
@@ -276,8 +276,8 @@ public:
       }
     } else {
       // Non-application traffic (ACKs), considered negligible size (i.e., non-top) for better simulation result tracing and interpretability
-      Ptr<const Ipv4QueueDiscItem> iqdi = Ptr<const Ipv4QueueDiscItem> (dynamic_cast<const Ipv4QueueDiscItem *> (PeekPointer (qdi)));
-      Ipv4Header ipv4_header = iqdi->GetHeader ();
+      const Ipv4QueueDiscItem *iqdi = dynamic_cast<const Ipv4QueueDiscItem *> (PeekPointer (qdi));
+      const Ipv4Header &ipv4_header = iqdi->GetHeader ();
       Ipv4Address ipv4_src = ipv4_header.GetSource ();
       Ipv4Address ipv4_dst = ipv4_header.GetDestination ();      
       NS_LOG_DEBUG("MySourceIDTag not found: " << ipv4_src << "->" << ipv4_dst);
@@ -366,54 +366,59 @@ public:
     m_hash2bytecount2.resize(m_num_slot, 0);
   }
 
-  void UpdateCache(Ptr<QueueDiscItem> qdi) {
+  void UpdateCache(const Ptr<QueueDiscItem> &qdi) {
     // Maybe assign independent rand stream rather than automatic assignment for the hash
     uint32_t h_5tuple = qdi->Hash();
     uint32_t h_5tuple2 = qdi->Hash(2022);
 
-    uint32_t h_slot = (h_5tuple % m_num_slot);
-    uint32_t h_slot2 = (h_5tuple2 % m_num_slot);
-
-    Ptr<Packet> p = qdi->GetPacket();
+    const Ptr<Packet> &p = qdi->GetPacket();
     MySourceIDTag tag;
     if (p->FindFirstMatchingByteTag(tag)) {
-      // Check slots in stage 1
-      if (m_hash2mysourceid[h_slot] == c_unclaimed) {
-        m_hash2mysourceid[h_slot] = tag.Get();
-        m_hash2bytecount[h_slot] = p->GetSize();
-      } else if (m_hash2mysourceid[h_slot] == tag.Get()) {
-        m_hash2bytecount[h_slot] += p->GetSize();
-      } else {
-        // Already occupied, check stage 2
-        if (m_hash2mysourceid2[h_slot2] == c_unclaimed) {
-          m_hash2mysourceid2[h_slot2] = tag.Get();
-          m_hash2bytecount2[h_slot2] = p->GetSize();
-        } else if (m_hash2mysourceid2[h_slot2] == tag.Get()) {
-          m_hash2bytecount2[h_slot2] += p->GetSize();
-        } else {
-          sourceids_wo_slots.insert(tag.Get());
-        }
-      }
-      // Keep a ground truth map for debugging
-      auto got = m_mysourceid2bytecount.find(tag.Get());
-      if (got != m_mysourceid2bytecount.end()) {
-        m_mysourceid2bytecount[tag.Get()] += p->GetSize();
-      } else {
-        m_mysourceid2bytecount[tag.Get()] = p->GetSize();
-      }
-      if (m_mysourceid2bytecount[tag.Get()] > m_max_bytes) {
-        m_max_bytes = m_mysourceid2bytecount[tag.Get()];
-      }
+      UpdateCache(h_5tuple, h_5tuple2, tag.Get(), p->GetSize());
     } else {
       // Non-application traffic (ACKs), considered negligible size (i.e., non-top) for better simulation result tracing and interpretability
-      Ptr<const Ipv4QueueDiscItem> iqdi = Ptr<const Ipv4QueueDiscItem> (dynamic_cast<const Ipv4QueueDiscItem *> (PeekPointer (qdi)));
-      Ipv4Header ipv4_header = iqdi->GetHeader ();
+      const Ipv4QueueDiscItem *iqdi = dynamic_cast<const Ipv4QueueDiscItem *> (PeekPointer (qdi));
+      const Ipv4Header &ipv4_header = iqdi->GetHeader ();
       Ipv4Address ipv4_src = ipv4_header.GetSource ();
       Ipv4Address ipv4_dst = ipv4_header.GetDestination ();      
       NS_LOG_DEBUG("MySourceIDTag not found: " << ipv4_src << "->" << ipv4_dst);
     }
   }
 
+  // Same as above for size bytes of sourceid whose 5-tuple hashes (perturbation 0 and 2022) are already known
+  void UpdateCache(uint32_t h_5tuple, uint32_t h_5tuple2, uint32_t sourceid, uint32_t size) {
+    uint32_t h_slot = (h_5tuple % m_num_slot);
+    uint32_t h_slot2 = (h_5tuple2 % m_num_slot);
+
+    // Check slots in stage 1
+    if (m_hash2mysourceid[h_slot] == c_unclaimed) {
+      m_hash2mysourceid[h_slot] = sourceid;
+      m_hash2bytecount[h_slot] = size;
+    } else if (m_hash2mysourceid[h_slot] == sourceid) {
+      m_hash2bytecount[h_slot] += size;
+    } else {
+      // Already occupied, check stage 2
+      if (m_hash2mysourceid2[h_slot2] == c_unclaimed) {
+        m_hash2mysourceid2[h_slot2] = sourceid;
+        m_hash2bytecount2[h_slot2] = size;
+      } else if (m_hash2mysourceid2[h_slot2] == sourceid) {
+        m_hash2bytecount2[h_slot2] += size;
+      } else {
+        sourceids_wo_slots.insert(sourceid);
+      }
+    }
+    // Keep a ground truth map for debugging
+    auto got = m_mysourceid2bytecount.find(sourceid);
+    if (got != m_mysourceid2bytecount.end()) {
+      m_mysourceid2bytecount[sourceid] += size;
+    } else {
+      m_mysourceid2bytecount[sourceid] = size;
+    }
+    if (m_mysourceid2bytecount[sourceid] > m_max_bytes) {
+      m_max_bytes = m_mysourceid2bytecount[sourceid];
+    }
+  }
+
   void FlushCache() {
     m_mysourceid2bytecount.clear();
     m_hash2mysourceid.resize(0);
@@ -627,6 +632,20 @@ public:
 
   std::string DumpDebugEvents();
 
+  // --- Flow-level model interface (cebinae/dumbbell_long/sim-fluid.h) ---
+  // The model holds the queued packets itself, while the LBFs, the flow bottleneck detector and the digest
+  // counters are driven exactly as DoEnqueue and DoDequeue do for real packets.
+
+  // Returns the internal queue a packet of size bytes from sourceid arriving at 'at' (within the current step of
+  // the model, not before Now) goes to, or -1 if the LBF drops it
+  int32_t FluidEnqueue (uint32_t sourceid, uint32_t size, Time at);
+  // The packet FluidEnqueue assigned to internal queue 'queue' didn't fit in the buffer
+  void FluidDrop (uint32_t queue);
+  // A packet of size bytes from sourceid leaves the port; h_5tuple and h_5tuple2 are its Hash() and Hash(2022)
+  void FluidDequeue (uint32_t sourceid, uint32_t h_5tuple, uint32_t h_5tuple2, uint32_t size);
+  // Internal queue served first
+  uint32_t GetHighPrioQueue (void) const;
+
 private:
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
   virtual Ptr<QueueDiscItem> DoDequeue (void);
@@ -637,6 +656,12 @@ private:
   // State machine loops that locally verifies max-min fairness and push towards the 'fair' direction
   void ReactionFSM();
 
+  // Whether sourceid is in the bottlenecked (top) set of the current round
+  bool IsTopFlow (uint32_t sourceid) const;
+  // Accounts size bytes of the top or bot aggregate arriving at 'now' in the LBF registers and returns
+  // how far the aggregate is past the headq budget and past the neg_headq budget
+  void UpdateLbf (Time now, bool is_top, uint32_t size, uint64_t &past_head, uint64_t &past_tail);
+
   // --- Cabinae params ---
   // Port saturation/bottleneck threshold
   double m_delta_p {0.05};
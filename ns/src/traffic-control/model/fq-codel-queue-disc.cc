@@ -45,7 +45,8 @@ TypeId FqCoDelFlow::GetTypeId (void)
 FqCoDelFlow::FqCoDelFlow ()
   : m_deficit (0),
     m_status (INACTIVE),
-    m_index (0)
+    m_index (0),
+    m_next (nullptr)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -174,7 +175,11 @@ TypeId FqCoDelQueueDisc::GetTypeId (void)
 
 FqCoDelQueueDisc::FqCoDelQueueDisc ()
   : QueueDisc (QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
-    m_quantum (0)
+    m_quantum (0),
+    m_newFlows {nullptr, nullptr},
+    m_oldFlows {nullptr, nullptr},
+    m_flowTableShift (32),
+    m_nFlowEntries (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -184,6 +189,17 @@ FqCoDelQueueDisc::~FqCoDelQueueDisc ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+FqCoDelQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_newFlows = {nullptr, nullptr};
+  m_oldFlows = {nullptr, nullptr};
+  m_flowTable.clear ();
+  m_nFlowEntries = 0;
+  QueueDisc::DoDispose ();
+}
+
 void
 FqCoDelQueueDisc::SetQuantum (uint32_t quantum)
 {
@@ -197,6 +213,89 @@ FqCoDelQueueDisc::GetQuantum (void) const
   return m_quantum;
 }
 
+FqCoDelQueueDisc::FlowEntry *
+FqCoDelQueueDisc::FindFlow (uint32_t h)
+{
+  if (m_flowTable.empty ())
+    {
+      return nullptr;
+    }
+
+  uint32_t mask = m_flowTable.size () - 1;
+  for (uint32_t i = (h * UINT32_C (0x9e3779b1)) >> m_flowTableShift; ; i = (i + 1) & mask)
+    {
+      FlowEntry &entry = m_flowTable[i];
+      if (entry.flow == nullptr)
+        {
+          return nullptr;
+        }
+      if (entry.h == h)
+        {
+          return &entry;
+        }
+    }
+}
+
+FqCoDelQueueDisc::FlowEntry *
+FqCoDelQueueDisc::AddFlow (uint32_t h, FqCoDelFlow *flow)
+{
+  NS_LOG_FUNCTION (this << h << flow);
+
+  // keep the table at most half full
+  if (2 * (m_nFlowEntries + 1) > m_flowTable.size ())
+    {
+      std::vector<FlowEntry> old;
+      old.swap (m_flowTable);
+      m_flowTableShift = old.empty () ? 28 : m_flowTableShift - 1;
+      m_flowTable.assign (std::size_t (1) << (32 - m_flowTableShift), FlowEntry {0, 0, nullptr});
+      m_nFlowEntries = 0;
+      for (const FlowEntry &entry : old)
+        {
+          if (entry.flow != nullptr)
+            {
+              AddFlow (entry.h, entry.flow)->tag = entry.tag;
+            }
+        }
+    }
+
+  uint32_t mask = m_flowTable.size () - 1;
+  uint32_t i = (h * UINT32_C (0x9e3779b1)) >> m_flowTableShift;
+  while (m_flowTable[i].flow != nullptr)
+    {
+      NS_ASSERT_MSG (m_flowTable[i].h != h, "Flow queue " << h << " already exists");
+      i = (i + 1) & mask;
+    }
+  m_flowTable[i] = FlowEntry {h, 0, flow};
+  m_nFlowEntries++;
+  return &m_flowTable[i];
+}
+
+void
+FqCoDelQueueDisc::PushFlow (FlowList &list, FqCoDelFlow *flow)
+{
+  flow->m_next = nullptr;
+  if (list.head == nullptr)
+    {
+      list.head = flow;
+    }
+  else
+    {
+      list.tail->m_next = flow;
+    }
+  list.tail = flow;
+}
+
+void
+FqCoDelQueueDisc::PopFlow (FlowList &list)
+{
+  NS_ASSERT (list.head != nullptr);
+  list.head = list.head->m_next;
+  if (list.head == nullptr)
+    {
+      list.tail = nullptr;
+    }
+}
+
 uint32_t
 FqCoDelQueueDisc::SetAssociativeHash (uint32_t flowHash)
 {
@@ -208,21 +307,19 @@ FqCoDelQueueDisc::SetAssociativeHash (uint32_t flowHash)
 
   for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-      auto it = m_flowsIndices.find (i);
+      FlowEntry *entry = FindFlow (i);
 
-      if (it == m_flowsIndices.end ()
-          || (m_tags.find (i) != m_tags.end () && m_tags[i] == flowHash)
-          || StaticCast<FqCoDelFlow> (GetQueueDiscClass (it->second))->GetStatus () == FqCoDelFlow::INACTIVE)
+      if (entry == nullptr
+          || entry->tag == flowHash
+          || entry->flow->GetStatus () == FqCoDelFlow::INACTIVE)
         {
           // this queue has not been created yet or is associated with this flow
-          // or is inactive, hence we can use it
-          m_tags[i] = flowHash;
+          // or is inactive, hence we can use it (DoEnqueue updates the tag)
           return i;
         }
     }
 
   // all the queues of the set are used. Use the first queue of the set
-  m_tags[outerHash] = flowHash;
   return outerHash;
 }
 
@@ -262,11 +359,11 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       h = flowHash % m_flows;
     }
 
-  Ptr<FqCoDelFlow> flow;
-  if (m_flowsIndices.find (h) == m_flowsIndices.end ())
+  FlowEntry *entry = FindFlow (h);
+  if (entry == nullptr)
     {
       NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
-      flow = m_flowFactory.Create<FqCoDelFlow> ();
+      Ptr<FqCoDelFlow> flow = m_flowFactory.Create<FqCoDelFlow> ();
       Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc> ();
       // If CoDel, Set values of CoDelQueueDisc to match this QueueDisc
       Ptr<CoDelQueueDisc> codel = qd->GetObject<CoDelQueueDisc> ();
@@ -281,23 +378,21 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       flow->SetIndex (h);
       AddQueueDiscClass (flow);
 
-      m_flowsIndices[h] = GetNQueueDiscClasses () - 1;
-    }
-  else
-    {
-      flow = StaticCast<FqCoDelFlow> (GetQueueDiscClass (m_flowsIndices[h]));
+      entry = AddFlow (h, PeekPointer (flow));
     }
+  entry->tag = flowHash;
+  FqCoDelFlow *flow = entry->flow;
 
   if (flow->GetStatus () == FqCoDelFlow::INACTIVE)
     {
       flow->SetStatus (FqCoDelFlow::NEW_FLOW);
       flow->SetDeficit (m_quantum);
-      m_newFlows.push_back (flow);
+      PushFlow (m_newFlows, flow);
     }
 
-  flow->GetQueueDisc ()->Enqueue (item);
+  flow->GetQueueDisc ()->Enqueue (std::move (item));
 
-  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
 
   if (GetCurrentSize () > GetMaxSize ())
     {
@@ -313,24 +408,24 @@ FqCoDelQueueDisc::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<FqCoDelFlow> flow;
+  FqCoDelFlow *flow = nullptr;
   Ptr<QueueDiscItem> item;
 
   do
     {
       bool found = false;
 
-      while (!found && !m_newFlows.empty ())
+      while (!found && m_newFlows.head != nullptr)
         {
-          flow = m_newFlows.front ();
+          flow = m_newFlows.head;
 
           if (flow->GetDeficit () <= 0)
             {
               NS_LOG_DEBUG ("Increase deficit for new flow index " << flow->GetIndex ());
               flow->IncreaseDeficit (m_quantum);
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              PopFlow (m_newFlows);
+              PushFlow (m_oldFlows, flow);
             }
           else
             {
@@ -339,16 +434,16 @@ FqCoDelQueueDisc::DoDequeue (void)
             }
         }
 
-      while (!found && !m_oldFlows.empty ())
+      while (!found && m_oldFlows.head != nullptr)
         {
-          flow = m_oldFlows.front ();
+          flow = m_oldFlows.head;
 
           if (flow->GetDeficit () <= 0)
             {
               NS_LOG_DEBUG ("Increase deficit for old flow index " << flow->GetIndex ());
               flow->IncreaseDeficit (m_quantum);
-              m_oldFlows.push_back (flow);
-              m_oldFlows.pop_front ();
+              PopFlow (m_oldFlows);
+              PushFlow (m_oldFlows, flow);
             }
           else
             {
@@ -368,16 +463,16 @@ FqCoDelQueueDisc::DoDequeue (void)
       if (!item)
         {
           NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
-          if (!m_newFlows.empty ())
+          if (m_newFlows.head != nullptr)
             {
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              PopFlow (m_newFlows);
+              PushFlow (m_oldFlows, flow);
             }
           else
             {
               flow->SetStatus (FqCoDelFlow::INACTIVE);
-              m_oldFlows.pop_front ();
+              PopFlow (m_oldFlows);
             }
         }
       else
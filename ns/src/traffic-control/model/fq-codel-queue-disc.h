@@ -24,8 +24,7 @@
 
 #include "ns3/queue-disc.h"
 #include "ns3/object-factory.h"
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -97,9 +96,12 @@ public:
   uint32_t GetIndex (void) const;
 
 private:
+  friend class FqCoDelQueueDisc;
+
   int32_t m_deficit;    //!< the deficit for this flow
   FlowStatus m_status;  //!< the status of this flow
   uint32_t m_index;     //!< the index for this flow
+  FqCoDelFlow *m_next;  //!< the next flow in the list of new or old flows
 };
 
 
@@ -142,11 +144,59 @@ public:
   static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";        //!< Overlimit dropped packets
 
 private:
+  virtual void DoDispose (void);
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
   virtual Ptr<QueueDiscItem> DoDequeue (void);
   virtual bool CheckConfig (void);
   virtual void InitializeParams (void);
 
+  /**
+   * \brief An entry of the table of flow queues
+   */
+  struct FlowEntry
+  {
+    uint32_t h;          //!< the index of the queue for the flow
+    uint32_t tag;        //!< the hash of the last flow using the queue (used by set associative hash)
+    FqCoDelFlow *flow;   //!< the flow queue, or null if the entry is free
+  };
+
+  /**
+   * \brief A list of flow queues, linked through FqCoDelFlow::m_next
+   */
+  struct FlowList
+  {
+    FqCoDelFlow *head;   //!< the first flow of the list, or null if the list is empty
+    FqCoDelFlow *tail;   //!< the last flow of the list
+  };
+
+  /**
+   * \brief Look up the flow queue with the given index
+   * \param h the index of the queue for the flow
+   * \return the entry of the flow queue, or null if it has not been created yet
+   */
+  FlowEntry *FindFlow (uint32_t h);
+  /**
+   * \brief Add a flow queue to the table of flow queues
+   *
+   * The entries returned by FindFlow before the call may be moved.
+   *
+   * \param h the index of the queue for the flow
+   * \param flow the flow queue
+   * \return the entry of the flow queue
+   */
+  FlowEntry *AddFlow (uint32_t h, FqCoDelFlow *flow);
+  /**
+   * \brief Append a flow queue to a list of flows
+   * \param list the list of flows
+   * \param flow the flow queue, which must not be in a list
+   */
+  static void PushFlow (FlowList &list, FqCoDelFlow *flow);
+  /**
+   * \brief Remove the first flow queue of a non-empty list of flows
+   * \param list the list of flows
+   */
+  static void PopFlow (FlowList &list);
+
   /**
    * \brief Drop a packet from the head of the queue with the largest current byte count
    * \return the index of the queue with the largest current byte count
@@ -174,11 +224,17 @@ private:
   bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
   bool m_useL4s;             //!< True if L4S is used (ECT1 packets are marked at CE threshold)
 
-  std::list<Ptr<FqCoDelFlow> > m_newFlows;    //!< The list of new flows
-  std::list<Ptr<FqCoDelFlow> > m_oldFlows;    //!< The list of old flows
+  FlowList m_newFlows;    //!< The list of new flows
+  FlowList m_oldFlows;    //!< The list of old flows
 
-  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
-  std::map<uint32_t, uint32_t> m_tags;            //!< Tags used by set associative hash
+  /**
+   * Open-addressed table of the flow queues, indexed by a multiplicative
+   * hash of the queue index and probed linearly. The flow queues are owned
+   * by the queue disc classes; the table and the lists only point to them.
+   */
+  std::vector<FlowEntry> m_flowTable;
+  uint32_t m_flowTableShift;  //!< 32 minus the log2 of the size of the table of flow queues
+  uint32_t m_nFlowEntries;    //!< Number of entries in use in the table of flow queues
 
   ObjectFactory m_flowFactory;         //!< Factory to create a new flow
   ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
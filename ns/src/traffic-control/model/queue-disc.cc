@@ -597,7 +597,7 @@ QueueDisc::AddInternalQueue (Ptr<InternalQueue> queue)
   m_queues.push_back (queue);
 }
 
-Ptr<QueueDisc::InternalQueue>
+const Ptr<QueueDisc::InternalQueue> &
 QueueDisc::GetInternalQueue (std::size_t i) const
 {
   NS_ASSERT (i < m_queues.size ());
@@ -900,11 +900,10 @@ QueueDisc::Dequeue (void)
   // The QueueDisc::DoPeek method dequeues a packet and keeps it as a requeued
   // packet. Thus, first check whether a peeked packet exists. Otherwise, call
   // the private DoDequeue method.
-  Ptr<QueueDiscItem> item = m_requeued;
+  Ptr<QueueDiscItem> item = std::move (m_requeued);
 
   if (item)
     {
-      m_requeued = 0;
       if (m_peeked)
         {
           // If the packet was requeued because a peek operation was requested
@@ -1003,7 +1002,7 @@ QueueDisc::Restart (void)
       return false;
     }
 
-  return Transmit (item);
+  return Transmit (std::move (item));
 }
 
 Ptr<QueueDiscItem>
@@ -1021,8 +1020,7 @@ QueueDisc::DequeuePacket ()
         // If the device does not support flow control, the device queue is never stopped
         if (!m_devQueueIface || !m_devQueueIface->GetTxQueue (m_requeued->GetTxQueueIndex ())->IsStopped ())
           {
-            item = m_requeued;
-            m_requeued = 0;
+            item = std::move (m_requeued);
             if (m_peeked)
               {
                 // If the packet was requeued because a peek operation was requested
@@ -1091,7 +1089,8 @@ QueueDisc::Transmit (Ptr<QueueDiscItem> item)
       item->GetPacket ()->RemovePacketTag (priorityTag);
     }
   NS_ASSERT_MSG (m_send, "Send callback not set");
-  m_send (item);
+  uint8_t txq = item->GetTxQueueIndex ();
+  m_send (std::move (item));
 
   // the behavior here slightly diverges from Linux. In Linux, it is advised that
   // the function called when a packet needs to be transmitted (ndo_start_xmit)
@@ -1110,7 +1109,7 @@ QueueDisc::Transmit (Ptr<QueueDiscItem> item)
   // if the queue disc is empty or the device queue is now stopped, return false so
   // that the Run method does not attempt to dequeue other packets and exits
   if (GetNPackets () == 0 ||
-      (m_devQueueIface && m_devQueueIface->GetTxQueue (item->GetTxQueueIndex ())->IsStopped ()))
+      (m_devQueueIface && m_devQueueIface->GetTxQueue (txq)->IsStopped ()))
     {
       return false;
     }
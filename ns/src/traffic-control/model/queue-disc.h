@@ -430,9 +430,9 @@ public:
   /**
    * \brief Get the i-th internal queue
    * \param i the index of the queue
-   * \return the i-th internal queue.
+   * \return the i-th internal queue, valid until the queues change.
    */
-  Ptr<InternalQueue> GetInternalQueue (std::size_t i) const;
+  const Ptr<InternalQueue> &GetInternalQueue (std::size_t i) const;
 
   /**
    * \brief Get the number of internal queues
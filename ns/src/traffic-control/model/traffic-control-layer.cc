@@ -391,9 +391,9 @@ TrafficControlLayer::Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
       // selected for the packet and try to dequeue packets from such queue disc
       item->SetTxQueueIndex (txq);
 
-      Ptr<QueueDisc> qDisc = ndi->second.m_queueDiscsToWake[txq];
+      const Ptr<QueueDisc> &qDisc = ndi->second.m_queueDiscsToWake[txq];
       NS_ASSERT (qDisc);
-      qDisc->Enqueue (item);
+      qDisc->Enqueue (std::move (item));
       qDisc->Run ();
     }
 }
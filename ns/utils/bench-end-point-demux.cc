@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+
+using namespace ns3;
+
+// Measure the Ipv4EndPointDemux on a sink node: one listener and n
+// connections, all on the same local port, as with many PacketSinks or
+// an incast.  Sample usage:
+//   ./waf --run 'bench-end-point-demux --n=10,1000,50000'
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/**
+ * Peer address of a connection.
+ * \param [in] i The connection index.
+ * \returns The address.
+ */
+static Ipv4Address
+GetPeer (uint32_t i)
+{
+  return Ipv4Address (Ipv4Address ("10.1.0.0").Get () + i / 100);
+}
+
+/**
+ * Peer port of a connection.
+ * \param [in] i The connection index.
+ * \returns The port.
+ */
+static uint16_t
+GetPeerPort (uint32_t i)
+{
+  return 49152 + i % 100;
+}
+
+/**
+ * Run the benchmark for one number of connections.
+ * \param [in] n The number of connections.
+ * \param [in] lookups The number of lookups.
+ */
+static void
+Bench (uint32_t n, uint32_t lookups)
+{
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  Ipv4Address local ("10.0.0.1");
+  uint16_t port = 8080;
+  Ipv4EndPointDemux *demux = new Ipv4EndPointDemux ();
+  demux->Allocate (0, port);
+
+  auto start = std::chrono::steady_clock::now ();
+  std::vector<Ipv4EndPoint *> endPoints;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      endPoints.push_back (demux->Allocate (0, local, port, GetPeer (i), GetPeerPort (i)));
+    }
+  std::chrono::duration<double> allocate = std::chrono::steady_clock::now () - start;
+
+  // Mostly packets of open connections, and one SYN in 16 to the listener
+  start = std::chrono::steady_clock::now ();
+  uint32_t found = 0;
+  uint32_t i = 0;
+  for (uint32_t l = 0; l < lookups; ++l)
+    {
+      i = (i + 7919) % n;
+      Ipv4Address peer = l % 16 ? GetPeer (i) : Ipv4Address ("10.2.0.1");
+      found += demux->Lookup (local, port, peer, GetPeerPort (i), interface).size ();
+    }
+  std::chrono::duration<double> lookup = std::chrono::steady_clock::now () - start;
+  if (found != lookups)
+    {
+      LOGME ("lookups found " << found << " endpoints instead of " << lookups);
+    }
+
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      demux->DeAllocate (endPoints[i]);
+    }
+  std::chrono::duration<double> deallocate = std::chrono::steady_clock::now () - start;
+  delete demux;
+
+  LOG (std::left << std::setw (g_fwidth) << n <<
+       std::left << std::setw (g_fwidth) << 1e9 * allocate.count () / n <<
+       std::left << std::setw (g_fwidth) << 1e9 * lookup.count () / lookups <<
+       std::left << std::setw (g_fwidth) << 1e9 * deallocate.count () / n);
+}
+
+int main (int argc, char *argv[])
+{
+  std::string sizes = "10,1000,50000";
+  uint32_t lookups = 1000000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the Ipv4EndPointDemux with many connections on one port.");
+  cmd.AddValue ("n",       "comma-separated list of numbers of connections", sizes);
+  cmd.AddValue ("lookups", "number of lookups per size",                     lookups);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  LOG (std::left << std::setw (g_fwidth) << "Connections" <<
+       std::left << std::setw (g_fwidth) << "Alloc (ns)" <<
+       std::left << std::setw (g_fwidth) << "Lookup (ns)" <<
+       std::left << std::setw (g_fwidth) << "Dealloc (ns)");
+
+  std::istringstream iss (sizes);
+  std::string size;
+  while (std::getline (iss, size, ','))
+    {
+      Bench (std::stoul (size), lookups);
+    }
+  return 0;
+}
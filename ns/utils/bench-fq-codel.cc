@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ns3/core-module.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/tcp-header.h"
+
+using namespace ns3;
+
+// Measure the FqCoDelQueueDisc with n backlogged TCP flows, configured as
+// in the dumbbell programs (one flow queue per distinct hash).  Each
+// dequeued packet is enqueued again as a new item, so the number of flows
+// and the backlog stay constant.  With many flows, a few of them may share
+// a flow queue because of hash collisions.  Sample usage:
+//   ./waf --run 'bench-fq-codel --n=10,1000,100000'
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/**
+ * Create an item of a flow.
+ * \param [in] i The flow index.
+ * \returns The item.
+ */
+static Ptr<Ipv4QueueDiscItem>
+CreateItem (uint32_t i)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  TcpHeader tcpHdr;
+  tcpHdr.SetSourcePort (49152 + i % 1000);
+  tcpHdr.SetDestinationPort (5000);
+  p->AddHeader (tcpHdr);
+
+  Ipv4Header ipHdr;
+  ipHdr.SetSource (Ipv4Address (Ipv4Address ("10.1.0.0").Get () + i / 1000));
+  ipHdr.SetDestination (Ipv4Address ("10.2.0.1"));
+  ipHdr.SetProtocol (6);
+  ipHdr.SetPayloadSize (p->GetSize ());
+  return Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipHdr);
+}
+
+/**
+ * Run the benchmark for one number of flows.
+ * \param [in] n The number of flows.
+ * \param [in] packets The number of packets dequeued and enqueued again.
+ */
+static void
+Bench (uint32_t n, uint32_t packets)
+{
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc>
+    ("Flows", UintegerValue (4294967295),
+     "MaxSize", QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, 4 * n)));
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  // Two packets per flow
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < 2 * n; ++i)
+    {
+      queueDisc->Enqueue (CreateItem (i % n));
+    }
+  std::chrono::duration<double> fill = std::chrono::steady_clock::now () - start;
+
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t k = 0; k < packets; ++k)
+    {
+      Ptr<Ipv4QueueDiscItem> item = StaticCast<Ipv4QueueDiscItem> (queueDisc->Dequeue ());
+      queueDisc->Enqueue (Create<Ipv4QueueDiscItem> (item->GetPacket (), item->GetAddress (),
+                                                     item->GetProtocol (), item->GetHeader ()));
+    }
+  std::chrono::duration<double> cycle = std::chrono::steady_clock::now () - start;
+
+  if (queueDisc->GetNPackets () != 2 * n)
+    {
+      LOGME ("queue disc holds " << queueDisc->GetNPackets () << " packets instead of " << 2 * n);
+    }
+  queueDisc->Dispose ();
+
+  LOG (std::left << std::setw (g_fwidth) << n <<
+       std::left << std::setw (g_fwidth) << 1e9 * fill.count () / (2 * n) <<
+       std::left << std::setw (g_fwidth) << 1e9 * cycle.count () / packets);
+}
+
+int main (int argc, char *argv[])
+{
+  std::string sizes = "10,100,1000,10000,100000";
+  uint32_t packets = 1000000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the FqCoDelQueueDisc with many backlogged flows.");
+  cmd.AddValue ("n",       "comma-separated list of numbers of flows",   sizes);
+  cmd.AddValue ("packets", "number of packets cycled per size",          packets);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  LOG (std::left << std::setw (g_fwidth) << "Flows" <<
+       std::left << std::setw (g_fwidth) << "Fill (ns)" <<
+       std::left << std::setw (g_fwidth) << "Cycle (ns)");
+
+  // Run from events: before Simulator::Run, every Time created is recorded
+  // in case the resolution changes, which would dominate the measurements
+  std::istringstream iss (sizes);
+  std::string size;
+  while (std::getline (iss, size, ','))
+    {
+      Simulator::ScheduleNow (&Bench, std::stoul (size), packets);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -328,6 +328,47 @@ benchByteTags (uint32_t n)
     }
 }
 
+static void
+benchTcpSegments (uint32_t n)
+{
+  BenchHeader<20> tcp;
+  BenchHeader<20> ipv4;
+  BenchHeader<2> ppp;
+  BenchTag<4> sourceId;
+
+  // The application writes tagged payloads which do not line up with the
+  // segments: each segment joins the end of a write to the start of the
+  // next one, like TcpTxBuffer::CopyFromSequence
+  Ptr<Packet> previous = Create<Packet> (1440);
+  previous->AddByteTag (sourceId);
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> write = Create<Packet> (1440);
+      write->AddByteTag (sourceId);
+      Ptr<Packet> segment = previous->CreateFragment (offset, 1440 - offset);
+      uint32_t rest = 1448 - (1440 - offset);
+      segment->AddAtEnd (write->CreateFragment (0, rest));
+      previous = write;
+      offset = rest % 1440;
+
+      // Sent: the sender keeps the segment for retransmission
+      Ptr<Packet> sent = segment->Copy ();
+      sent->AddHeader (tcp);
+      sent->AddHeader (ipv4);
+      sent->AddHeader (ppp);
+
+      // Received: the queue disc and the sink look for the tag, and
+      // TcpRxBuffer::Extract merges the segment into the delivered data
+      sent->RemoveHeader (ppp);
+      sent->FindFirstMatchingByteTag (sourceId);
+      sent->RemoveHeader (ipv4);
+      sent->RemoveHeader (tcp);
+      Ptr<Packet> delivered = Create<Packet> ();
+      delivered->AddAtEnd (sent);
+    }
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -376,6 +417,10 @@ int main (int argc, char *argv[])
         "by command-line argument --n=(number of packets)" << std::endl;
       exit (1);
     }
+  if (enablePrinting)
+    {
+      Packet::EnablePrinting ();
+    }
   std::cout << "Running bench-packets with n=" << n << std::endl;
   std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
 
@@ -385,6 +430,7 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+  runBench (&benchTcpSegments, n, minIterations, "TCP segments of tagged writes");
 
   return 0;
 }
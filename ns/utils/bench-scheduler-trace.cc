@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ns3/core-module.h"
+#include "ns3/event-trace.h"
+
+using namespace ns3;
+
+// Replay an event list trace recorded by DefaultSimulatorImpl (see EventTrace)
+// against one or more Scheduler implementations.
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/// Hardware cache miss counter of this thread, if the kernel lets us have one
+class CacheMissCounter
+{
+public:
+  CacheMissCounter ()
+    : m_fd (-1)
+  {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset (&attr, 0, sizeof (attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof (attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = static_cast<int> (syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+  ~CacheMissCounter ()
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        close (m_fd);
+      }
+#endif
+  }
+  /** \returns true if cache misses can be counted */
+  bool IsAvailable (void) const
+  {
+    return m_fd >= 0;
+  }
+  /** Reset and start counting */
+  void Start (void)
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl (m_fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+  /** \returns the cache misses since Start() */
+  uint64_t Stop (void)
+  {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read (m_fd, &count, sizeof (count)) != sizeof (count))
+          {
+            count = 0;
+          }
+      }
+#endif
+    return count;
+  }
+
+private:
+  int m_fd;  //!< perf event file descriptor
+};
+
+/**
+ * Apply the trace to a scheduler.
+ *
+ * \param scheduler the scheduler
+ * \param records the trace
+ * \param [out] ops number of scheduler calls
+ * \returns the number of RemoveNext results which differ from the trace
+ */
+uint64_t
+Replay (Ptr<Scheduler> scheduler, const std::vector<EventTrace::Record> &records, uint64_t &ops)
+{
+  uint64_t mismatches = 0;
+  ops = 0;
+  Scheduler::Event ev;
+  ev.impl = 0;
+  for (std::vector<EventTrace::Record>::const_iterator i = records.begin (); i != records.end (); ++i)
+    {
+      switch (i->GetOp ())
+        {
+        case EventTrace::INSERT:
+          ev.key = i->GetKey ();
+          scheduler->Insert (ev);
+          ops++;
+          break;
+        case EventTrace::REMOVE_NEXT:
+          if (scheduler->IsEmpty () || scheduler->RemoveNext ().key.m_uid != i->uid)
+            {
+              mismatches++;
+            }
+          ops++;
+          break;
+        case EventTrace::REMOVE:
+          ev.key = i->GetKey ();
+          scheduler->Remove (ev);
+          ops++;
+          break;
+        case EventTrace::CANCEL:
+          break;
+        }
+    }
+  return mismatches;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string filename = "";
+  std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,ns3::CalendarScheduler,"
+    "ns3::PriorityQueueScheduler,ns3::LadderScheduler";
+  uint32_t runs = 3;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Replay a recorded event list trace against Scheduler implementations.\n"
+             "\n"
+             "Record a trace by running any program with\n"
+             "  NS_ATTRIBUTE_DEFAULT='ns3::DefaultSimulatorImpl::EventTraceFile=<filename>'\n"
+             "then replay it with --file=<filename>.  The ListScheduler is left out\n"
+             "of the default list since it is quadratic on realistic traces.");
+  cmd.AddValue ("file",  "event trace file",                           filename);
+  cmd.AddValue ("sched", "comma-separated list of Scheduler TypeIds",  schedulers);
+  cmd.AddValue ("runs",  "number of runs per scheduler (default 3)",   runs);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  std::vector<EventTrace::Record> records;
+  if (filename.empty () || !EventTrace::Load (filename, records))
+    {
+      LOGME ("cannot read event trace \"" << filename << "\"");
+      return 1;
+    }
+  uint64_t counts[4] = { 0, 0, 0, 0 };
+  for (std::vector<EventTrace::Record>::const_iterator i = records.begin (); i != records.end (); ++i)
+    {
+      counts[i->GetOp ()]++;
+    }
+  LOGME ("trace: " << filename);
+  LOGME ("records: " << records.size ()
+         << " (insert " << counts[EventTrace::INSERT]
+         << ", remove next " << counts[EventTrace::REMOVE_NEXT]
+         << ", remove " << counts[EventTrace::REMOVE]
+         << ", cancel " << counts[EventTrace::CANCEL] << ")");
+
+  CacheMissCounter misses;
+  if (!misses.IsAvailable ())
+    {
+      LOGME ("cache misses: not available (perf_event_open failed)");
+    }
+
+  LOG ("");
+  LOG (std::left << std::setw (3 * g_fwidth) << "Scheduler" <<
+       std::left << std::setw (g_fwidth / 2) << "Run" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Per (ns/op)" <<
+       std::left << std::setw (g_fwidth) << "Misses" <<
+       std::left << std::setw (g_fwidth) << "Misses/op");
+
+  std::istringstream iss (schedulers);
+  std::string name;
+  bool ok = true;
+  while (std::getline (iss, name, ','))
+    {
+      TypeId tid;
+      if (!TypeId::LookupByNameFailSafe (name, &tid))
+        {
+          LOGME ("unknown scheduler " << name);
+          ok = false;
+          continue;
+        }
+      ObjectFactory factory;
+      factory.SetTypeId (tid);
+      for (uint32_t run = 0; run < runs; run++)
+        {
+          Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+          uint64_t ops = 0;
+          misses.Start ();
+          auto start = std::chrono::steady_clock::now ();
+          uint64_t mismatches = Replay (scheduler, records, ops);
+          std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+          uint64_t missCount = misses.Stop ();
+
+          std::ostringstream missStr, perOpStr;
+          if (misses.IsAvailable ())
+            {
+              missStr << missCount;
+              perOpStr << std::setprecision (3) << (ops ? double (missCount) / ops : 0.0);
+            }
+          else
+            {
+              missStr << "-";
+              perOpStr << "-";
+            }
+          LOG (std::left << std::setw (3 * g_fwidth) << name <<
+               std::left << std::setw (g_fwidth / 2) << run <<
+               std::left << std::setw (g_fwidth) << elapsed.count () <<
+               std::left << std::setw (g_fwidth) << (ops ? elapsed.count () * 1e9 / ops : 0.0) <<
+               std::left << std::setw (g_fwidth) << missStr.str () <<
+               std::left << std::setw (g_fwidth) << perOpStr.str ());
+          if (mismatches)
+            {
+              LOGME (name << ": " << mismatches << " events removed out of trace order");
+              ok = false;
+            }
+        }
+    }
+  return ok ? 0 : 1;
+}